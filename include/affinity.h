@@ -1,12 +1,23 @@
 #pragma once
 
 #include <cstdint>
+#include <thread>
+#include <vector>
 
 namespace celerity {
 namespace detail {
 
 	uint32_t affinity_cores_available();
 
+	/// Returns the ids of all logical cores this process may run on, in ascending order.
+	std::vector<uint32_t> affinity_core_ids();
+
+	/// Restricts a thread to run on a single logical core. Returns false if the operating system rejected the request.
+	bool set_thread_affinity(std::thread::native_handle_type thread_handle, uint32_t core_id);
+
+	/// Restricts a thread to run on any of the given logical cores. Returns false if the operating system rejected the request.
+	bool set_thread_affinity(std::thread::native_handle_type thread_handle, const std::vector<uint32_t>& core_ids);
+
 	/* a priori we need 3 threads, plus 1 for parallel-task workers and at least one more for host-task.
 	 This depends on the application invoking celerity. */
 	constexpr static uint64_t min_cores_needed = 5;
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace celerity::detail {
+
+/// Bump allocator that carves allocations from a list of fixed-size blocks and releases all of them at once on destruction.
+///
+/// The arena never runs destructors. Owners of non-trivially destructible objects placed in an arena must destroy them before the arena goes away, e.g.
+/// through a `std::unique_ptr<T, arena_destroyer>`. Object addresses remain stable when the arena is moved.
+class arena {
+  public:
+	constexpr static size_t default_block_size = 64 * 1024;
+
+	arena() : arena(default_block_size) {}
+	explicit arena(const size_t block_size) : m_block_size(block_size) { assert(block_size > 0); }
+
+	arena(const arena&) = delete;
+	arena(arena&& other) noexcept { *this = std::move(other); }
+	arena& operator=(const arena&) = delete;
+	arena& operator=(arena&& other) noexcept {
+		m_block_size = other.m_block_size;
+		m_blocks = std::move(other.m_blocks);
+		m_current_block = std::exchange(other.m_current_block, nullptr);
+		m_cursor = std::exchange(other.m_cursor, nullptr);
+		m_end = std::exchange(other.m_end, nullptr);
+		m_allocated_bytes = std::exchange(other.m_allocated_bytes, 0);
+		return *this;
+	}
+	~arena() = default;
+
+	/// Returns uninitialized memory of `size` bytes at the requested (power-of-two) `alignment`. Never returns nullptr.
+	void* allocate(const size_t size, const size_t alignment) {
+		assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+		m_allocated_bytes += size;
+		if(m_cursor != nullptr) {
+			const auto offset = align_up(m_cursor, alignment) - m_cursor;
+			if(offset <= m_end - m_cursor && static_cast<size_t>(m_end - m_cursor - offset) >= size) {
+				const auto ptr = m_cursor + offset;
+				m_cursor = ptr + size;
+				return ptr;
+			}
+		}
+		// Requests that do not fit into a regular block receive a dedicated one, and we keep bumping inside the current block afterwards
+		const auto padded_size = size + alignment - 1;
+		const auto new_block_size = std::max(m_block_size, padded_size);
+		auto* const block = m_blocks.emplace_back(new std::byte[new_block_size]).get();
+		const auto ptr = align_up(block, alignment);
+		if(new_block_size == m_block_size) {
+			m_current_block = block;
+			m_cursor = ptr + size;
+			m_end = block + new_block_size;
+		}
+		return ptr;
+	}
+
+	template <typename T, typename... CtorParams>
+	T* create(CtorParams&&... ctor_args) {
+		return new(allocate(sizeof(T), alignof(T))) T(std::forward<CtorParams>(ctor_args)...);
+	}
+
+	/// Makes all memory available for reuse while holding on to the current block. The caller must have destroyed all objects in the arena.
+	void reset() {
+		const auto current = std::find_if(m_blocks.begin(), m_blocks.end(), [this](const auto& b) { return b.get() == m_current_block; });
+		if(current != m_blocks.end()) {
+			auto keep = std::move(*current);
+			m_blocks.clear();
+			m_blocks.push_back(std::move(keep));
+			m_cursor = m_current_block;
+		} else {
+			m_blocks.clear();
+		}
+		m_allocated_bytes = 0;
+	}
+
+	/// Sum of the sizes of all allocations so far (excluding alignment padding).
+	size_t get_allocated_bytes() const { return m_allocated_bytes; }
+
+	size_t get_block_count() const { return m_blocks.size(); }
+
+  private:
+	size_t m_block_size = default_block_size;
+	std::vector<std::unique_ptr<std::byte[]>> m_blocks;
+	std::byte* m_current_block = nullptr; // the last regular-sized block, which we bump-allocate from
+	std::byte* m_cursor = nullptr;
+	std::byte* m_end = nullptr;
+	size_t m_allocated_bytes = 0;
+
+	static std::byte* align_up(std::byte* const ptr, const size_t alignment) {
+		const auto addr = reinterpret_cast<uintptr_t>(ptr);
+		return ptr + (((addr + alignment - 1) & ~(uintptr_t{alignment} - 1)) - addr);
+	}
+};
+
+/// Deleter for `std::unique_ptr` that destroys an object living in an `arena` without freeing its memory.
+struct arena_destroyer {
+	template <typename T>
+	void operator()(T* const ptr) const {
+		ptr->~T();
+	}
+};
+
+/// Deleter for `std::unique_ptr` to objects that were either allocated with `new` or placed in an `arena`, as decided at runtime.
+struct arena_or_heap_deleter {
+	bool in_arena = false;
+
+	arena_or_heap_deleter() = default;
+	explicit arena_or_heap_deleter(const bool in_arena) : in_arena(in_arena) {}
+
+	// allows conversion from std::unique_ptr<T> for heap-allocated objects
+	template <typename T>
+	arena_or_heap_deleter(std::default_delete<T> /* deleter */) {}
+
+	template <typename T>
+	void operator()(T* const ptr) const {
+		if(in_arena) {
+			ptr->~T();
+		} else {
+			delete ptr;
+		}
+	}
+};
+
+/// Constructs an object in `storage`, or on the heap if `storage` is nullptr.
+template <typename T, typename... CtorParams>
+std::unique_ptr<T, arena_or_heap_deleter> make_unique_in(arena* const storage, CtorParams&&... ctor_args) {
+	if(storage == nullptr) return std::unique_ptr<T, arena_or_heap_deleter>(new T(std::forward<CtorParams>(ctor_args)...));
+	return std::unique_ptr<T, arena_or_heap_deleter>(storage->create<T>(std::forward<CtorParams>(ctor_args)...), arena_or_heap_deleter(true));
+}
+
+} // namespace celerity::detail
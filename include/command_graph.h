@@ -1,5 +1,6 @@
 #pragma once
 
+#include <deque>
 #include <memory>
 #include <optional>
 #include <string>
@@ -8,6 +9,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "arena.h"
 #include "command.h"
 #include "types.h"
 
@@ -97,9 +99,13 @@ namespace detail {
 		template <typename T, typename... Args>
 		T* create(Args&&... args) {
 			static_assert(std::is_base_of<abstract_command, T>::value, "T must be derived from abstract_command");
-			auto unique_cmd = std::unique_ptr<T>{new T(m_next_cmd_id++, std::forward<Args>(args)...)}; // new, because ctors are private, but we are friends
-			const auto cmd = unique_cmd.get();
-			m_commands.emplace(std::pair{cmd->get_cid(), std::move(unique_cmd)});
+			// Pruning always happens up to a horizon or epoch command, so every such command opens a new storage segment
+			if(m_segments.empty() || std::is_same_v<T, horizon_command> || std::is_same_v<T, epoch_command>) { m_segments.push_back({m_next_cmd_id}); }
+			auto& segment = m_segments.back();
+			// placement-new instead of arena::create, because ctors are private, but we are friends
+			const auto cmd = new(segment.storage.allocate(sizeof(T), alignof(T))) T(m_next_cmd_id++, std::forward<Args>(args)...);
+			++segment.num_live_commands;
+			m_commands.emplace(std::pair{cmd->get_cid(), std::unique_ptr<abstract_command, arena_destroyer>(cmd)});
 			if constexpr(std::is_base_of_v<task_command, T>) { m_by_task[cmd->get_tid()].emplace_back(cmd); }
 			m_execution_front.insert(cmd);
 			return cmd;
@@ -155,13 +161,26 @@ namespace detail {
 
 		const command_set& get_execution_front() const { return m_execution_front; }
 
+		/// Number of storage segments (one per horizon or epoch) that still hold live commands.
+		size_t get_storage_segment_count() const { return m_segments.size(); }
+
 	  private:
+		/// Commands are allocated from one arena per horizon / epoch interval. Once all commands of a segment have been erased (which happens in bulk
+		/// when pruning before a horizon or epoch), its memory is released at once.
+		struct storage_segment {
+			command_id first_cid;
+			arena storage;
+			size_t num_live_commands = 0;
+		};
+
 		command_id m_next_cmd_id = 0;
-		// TODO: Consider storing commands in a contiguous memory data structure instead
-		std::unordered_map<command_id, std::unique_ptr<abstract_command>> m_commands;
+		std::deque<storage_segment> m_segments; // declared before m_commands so that commands are destroyed before their memory is released
+		std::unordered_map<command_id, std::unique_ptr<abstract_command, arena_destroyer>> m_commands;
 		std::unordered_map<task_id, std::vector<task_command*>> m_by_task;
 
 		command_set m_execution_front;
+
+		void release_segment_of(command_id cid);
 	};
 
 } // namespace detail
@@ -0,0 +1,192 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <optional>
+#include <thread>
+
+#include "arena.h"
+#include "command.h"
+#include "grid.h"
+#include "types.h"
+
+namespace celerity::detail {
+
+/// A command_pkg in a fixed memory layout that can be written into a preallocated ring slot without touching the heap.
+///
+/// The fields of all command types are stored side by side instead of in a variant, so that re-encoding into a recycled slot never destroys or constructs
+/// anything. Up to `max_inline_dependencies` dependencies are stored inline; commands with a larger fan-in, as well as the region of an await-push, spill
+/// into the arena of the slot they are encoded into.
+struct encoded_command {
+	constexpr static size_t max_inline_dependencies = 8;
+
+	command_id cid{};
+	command_type type{};
+
+	task_id tid{};                      ///< horizon, epoch, execution, fence
+	epoch_action action{};              ///< epoch
+	subrange<3> sr;                     ///< execution, push
+	bool initialize_reductions = false; ///< execution
+	node_id target{};                   ///< push
+	transfer_id trid;                   ///< push, await_push
+	reduction_id rid{};                 ///< reduction
+
+	size_t num_region_boxes = 0;          ///< await_push
+	const box<3>* region_boxes = nullptr; ///< await_push, in the slot arena
+
+	size_t num_dependencies = 0;
+	command_id inline_dependencies[max_inline_dependencies]{};
+	const command_id* spilled_dependencies = nullptr; ///< in the slot arena if num_dependencies > max_inline_dependencies
+
+	const command_id* dependencies_begin() const {
+		return num_dependencies > max_inline_dependencies ? spilled_dependencies : inline_dependencies;
+	}
+	const command_id* dependencies_end() const { return dependencies_begin() + num_dependencies; }
+
+	std::optional<task_id> get_tid() const {
+		switch(type) {
+		case command_type::horizon:
+		case command_type::epoch:
+		case command_type::execution:
+		case command_type::fence: return tid;
+		default: return std::nullopt;
+		}
+	}
+
+	/// Reconstructs the command data for job creation. Dependencies are not copied, since jobs only ever see them through the job_dependency_tracker.
+	command_pkg decode() const {
+		command_pkg pkg;
+		pkg.cid = cid;
+		switch(type) {
+		case command_type::horizon: pkg.data = horizon_data{tid}; break;
+		case command_type::epoch: pkg.data = epoch_data{tid, action}; break;
+		case command_type::execution: pkg.data = execution_data{tid, sr, initialize_reductions}; break;
+		case command_type::push: pkg.data = push_data{target, trid, sr}; break;
+		case command_type::await_push:
+			pkg.data = await_push_data{trid, region<3>(box_vector<3>(region_boxes, region_boxes + num_region_boxes))};
+			break;
+		case command_type::reduction: pkg.data = reduction_data{rid}; break;
+		case command_type::fence: pkg.data = fence_data{tid}; break;
+		default: assert(!"Unexpected command");
+		}
+		return pkg;
+	}
+};
+
+// Dependency lists and await-push regions that spill out of an encoded_command typically fit into a single block of this size.
+constexpr size_t command_ring_slot_storage_block_size = 1024;
+
+/// Bounded, lock-free single-producer single-consumer ring of encoded commands, used to hand commands from the scheduler thread to the executor.
+///
+/// All slots and their spill arenas are allocated up front and reused, so neither side allocates in steady state. The consumer inspects the command at
+/// the head of the ring in place and only releases the slot once it is done with it, which lets the executor hold back a command whose task has not been
+/// created yet without moving it out of the ring. The producer yields while the ring is full.
+class command_ring {
+  public:
+	/// `capacity` must be a power of two.
+	explicit command_ring(const size_t capacity) : m_mask(capacity - 1), m_slots(new slot[capacity]) {
+		assert(capacity > 0 && (capacity & (capacity - 1)) == 0 && "command_ring capacity must be a power of two");
+	}
+
+	command_ring(const command_ring&) = delete;
+	command_ring(command_ring&&) = delete;
+	command_ring& operator=(const command_ring&) = delete;
+	command_ring& operator=(command_ring&&) = delete;
+	~command_ring() = default;
+
+	size_t capacity() const { return m_mask + 1; }
+
+	/// Producer only. Blocks (by yielding) while the ring is full.
+	void push(const command_pkg& pkg) {
+		const auto tail = m_tail.load(std::memory_order_relaxed);
+		while(tail - m_head.load(std::memory_order_acquire) > m_mask) {
+			std::this_thread::yield();
+		}
+		auto& s = m_slots[tail & m_mask];
+		s.storage.reset(); // the consumer has released the slot, so nothing refers to the previous command's spilled data anymore
+		encode(pkg, s);
+		m_tail.store(tail + 1, std::memory_order_release);
+	}
+
+	/// Consumer only. Returns the oldest command in the ring without removing it, or nullptr if the ring is empty.
+	const encoded_command* peek() const {
+		const auto head = m_head.load(std::memory_order_relaxed);
+		if(head == m_tail.load(std::memory_order_acquire)) return nullptr;
+		return &m_slots[head & m_mask].cmd;
+	}
+
+	/// Consumer only. Releases the command returned by the last call to peek().
+	void pop() {
+		const auto head = m_head.load(std::memory_order_relaxed);
+		assert(head != m_tail.load(std::memory_order_relaxed));
+		m_head.store(head + 1, std::memory_order_release);
+	}
+
+	/// Only reliable when called from the consumer thread or while the producer is idle.
+	bool empty() const { return m_head.load(std::memory_order_acquire) == m_tail.load(std::memory_order_acquire); }
+
+  private:
+	struct slot {
+		encoded_command cmd;
+		arena storage{command_ring_slot_storage_block_size};
+	};
+
+	size_t m_mask;
+	std::unique_ptr<slot[]> m_slots;
+	// The producer and consumer indices live on separate cache lines to avoid false sharing
+	alignas(64) std::atomic<size_t> m_head{0}; // next slot to be consumed, written by the consumer
+	alignas(64) std::atomic<size_t> m_tail{0}; // next slot to be produced, written by the producer
+
+	template <typename T>
+	static const T* spill(arena& storage, const T* const first, const size_t count) {
+		auto* const dest = static_cast<T*>(storage.allocate(count * sizeof(T), alignof(T)));
+		std::uninitialized_copy_n(first, count, dest);
+		return dest;
+	}
+
+	static void encode(const command_pkg& pkg, slot& s) {
+		auto& cmd = s.cmd;
+		cmd.cid = pkg.cid;
+		cmd.type = pkg.get_command_type();
+		// clang-format off
+		matchbox::match(pkg.data,
+			[&](const horizon_data& d) { cmd.tid = d.tid; },
+			[&](const epoch_data& d) {
+				cmd.tid = d.tid;
+				cmd.action = d.action;
+			},
+			[&](const execution_data& d) {
+				cmd.tid = d.tid;
+				cmd.sr = d.sr;
+				cmd.initialize_reductions = d.initialize_reductions;
+			},
+			[&](const push_data& d) {
+				cmd.target = d.target;
+				cmd.trid = d.trid;
+				cmd.sr = d.sr;
+			},
+			[&](const await_push_data& d) {
+				const auto& boxes = d.region.get_boxes();
+				cmd.trid = d.trid;
+				cmd.num_region_boxes = boxes.size();
+				cmd.region_boxes = spill(s.storage, boxes.data(), boxes.size());
+			},
+			[&](const reduction_data& d) { cmd.rid = d.rid; },
+			[&](const fence_data& d) { cmd.tid = d.tid; },
+			[](const std::monostate&) {}
+		);
+		// clang-format on
+		cmd.num_dependencies = pkg.dependencies.size();
+		if(cmd.num_dependencies > encoded_command::max_inline_dependencies) {
+			cmd.spilled_dependencies = spill(s.storage, pkg.dependencies.data(), pkg.dependencies.size());
+		} else {
+			std::copy(pkg.dependencies.begin(), pkg.dependencies.end(), cmd.inline_dependencies);
+		}
+	}
+};
+
+} // namespace celerity::detail
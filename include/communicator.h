@@ -49,6 +49,14 @@ class communicator {
 	/// need to remain live after the function returns.
 	virtual void send_outbound_pilot(const outbound_pilot& pilot) = 0;
 
+	/// Asynchronously sends all pilots generated for one instruction batch, which may be destined for different peers. Implementations can coalesce all
+	/// pilots to the same peer into a single message. The default implementation sends every pilot individually.
+	virtual void send_outbound_pilots(const std::vector<outbound_pilot>& pilots) {
+		for(const auto& pilot : pilots) {
+			send_outbound_pilot(pilot);
+		}
+	}
+
 	/// Returns all inbound pilots received on this communicator since the last invocation of the same function. Never blocks.
 	[[nodiscard]] virtual std::vector<inbound_pilot> poll_inbound_pilots() = 0;
 
@@ -57,7 +65,8 @@ class communicator {
 	[[nodiscard]] virtual async_event send_payload(node_id to, message_id msgid, const void* base, const stride& stride) = 0;
 
 	/// Begins receiving strided data (which was previously announced using an inbound_pilot) from the specified node. The `base` allocation must remain live
-	/// until the returned event completes, and no element inside `stride` must be written to during that time.
+	/// until the returned event completes, and no element inside `stride` must be written to during that time. Receives with the same recurring message id
+	/// (see `is_recurring_message_id`) from the same node must be issued in the order of the corresponding sends (`pilot_message::sequence`).
 	[[nodiscard]] virtual async_event receive_payload(node_id from, message_id msgid, void* base, const stride& stride) = 0;
 
 	/// Creates a new communicator that is fully concurrent to this one, and which has its own "namespace" for peer-to-peer and collective operations.
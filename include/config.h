@@ -50,6 +50,11 @@ namespace detail {
 		int get_dry_run_nodes() const { return m_dry_run_nodes; }
 		std::optional<int> get_horizon_step() const { return m_horizon_step; }
 		std::optional<int> get_horizon_max_parallelism() const { return m_horizon_max_parallelism; }
+		bool should_use_adaptive_horizons() const { return m_use_adaptive_horizons; }
+		std::optional<int> get_scheduler_lookahead() const { return m_scheduler_lookahead; }
+		std::optional<size_t> get_task_window_memory_limit() const { return m_task_window_memory_limit; }
+		bool should_use_live_executor() const { return m_use_live_executor; }
+		std::optional<int> get_graph_generation_threads() const { return m_graph_generation_threads; }
 
 	  private:
 		log_level m_log_lvl;
@@ -60,6 +65,11 @@ namespace detail {
 		bool m_should_print_graphs = false;
 		std::optional<int> m_horizon_step;
 		std::optional<int> m_horizon_max_parallelism;
+		bool m_use_adaptive_horizons = false;
+		std::optional<int> m_scheduler_lookahead;
+		std::optional<size_t> m_task_window_memory_limit;
+		bool m_use_live_executor = false;
+		std::optional<int> m_graph_generation_threads;
 	};
 
 } // namespace detail
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <mutex>
+#include <typeindex>
+#include <unordered_map>
+
+namespace celerity::detail {
+
+class instruction;
+
+/// Estimates the run time of instructions.
+///
+/// instruction_graph_generator annotates every instruction with an estimate from its cost model, which in turn steers the critical-path component of
+/// instruction priorities and the order in which out_of_order_engine assigns concurrent instructions of equal priority. Estimates only need to be
+/// consistent relative to each other, not accurate in absolute terms.
+class cost_model {
+  public:
+	cost_model() = default;
+	cost_model(const cost_model&) = delete;
+	cost_model(cost_model&&) = delete;
+	cost_model& operator=(const cost_model&) = delete;
+	cost_model& operator=(cost_model&&) = delete;
+	virtual ~cost_model() = default;
+
+	/// Called from the scheduler thread for every generated instruction, after its construction and before it is passed on to the executor.
+	virtual std::chrono::nanoseconds estimate(const instruction& instr) const = 0;
+
+	/// Called from the executor thread once an instruction has completed, with the time between its dispatch and the moment its completion was observed.
+	virtual void observe(const instruction& /* instr */, std::chrono::nanoseconds /* elapsed */) {}
+};
+
+/// Estimates run times from static properties of an instruction: The number of bytes copied or transferred, and the area of the execution range of kernels
+/// and host tasks.
+class static_cost_model : public cost_model {
+  public:
+	struct parameters {
+		std::chrono::nanoseconds alloc_duration{10'000};
+		std::chrono::nanoseconds free_duration{1'000};
+		std::chrono::nanoseconds copy_overhead{2'000};
+		double copy_bytes_per_ns = 8;
+		std::chrono::nanoseconds kernel_launch_overhead{5'000};
+		double kernel_ns_per_item = 0.01;
+		std::chrono::nanoseconds host_task_overhead{10'000};
+		double host_task_ns_per_item = 1;
+		std::chrono::nanoseconds transfer_latency{20'000}; ///< applies to every send and receive, since a peer is waiting on the transfer to make progress
+		double transfer_bytes_per_ns = 4;
+		double reduce_ns_per_value = 1;
+	};
+
+	static_cost_model() : static_cost_model(parameters{}) {}
+	explicit static_cost_model(const parameters& params) : m_params(params) {}
+
+	std::chrono::nanoseconds estimate(const instruction& instr) const override;
+
+	const parameters& get_parameters() const { return m_params; }
+
+  private:
+	parameters m_params;
+};
+
+/// Refines the static estimates for device kernels and host tasks with run times observed for earlier instances of the same kernel.
+///
+/// Kernels are identified by the type of their launcher closure, which the handler instantiates once per kernel functor. The model keeps an exponential
+/// moving average of the time per execution-range item for each kernel, which carries over between invocations with differently-sized ranges. Since
+/// observed times are measured from dispatch, they include time spent waiting in an in-order queue, which makes the model err towards longer estimates for
+/// kernels that are commonly submitted back-to-back.
+class calibrated_cost_model final : public static_cost_model {
+  public:
+	/// Weight of each new observation in the moving average.
+	constexpr static double smoothing_factor = 0.25;
+
+	using static_cost_model::static_cost_model;
+
+	std::chrono::nanoseconds estimate(const instruction& instr) const override;
+
+	void observe(const instruction& instr, std::chrono::nanoseconds elapsed) override;
+
+	size_t get_num_calibrated_kernels() const;
+
+  private:
+	mutable std::mutex m_mutex; // estimate() and observe() are called from the scheduler and executor threads, respectively
+	std::unordered_map<std::type_index, double> m_ns_per_item;
+};
+
+} // namespace celerity::detail
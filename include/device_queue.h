@@ -295,5 +295,46 @@ namespace detail {
 		return device;
 	}
 
+	/// Selects all devices that the live executor drives on this node, starting with the `primary` device chosen by `pick_device`. A device that was specified
+	/// by the user or through CELERITY_DEVICES is used on its own. Otherwise, if `pick_device` assigned the primary device by local rank, this rank also
+	/// receives every further matching device of the same platform whose index is congruent to the local rank, so ranks that share a host never share a device.
+	template <typename DevicePtrOrSelector, typename DeviceT>
+	std::vector<DeviceT> pick_devices(const config& cfg, const DevicePtrOrSelector& user_device_or_selector, const DeviceT& primary) {
+		constexpr bool user_device_provided = std::is_same_v<DevicePtrOrSelector, DeviceT>;
+		constexpr bool device_selector_provided = std::is_invocable_r_v<int, DevicePtrOrSelector, DeviceT>;
+
+		std::vector<DeviceT> devices{primary};
+		if constexpr(!user_device_provided) {
+			if(cfg.get_device_config() != std::nullopt) return devices;
+
+			std::vector<DeviceT> candidates;
+			for(const auto& device : primary.get_platform().get_devices()) {
+				if constexpr(device_selector_provided) {
+					if(user_device_or_selector(device) == -1) continue;
+				} else {
+					if(device.template get_info<sycl::info::device::device_type>() != primary.template get_info<sycl::info::device::device_type>()) continue;
+				}
+				candidates.push_back(device);
+			}
+			if constexpr(device_selector_provided) {
+				std::stable_sort(candidates.begin(), candidates.end(),
+				    [&](const auto& a, const auto& b) { return user_device_or_selector(a) > user_device_or_selector(b); });
+			}
+
+			// If the primary device was not assigned by local rank (e.g. because there are fewer devices than ranks on this host), we cannot partition the
+			// remaining devices without risking that two ranks share one
+			const auto host_cfg = cfg.get_host_config();
+			if(candidates.size() < host_cfg.node_count || !(candidates[host_cfg.local_rank] == primary)) return devices;
+			for(size_t i = host_cfg.local_rank + host_cfg.node_count; i < candidates.size(); i += host_cfg.node_count) {
+				devices.push_back(candidates[i]);
+			}
+		}
+
+		if(devices.size() > 1) {
+			CELERITY_INFO("Using {} devices of platform '{}'", devices.size(), primary.get_platform().template get_info<sycl::info::platform::name>());
+		}
+		return devices;
+	}
+
 } // namespace detail
 } // namespace celerity
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <bitset>
+#include <memory>
 #include <unordered_map>
 
 #include "command_graph.h"
@@ -15,6 +16,7 @@ class task_manager;
 class abstract_command;
 class task_recorder;
 class command_recorder;
+class work_stealing_pool;
 
 // TODO: Make compile-time configurable
 constexpr size_t max_num_nodes = 256;
@@ -90,6 +92,19 @@ class distributed_graph_generator {
 	distributed_graph_generator(const size_t num_nodes, const node_id local_nid, command_graph& cdag, const task_manager& tm,
 	    detail::command_recorder* recorder, const policy_set& policy = default_policy_set());
 
+	distributed_graph_generator(const distributed_graph_generator&) = delete;
+	distributed_graph_generator(distributed_graph_generator&&) = delete;
+	distributed_graph_generator& operator=(const distributed_graph_generator&) = delete;
+	distributed_graph_generator& operator=(distributed_graph_generator&&) = delete;
+
+	~distributed_graph_generator();
+
+	/**
+	 * Evaluates range mappers and plans push commands for the chunks of large tasks on `num_workers` additional threads. Commands are still created on
+	 * the calling thread in chunk order, so the generated graph is identical to sequential generation. Range mappers must be safe to call concurrently.
+	 */
+	void enable_parallel_generation(size_t num_workers);
+
 	void notify_buffer_created(buffer_id bid, const range<3>& range, bool host_initialized);
 
 	void notify_buffer_debug_name_changed(buffer_id bid, const std::string& debug_name);
@@ -138,6 +153,10 @@ class distributed_graph_generator {
 
 	void report_overlapping_writes(const task& tsk, const box_vector<3>& local_chunks) const;
 
+	// Invokes f(i) for all i in [0, n), distributing the calls across the worker pool if parallel generation is enabled and n is large enough.
+	template <typename Functor>
+	void parallel_for(size_t n, const Functor& f);
+
   private:
 	using buffer_read_map = std::unordered_map<buffer_id, region<3>>;
 
@@ -176,6 +195,9 @@ class distributed_graph_generator {
 
 	// Generated commands will be recorded to this recorder if it is set
 	detail::command_recorder* m_recorder = nullptr;
+
+	// Set by enable_parallel_generation()
+	std::unique_ptr<work_stealing_pool> m_worker_pool;
 };
 
 /// Topologically sort a command-set as returned from distributed_graph_generator::build_task() such that sequential execution satisfies all dependencies.
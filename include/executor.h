@@ -1,10 +1,15 @@
 #pragma once
 
 #include <chrono>
+#include <deque>
+#include <optional>
 #include <thread>
+#include <unordered_map>
+#include <vector>
 
 #include "buffer_transfer_manager.h"
 #include "command.h"
+#include "command_ring.h"
 #include "worker_job.h"
 
 namespace celerity {
@@ -39,6 +44,54 @@ namespace detail {
 		duration_metric starvation;
 	};
 
+	/**
+	 * @brief Tracks dependencies between in-flight jobs by counting unsatisfied dependencies per job.
+	 *
+	 * A job becomes ready as soon as its last dependency completes, so the executor never needs to inspect jobs that are still waiting. Ready jobs can be
+	 * prioritized, in which case they are returned from pop_ready() before all non-prioritized ones.
+	 */
+	class job_dependency_tracker {
+	  public:
+		/**
+		 * Registers a new job. Dependencies that are not tracked (anymore) are assumed to have completed already.
+		 * This is true as long as we're respecting task-graph (anti-)dependencies when processing tasks.
+		 */
+		void add(command_id cid, const command_id* dependencies_begin, const command_id* dependencies_end, bool prioritize);
+
+		void add(const command_id cid, const std::vector<command_id>& dependencies, const bool prioritize) {
+			add(cid, dependencies.data(), dependencies.data() + dependencies.size(), prioritize);
+		}
+
+		/**
+		 * @brief Returns the next job whose dependencies are all satisfied, if any.
+		 */
+		std::optional<command_id> pop_ready();
+
+		/**
+		 * @brief Removes a completed job and makes all dependents ready that were only waiting on it.
+		 */
+		void complete(command_id cid);
+
+		size_t get_tracked_count() const { return m_nodes.size(); }
+		bool is_empty() const { return m_nodes.empty(); }
+
+	  private:
+		struct node {
+			std::vector<command_id> dependents;
+			size_t unsatisfied_dependencies = 0;
+			bool prioritize = false;
+		};
+
+		std::unordered_map<command_id, node> m_nodes;
+		std::deque<command_id> m_ready_prioritized;
+		std::deque<command_id> m_ready;
+
+		void push_ready(command_id cid, bool prioritize);
+	};
+
+	// Number of commands the scheduler can run ahead of the executor before it blocks on a full command ring.
+	constexpr size_t executor_command_ring_capacity = 4096;
+
 	class executor {
 		friend struct executor_testspy;
 
@@ -49,9 +102,23 @@ namespace detail {
 
 		void startup();
 
-		void enqueue(command_pkg&& pkg) {
-			std::scoped_lock lk(m_command_queue_mutex);
-			m_command_queue.push(std::move(pkg));
+		/**
+		 * @brief Only valid between startup() and shutdown().
+		 */
+		std::thread::native_handle_type get_thread_handle() { return m_exec_thrd.native_handle(); }
+
+		/**
+		 * @brief Encodes a command into the command ring. Must only be called from a single (scheduler) thread, and blocks while the ring is full.
+		 */
+		void enqueue(command_pkg&& pkg) { m_command_ring.push(pkg); }
+
+		/**
+		 * @brief Enqueues a batch of commands in submission order.
+		 */
+		void enqueue(std::vector<command_pkg>&& pkgs) {
+			for(const auto& pkg : pkgs) {
+				m_command_ring.push(pkg);
+			}
 		}
 
 		/**
@@ -71,39 +138,31 @@ namespace detail {
 		std::thread m_exec_thrd;
 		size_t m_running_device_compute_jobs = 0;
 
-		std::mutex m_command_queue_mutex;
-		std::queue<command_pkg> m_command_queue;
+		command_ring m_command_ring{executor_command_ring_capacity};
 
 		// Jobs are identified by the command id they're processing
 
-		struct job_handle {
-			std::unique_ptr<worker_job> job;
-			command_type cmd;
-			std::vector<command_id> dependents;
-			size_t unsatisfied_dependencies;
-		};
-
-		std::unordered_map<command_id, job_handle> m_jobs;
+		std::unordered_map<command_id, std::unique_ptr<worker_job>> m_jobs;
+		job_dependency_tracker m_job_dependencies;
+		// Jobs that have been started but are not done yet. Only these are updated in each executor loop iteration.
+		std::vector<command_id> m_polled_jobs;
+		bool m_shutdown_reached = false;
 
 		executor_metrics m_metrics;
 		bool m_first_command_received = false;
 
 		template <typename Job, typename... Args>
-		void create_job(const command_pkg& pkg, Args&&... args) {
-			m_jobs[pkg.cid] = {std::make_unique<Job>(pkg, std::forward<Args>(args)...), pkg.get_command_type(), {}, 0};
-
-			// If job doesn't exist we assume it has already completed.
-			// This is true as long as we're respecting task-graph (anti-)dependencies when processing tasks.
-			for(const auto dcid : pkg.dependencies) {
-				if(const auto it = m_jobs.find(dcid); it != m_jobs.end()) {
-					it->second.dependents.push_back(pkg.cid);
-					m_jobs[pkg.cid].unsatisfied_dependencies++;
-				}
-			}
+		void create_job(const encoded_command& cmd, Args&&... args) {
+			m_jobs.emplace(cmd.cid, std::make_unique<Job>(cmd.decode(), std::forward<Args>(args)...));
+			// Make sure to start any push jobs before other jobs, as on some platforms copying data from a compute device while
+			// also reading it from within a kernel is not supported. To avoid stalling other nodes, we thus perform the push first.
+			m_job_dependencies.add(cmd.cid, cmd.dependencies_begin(), cmd.dependencies_end(), cmd.type == command_type::push);
 		}
 
 		void run();
-		bool handle_command(const command_pkg& pkg);
+		bool handle_command(const encoded_command& cmd);
+		void start_ready_jobs();
+		void retire_job(command_id cid);
 
 		void update_metrics();
 	};
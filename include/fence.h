@@ -86,12 +86,23 @@ class host_object_fence_promise final : public detail::fence_promise {
 template <typename DataT, int Dims>
 class buffer_fence_promise final : public detail::fence_promise {
   public:
-	explicit buffer_fence_promise(const buffer<DataT, Dims>& buf, const subrange<Dims>& sr)
-	    : m_buffer(buf), m_subrange(sr), m_aid(null_allocation_id /* [IDAG placeholder] */) {}
+	explicit buffer_fence_promise(const buffer<DataT, Dims>& buf, const subrange<Dims>& sr) : m_buffer(buf), m_subrange(sr), m_aid(null_allocation_id) {
+		auto& rt = runtime::get_instance();
+		if(rt.uses_live_executor()) {
+			// The instruction graph copies the fenced subrange into this user allocation before the fence instruction fulfills the promise
+			m_data = std::make_unique<DataT[]>(m_subrange.range.size());
+			m_aid = rt.create_user_allocation(m_data.get());
+		}
+	}
 
 	std::future<buffer_snapshot<DataT, Dims>> get_future() { return m_promise.get_future(); }
 
 	void fulfill() override {
+		if(m_data != nullptr) {
+			m_promise.set_value(buffer_snapshot<DataT, Dims>(m_subrange, std::move(m_data)));
+			return;
+		}
+
 		const auto access_info =
 		    runtime::get_instance().get_buffer_manager().access_host_buffer<DataT, Dims>(get_buffer_id(m_buffer), access_mode::read, m_subrange);
 		assert(all_true(id_cast<Dims>(access_info.backing_buffer_offset) <= m_subrange.offset));
@@ -107,6 +118,7 @@ class buffer_fence_promise final : public detail::fence_promise {
 	buffer<DataT, Dims> m_buffer;
 	subrange<Dims> m_subrange;
 	allocation_id m_aid;
+	std::unique_ptr<DataT[]> m_data; // only allocated up front with the live executor
 	std::promise<buffer_snapshot<DataT, Dims>> m_promise;
 };
 
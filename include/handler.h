@@ -1,6 +1,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 #include <regex>
 #include <type_traits>
 #include <typeinfo>
@@ -8,6 +9,7 @@
 
 #include <CL/sycl.hpp>
 #include <fmt/format.h>
+#include <gch/small_vector.hpp>
 
 #include "buffer.h"
 #include "cgf_diagnostics.h"
@@ -57,9 +59,10 @@ namespace detail {
 	class device_queue;
 	class task_manager;
 
-	handler make_command_group_handler(const task_id tid, const size_t num_collective_nodes);
-	std::unique_ptr<task> into_task(handler&& cgh);
-	hydration_id add_requirement(handler& cgh, const buffer_id bid, std::unique_ptr<range_mapper_base> rm);
+	handler make_command_group_handler(const task_id tid, const size_t num_collective_nodes, arena* const task_storage);
+	task into_task(handler&& cgh);
+	arena* get_task_storage(handler& cgh);
+	hydration_id add_requirement(handler& cgh, const buffer_id bid, unique_range_mapper_ptr rm);
 	void add_requirement(handler& cgh, const host_object_id hoid, const experimental::side_effect_order order, const bool is_void);
 	void add_reduction(handler& cgh, const reduction_info& rinfo);
 	void extend_lifetime(handler& cgh, std::shared_ptr<detail::lifetime_extending_state> state);
@@ -385,9 +388,10 @@ class handler {
 	}
 
   private:
-	friend handler detail::make_command_group_handler(const detail::task_id tid, const size_t num_collective_nodes);
-	friend std::unique_ptr<detail::task> detail::into_task(handler&& cgh);
-	friend detail::hydration_id detail::add_requirement(handler& cgh, const detail::buffer_id bid, std::unique_ptr<detail::range_mapper_base> rm);
+	friend handler detail::make_command_group_handler(const detail::task_id tid, const size_t num_collective_nodes, detail::arena* const task_storage);
+	friend detail::task detail::into_task(handler&& cgh);
+	friend detail::arena* detail::get_task_storage(handler& cgh);
+	friend detail::hydration_id detail::add_requirement(handler& cgh, const detail::buffer_id bid, detail::unique_range_mapper_ptr rm);
 	friend void detail::add_requirement(handler& cgh, const detail::host_object_id hoid, const experimental::side_effect_order order, const bool is_void);
 	friend void detail::add_reduction(handler& cgh, const detail::reduction_info& rinfo);
 	template <int Dims>
@@ -403,15 +407,17 @@ class handler {
 	detail::side_effect_map m_side_effects;
 	size_t m_non_void_side_effects_count = 0;
 	detail::reduction_set m_reductions;
-	std::unique_ptr<detail::task> m_task = nullptr;
+	std::optional<detail::task> m_task;
 	size_t m_num_collective_nodes;
+	detail::arena* m_task_storage; // where range mappers, launchers and hints are constructed; nullptr for heap allocation
 	detail::hydration_id m_next_accessor_hydration_id = 1;
-	std::vector<std::shared_ptr<detail::lifetime_extending_state>> m_attached_state;
+	gch::small_vector<std::shared_ptr<detail::lifetime_extending_state>, 4> m_attached_state;
 	std::optional<std::string> m_usr_def_task_name;
 	range<3> m_split_constraint = detail::ones;
-	std::vector<std::unique_ptr<detail::hint_base>> m_hints;
+	gch::small_vector<detail::unique_hint_ptr, 2> m_hints;
 
-	handler(detail::task_id tid, size_t num_collective_nodes) : m_tid(tid), m_num_collective_nodes(num_collective_nodes) {}
+	handler(detail::task_id tid, size_t num_collective_nodes, detail::arena* task_storage)
+	    : m_tid(tid), m_num_collective_nodes(num_collective_nodes), m_task_storage(task_storage) {}
 
 	template <typename KernelFlavor, typename KernelName, int Dims, typename... ReductionsAndKernel, size_t... ReductionIndices>
 	void parallel_for_reductions_and_kernel(range<Dims> global_range, id<Dims> global_offset,
@@ -443,20 +449,20 @@ class handler {
 		create_device_compute_task(geometry, detail::kernel_debug_name<KernelName>(), std::move(launcher));
 	}
 
-	[[nodiscard]] detail::hydration_id add_requirement(const detail::buffer_id bid, std::unique_ptr<detail::range_mapper_base> rm) {
-		assert(m_task == nullptr);
+	[[nodiscard]] detail::hydration_id add_requirement(const detail::buffer_id bid, detail::unique_range_mapper_ptr rm) {
+		assert(!m_task.has_value());
 		m_access_map.add_access(bid, std::move(rm));
 		return m_next_accessor_hydration_id++;
 	}
 
 	void add_requirement(const detail::host_object_id hoid, const experimental::side_effect_order order, const bool is_void) {
-		assert(m_task == nullptr);
+		assert(!m_task.has_value());
 		m_side_effects.add_side_effect(hoid, order);
 		if(!is_void) { m_non_void_side_effects_count++; }
 	}
 
 	void add_reduction(const detail::reduction_info& rinfo) {
-		assert(m_task == nullptr);
+		assert(!m_task.has_value());
 		m_reductions.push_back(rinfo);
 	}
 
@@ -464,7 +470,7 @@ class handler {
 
 	template <int Dims>
 	void experimental_constrain_split(const range<Dims>& constraint) {
-		assert(m_task == nullptr);
+		assert(!m_task.has_value());
 		m_split_constraint = detail::range_cast<3>(constraint);
 	}
 
@@ -478,7 +484,7 @@ class handler {
 			if(typeid(hr) == typeid(hint)) { throw std::runtime_error("Providing more than one hint of the same type is not allowed"); }
 			h->validate(hint);
 		}
-		m_hints.emplace_back(std::make_unique<std::decay_t<Hint>>(std::forward<Hint>(hint)));
+		m_hints.emplace_back(detail::make_unique_in<std::decay_t<Hint>>(m_task_storage, std::forward<Hint>(hint)));
 	}
 
 	template <int Dims>
@@ -496,20 +502,20 @@ class handler {
 		return result;
 	}
 
-	void create_host_compute_task(detail::task_geometry geometry, std::unique_ptr<detail::command_launcher_storage_base> launcher) {
-		assert(m_task == nullptr);
+	void create_host_compute_task(detail::task_geometry geometry, detail::unique_launcher_ptr launcher) {
+		assert(!m_task.has_value());
 		if(geometry.global_size.size() == 0) {
 			// TODO this can be easily supported by not creating a task in case the execution range is empty
 			throw std::runtime_error{"The execution range of distributed host tasks must have at least one item"};
 		}
-		m_task =
-		    detail::task::make_host_compute(m_tid, geometry, std::move(launcher), std::move(m_access_map), std::move(m_side_effects), std::move(m_reductions));
+		m_task.emplace(
+		    detail::task::make_host_compute(m_tid, geometry, std::move(launcher), std::move(m_access_map), std::move(m_side_effects), std::move(m_reductions)));
 
 		m_task->set_debug_name(m_usr_def_task_name.value_or(""));
 	}
 
-	void create_device_compute_task(detail::task_geometry geometry, std::string debug_name, std::unique_ptr<detail::command_launcher_storage_base> launcher) {
-		assert(m_task == nullptr);
+	void create_device_compute_task(detail::task_geometry geometry, std::string debug_name, detail::unique_launcher_ptr launcher) {
+		assert(!m_task.has_value());
 		if(geometry.global_size.size() == 0) {
 			// TODO unless reductions are involved, this can be easily supported by not creating a task in case the execution range is empty.
 			// Edge case: If the task includes reductions that specify property::reduction::initialize_to_identity, we need to create a task that sets
@@ -519,21 +525,22 @@ class handler {
 		}
 		// Note that cgf_diagnostics has a similar check, but we don't catch void side effects there.
 		if(!m_side_effects.empty()) { throw std::runtime_error{"Side effects cannot be used in device kernels"}; }
-		m_task = detail::task::make_device_compute(m_tid, geometry, std::move(launcher), std::move(m_access_map), std::move(m_reductions));
+		m_task.emplace(detail::task::make_device_compute(m_tid, geometry, std::move(launcher), std::move(m_access_map), std::move(m_reductions)));
 
 		m_task->set_debug_name(m_usr_def_task_name.value_or(debug_name));
 	}
 
-	void create_collective_task(detail::collective_group_id cgid, std::unique_ptr<detail::command_launcher_storage_base> launcher) {
-		assert(m_task == nullptr);
-		m_task = detail::task::make_collective(m_tid, cgid, m_num_collective_nodes, std::move(launcher), std::move(m_access_map), std::move(m_side_effects));
+	void create_collective_task(detail::collective_group_id cgid, detail::unique_launcher_ptr launcher) {
+		assert(!m_task.has_value());
+		m_task.emplace(
+		    detail::task::make_collective(m_tid, cgid, m_num_collective_nodes, std::move(launcher), std::move(m_access_map), std::move(m_side_effects)));
 
 		m_task->set_debug_name(m_usr_def_task_name.value_or(""));
 	}
 
-	void create_master_node_task(std::unique_ptr<detail::command_launcher_storage_base> launcher) {
-		assert(m_task == nullptr);
-		m_task = detail::task::make_master_node(m_tid, std::move(launcher), std::move(m_access_map), std::move(m_side_effects));
+	void create_master_node_task(detail::unique_launcher_ptr launcher) {
+		assert(!m_task.has_value());
+		m_task.emplace(detail::task::make_master_node(m_tid, std::move(launcher), std::move(m_access_map), std::move(m_side_effects)));
 
 		m_task->set_debug_name(m_usr_def_task_name.value_or(""));
 	}
@@ -548,30 +555,39 @@ class handler {
 		// Although the diagnostics should always be available, we currently disable them for some test cases.
 		if(detail::cgf_diagnostics::is_available()) { detail::cgf_diagnostics::get_instance().check<target::device>(kernel, m_access_map); }
 
-		auto fn = [=](detail::device_queue& q, const subrange<3> execution_sr, const std::vector<void*>& reduction_ptrs, const bool is_reduction_initializer) {
-			return q.submit([&](sycl::handler& cgh) {
-				constexpr int sycl_dims = std::max(1, Dims);
-				// Copy once to hydrate accessors
-				auto hydrated_kernel = detail::closure_hydrator::get_instance().hydrate<target::device>(cgh, kernel);
-				if constexpr(std::is_same_v<KernelFlavor, detail::simple_kernel_flavor>) {
-					const auto sycl_global_range = sycl::range<sycl_dims>(detail::range_cast<sycl_dims>(execution_sr.range));
-					detail::invoke_sycl_parallel_for<KernelName>(cgh, sycl_global_range,
-					    detail::make_sycl_reduction(reductions, reduction_ptrs[ReductionIndices], is_reduction_initializer)...,
-					    detail::bind_simple_kernel(hydrated_kernel, global_range, global_offset, detail::id_cast<Dims>(execution_sr.offset)));
-				} else if constexpr(std::is_same_v<KernelFlavor, detail::nd_range_kernel_flavor>) {
-					const auto sycl_global_range = sycl::range<sycl_dims>(detail::range_cast<sycl_dims>(execution_sr.range));
-					const auto sycl_local_range = sycl::range<sycl_dims>(detail::range_cast<sycl_dims>(local_range));
-					detail::invoke_sycl_parallel_for<KernelName>(cgh, cl::sycl::nd_range{sycl_global_range, sycl_local_range},
-					    detail::make_sycl_reduction(reductions, reduction_ptrs[ReductionIndices], is_reduction_initializer)...,
-					    detail::bind_nd_range_kernel(hydrated_kernel, global_range, global_offset, detail::id_cast<Dims>(execution_sr.offset),
-					        global_range / local_range, detail::id_cast<Dims>(execution_sr.offset) / local_range));
-				} else {
-					static_assert(detail::constexpr_false<KernelFlavor>);
-				}
-			});
+		const auto launch = [=](sycl::handler& cgh, const subrange<3>& execution_sr, const std::vector<void*>& reduction_ptrs,
+		                        const bool is_reduction_initializer) {
+			constexpr int sycl_dims = std::max(1, Dims);
+			// Copy once to hydrate accessors
+			auto hydrated_kernel = detail::closure_hydrator::get_instance().hydrate<target::device>(cgh, kernel);
+			if constexpr(std::is_same_v<KernelFlavor, detail::simple_kernel_flavor>) {
+				const auto sycl_global_range = sycl::range<sycl_dims>(detail::range_cast<sycl_dims>(execution_sr.range));
+				detail::invoke_sycl_parallel_for<KernelName>(cgh, sycl_global_range,
+				    detail::make_sycl_reduction(reductions, reduction_ptrs[ReductionIndices], is_reduction_initializer)...,
+				    detail::bind_simple_kernel(hydrated_kernel, global_range, global_offset, detail::id_cast<Dims>(execution_sr.offset)));
+			} else if constexpr(std::is_same_v<KernelFlavor, detail::nd_range_kernel_flavor>) {
+				const auto sycl_global_range = sycl::range<sycl_dims>(detail::range_cast<sycl_dims>(execution_sr.range));
+				const auto sycl_local_range = sycl::range<sycl_dims>(detail::range_cast<sycl_dims>(local_range));
+				detail::invoke_sycl_parallel_for<KernelName>(cgh, cl::sycl::nd_range{sycl_global_range, sycl_local_range},
+				    detail::make_sycl_reduction(reductions, reduction_ptrs[ReductionIndices], is_reduction_initializer)...,
+				    detail::bind_nd_range_kernel(hydrated_kernel, global_range, global_offset, detail::id_cast<Dims>(execution_sr.offset),
+				        global_range / local_range, detail::id_cast<Dims>(execution_sr.offset) / local_range));
+			} else {
+				static_assert(detail::constexpr_false<KernelFlavor>);
+			}
+		};
+
+		auto fn = detail::launcher_overload_set{
+		    [=](detail::device_queue& q, const subrange<3> execution_sr, const std::vector<void*>& reduction_ptrs, const bool is_reduction_initializer) {
+			    return q.submit([&](sycl::handler& cgh) { launch(cgh, execution_sr, reduction_ptrs, is_reduction_initializer); });
+		    },
+		    // The instruction graph initializes reduction outputs explicitly and includes the current buffer value through a separate reduce_instruction
+		    [=](sycl::handler& cgh, const box<3>& execution_range, const std::vector<void*>& reduction_ptrs) {
+			    launch(cgh, execution_range.get_subrange(), reduction_ptrs, false /* is_reduction_initializer */);
+		    },
 		};
 
-		return std::make_unique<detail::command_launcher_storage<decltype(fn)>>(std::move(fn));
+		return detail::make_unique_in<detail::command_launcher_storage<decltype(fn)>>(m_task_storage, std::move(fn));
 	}
 
 	template <int Dims, bool Collective, typename Kernel>
@@ -589,52 +605,66 @@ class handler {
 			detail::cgf_diagnostics::get_instance().check<target::host_task>(kernel, m_access_map, m_non_void_side_effects_count);
 		}
 
-		auto fn = [kernel, cgid, global_range](detail::host_queue& q, const subrange<3>& execution_sr) {
-			auto hydrated_kernel = detail::closure_hydrator::get_instance().hydrate<target::host_task>(kernel);
-			return q.submit(cgid, [hydrated_kernel, global_range, execution_sr](MPI_Comm comm) {
-				(void)global_range;
-				if constexpr(Dims > 0) {
-					if constexpr(Collective) {
-						static_assert(Dims == 1);
-						const auto part = detail::make_collective_partition(detail::range_cast<1>(global_range), detail::subrange_cast<1>(execution_sr), comm);
-						hydrated_kernel(part);
-					} else {
-						const auto part = detail::make_partition<Dims>(detail::range_cast<Dims>(global_range), detail::subrange_cast<Dims>(execution_sr));
-						hydrated_kernel(part);
-					}
-				} else if constexpr(std::is_invocable_v<Kernel, const partition<0>&>) {
-					(void)execution_sr;
-					const auto part = detail::make_0d_partition();
+		const auto run_kernel = [global_range](auto& hydrated_kernel, const subrange<3>& execution_sr, MPI_Comm comm) {
+			(void)global_range;
+			(void)comm;
+			if constexpr(Dims > 0) {
+				if constexpr(Collective) {
+					static_assert(Dims == 1);
+					const auto part = detail::make_collective_partition(detail::range_cast<1>(global_range), detail::subrange_cast<1>(execution_sr), comm);
 					hydrated_kernel(part);
 				} else {
-					(void)execution_sr;
-					hydrated_kernel();
+					const auto part = detail::make_partition<Dims>(detail::range_cast<Dims>(global_range), detail::subrange_cast<Dims>(execution_sr));
+					hydrated_kernel(part);
 				}
-			});
+			} else if constexpr(std::is_invocable_v<Kernel, const partition<0>&>) {
+				(void)execution_sr;
+				const auto part = detail::make_0d_partition();
+				hydrated_kernel(part);
+			} else {
+				(void)execution_sr;
+				hydrated_kernel();
+			}
 		};
 
-		return std::make_unique<detail::command_launcher_storage<decltype(fn)>>(std::move(fn));
+		auto fn = detail::launcher_overload_set{
+		    [kernel, cgid, run_kernel](detail::host_queue& q, const subrange<3>& execution_sr) {
+			    auto hydrated_kernel = detail::closure_hydrator::get_instance().hydrate<target::host_task>(kernel);
+			    return q.submit(cgid, [hydrated_kernel, run_kernel, execution_sr](MPI_Comm comm) { run_kernel(hydrated_kernel, execution_sr, comm); });
+		    },
+		    [kernel, run_kernel](const box<3>& execution_range, MPI_Comm comm) {
+			    auto hydrated_kernel = detail::closure_hydrator::get_instance().hydrate<target::host_task>(kernel);
+			    run_kernel(hydrated_kernel, execution_range.get_subrange(), comm);
+		    },
+		};
+
+		return detail::make_unique_in<detail::command_launcher_storage<decltype(fn)>>(m_task_storage, std::move(fn));
 	}
 
-	std::unique_ptr<detail::task> into_task() && {
-		assert(m_task != nullptr);
-		for(auto state : m_attached_state) {
+	detail::task into_task() && {
+		assert(m_task.has_value());
+		for(auto& state : m_attached_state) {
 			m_task->extend_lifetime(std::move(state));
 		}
 		for(auto& h : m_hints) {
 			m_task->add_hint(std::move(h));
 		}
-		return std::move(m_task);
+		return std::move(*m_task);
 	}
 };
 
 namespace detail {
 
-	inline handler make_command_group_handler(const detail::task_id tid, const size_t num_collective_nodes) { return handler(tid, num_collective_nodes); }
+	/// If `task_storage` is non-null, range mappers of the task are constructed in that arena, which must outlive the task.
+	inline handler make_command_group_handler(const detail::task_id tid, const size_t num_collective_nodes, detail::arena* const task_storage = nullptr) {
+		return handler(tid, num_collective_nodes, task_storage);
+	}
+
+	inline detail::task into_task(handler&& cgh) { return std::move(cgh).into_task(); }
 
-	inline std::unique_ptr<detail::task> into_task(handler&& cgh) { return std::move(cgh).into_task(); }
+	inline arena* get_task_storage(handler& cgh) { return cgh.m_task_storage; }
 
-	[[nodiscard]] inline hydration_id add_requirement(handler& cgh, const buffer_id bid, std::unique_ptr<range_mapper_base> rm) {
+	[[nodiscard]] inline hydration_id add_requirement(handler& cgh, const buffer_id bid, unique_range_mapper_ptr rm) {
 		return cgh.add_requirement(bid, std::move(rm));
 	}
 
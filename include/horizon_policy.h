@@ -0,0 +1,73 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+
+namespace celerity::detail {
+
+/// Runtime state sampled by the task_manager whenever it generates a horizon.
+struct horizon_feedback {
+	size_t horizons_in_flight = 0; ///< horizons generated but not yet reached by the executor, i.e. how far execution lags behind submission
+	size_t live_tasks = 0;         ///< tasks that have not yet been pruned from the task graph
+	size_t region_map_entries = 0; ///< total number of entries in the last-writer region maps of all buffers
+};
+
+enum class horizon_step_adjustment {
+	keep,   ///< execution lags behind, but the tracked structures are still within their limits
+	grow,   ///< execution keeps up with submission and tracked structures are small, so horizons are pure overhead
+	shrink, ///< the task window or the region maps exceed their limits and need to be pruned more often
+};
+
+/// The outcome of one evaluation of the adaptive horizon policy. Attached to the task_record of the horizon that triggered it.
+struct horizon_decision {
+	int previous_step = 0;
+	int step = 0;
+	horizon_step_adjustment adjustment = horizon_step_adjustment::keep;
+	horizon_feedback feedback;
+};
+
+/// Tunes the horizon step (the critical path length between two consecutive horizons) at run time.
+///
+/// Horizons bound the size of the task, command and instruction graphs as well as the fragmentation of region maps, but every horizon costs a task, one
+/// command per node and a set of instructions. Fine-grained loops that the executor keeps up with pay that cost too often with a small static step,
+/// while coarse loops that fragment region maps need horizons more frequently than a large static step provides. The policy doubles the step as long as
+/// the executor has reached the previous horizon and the task window and region maps stay well below their limits, and halves it whenever one of those
+/// structures exceeds its limit. Command and instruction graphs are pruned along with the task graph, so the task window stands in for their sizes.
+class adaptive_horizon_policy {
+  public:
+	struct limits {
+		int min_step = 2;
+		int max_step = 256;
+		size_t max_live_tasks = 4096;
+		size_t max_region_map_entries = 16384;
+		size_t max_horizons_in_flight_for_growth = 1;
+	};
+
+	explicit adaptive_horizon_policy(const int initial_step) : adaptive_horizon_policy(initial_step, limits{}) {}
+
+	adaptive_horizon_policy(const int initial_step, const limits& lim) : m_limits(lim), m_step(std::clamp(initial_step, lim.min_step, lim.max_step)) {}
+
+	int get_step() const { return m_step; }
+
+	/// Called after a horizon has been generated; returns the step size to use until the next one.
+	horizon_decision evaluate(const horizon_feedback& fb) {
+		const auto previous_step = m_step;
+		auto adjustment = horizon_step_adjustment::keep;
+		if(fb.live_tasks > m_limits.max_live_tasks || fb.region_map_entries > m_limits.max_region_map_entries) {
+			adjustment = horizon_step_adjustment::shrink;
+			m_step = std::max(m_limits.min_step, m_step / 2);
+		} else if(fb.horizons_in_flight <= m_limits.max_horizons_in_flight_for_growth && fb.live_tasks <= m_limits.max_live_tasks / 2
+		          && fb.region_map_entries <= m_limits.max_region_map_entries / 2) {
+			// only grow with ample headroom to avoid oscillating around a limit
+			adjustment = horizon_step_adjustment::grow;
+			m_step = std::min(m_limits.max_step, m_step * 2);
+		}
+		return horizon_decision{previous_step, m_step, adjustment, fb};
+	}
+
+  private:
+	limits m_limits;
+	int m_step;
+};
+
+} // namespace celerity::detail
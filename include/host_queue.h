@@ -9,10 +9,12 @@
 #include <ctpl_stl.h>
 #include <mpi.h>
 
+#include "affinity.h"
 #include "config.h"
 #include "log.h"
 #include "named_threads.h"
 #include "types.h"
+#include "work_stealing_pool.h"
 
 namespace celerity {
 
@@ -102,6 +104,11 @@ namespace detail {
 
 	/**
 	 * The @p host_queue provides a thread pool to submit host tasks.
+	 *
+	 * Non-collective host tasks run on a work-stealing pool with one worker per core not reserved for the runtime's own threads. Each collective group
+	 * is served by a dedicated thread, so collective host tasks are executed in submission order.
+	 *
+	 * When multiple processes share a host, each one only pins its threads to its own share of the cores (see `assign_cores`).
 	 */
 	class host_queue {
 	  public:
@@ -113,19 +120,65 @@ namespace detail {
 			time_point end_time{};
 		};
 
-		host_queue() {
-			// TODO what is a good thread count for the non-collective thread pool?
-			m_threads.emplace(std::piecewise_construct, std::tuple{0}, std::tuple{MPI_COMM_NULL, 4, m_id++});
+		/// Cores kept free of workers for the scheduler and executor threads, and for the application's main thread that submits work to them.
+		constexpr static uint32_t num_runtime_threads = 3;
+
+		/// The previous fixed-size pool had 4 threads - keep at least as many to not regress on machines with few cores.
+		constexpr static size_t min_pool_workers = 4;
+
+		/// Logical cores that threads of this process are pinned to. Both vectors are empty if threads should not be pinned.
+		struct core_assignment {
+			std::vector<uint32_t> runtime_cores; ///< shared by the scheduler and executor thread, without workers competing for them
+			std::vector<uint32_t> worker_cores;  ///< one core per work-stealing pool worker
+		};
+
+		/// Distributes the cores in this process' affinity mask `core_ids` between runtime threads and pool workers.
+		///
+		/// If the mask covers all `num_host_cores` cores, nobody has bound this process to a part of the host (e.g. through the MPI launcher). In that case
+		/// the cores are split evenly between the `num_local_ranks` processes on the host, so that they do not pin their threads to the same cores.
+		/// Threads are only pinned if the resulting share has room for one core per runtime thread and `min_pool_workers` workers.
+		static core_assignment assign_cores(std::vector<uint32_t> core_ids, const size_t num_host_cores, const size_t num_local_ranks, const size_t local_rank) {
+			assert(local_rank < num_local_ranks);
+			if(num_local_ranks > 1 && core_ids.size() >= num_host_cores) {
+				const auto first = core_ids.size() * local_rank / num_local_ranks;
+				const auto last = core_ids.size() * (local_rank + 1) / num_local_ranks;
+				core_ids = std::vector<uint32_t>(core_ids.begin() + static_cast<ptrdiff_t>(first), core_ids.begin() + static_cast<ptrdiff_t>(last));
+			}
+
+			// Leave the lowest cores to the runtime threads and pin one worker to each remaining core. If there are not enough cores to go around,
+			// oversubscribe and let the operating system schedule all threads instead.
+			core_assignment assignment;
+			if(core_ids.size() >= num_runtime_threads + min_pool_workers) {
+				assignment.runtime_cores.assign(core_ids.begin(), core_ids.begin() + num_runtime_threads);
+				assignment.worker_cores.assign(core_ids.begin() + num_runtime_threads, core_ids.end());
+			}
+			return assignment;
+		}
+
+		/// Assumes that this is the only process on the host.
+		host_queue() : host_queue(assign_cores(available_core_ids(), std::thread::hardware_concurrency(), 1, 0)) {}
+
+		/// Assigns the cores available to this process after splitting them with the other `num_local_ranks` processes on the host.
+		host_queue(const size_t num_local_ranks, const size_t local_rank)
+		    : host_queue(assign_cores(available_core_ids(), std::thread::hardware_concurrency(), num_local_ranks, local_rank)) {}
+
+		explicit host_queue(core_assignment cores) : m_cores(std::move(cores)) {
+			const auto num_workers = m_cores.worker_cores.empty() ? min_pool_workers : m_cores.worker_cores.size();
+			m_pool = std::make_unique<work_stealing_pool>(num_workers, fmt::format("cy-worker-{}", m_id++), m_cores.worker_cores);
 		}
 
+		/// The runtime pins its own threads to `runtime_cores`, and threads executing host tasks outside of this queue to `worker_cores`.
+		const core_assignment& get_core_assignment() const { return m_cores; }
+
 		void require_collective_group(collective_group_id cgid) {
+			if(cgid == collective_group_id{0}) return; // served by the work-stealing pool
+
 			const std::lock_guard lock(m_mutex); // called by main thread
 			if(m_threads.count(cgid) > 0) return;
 
-			assert(cgid != 0);
 			MPI_Comm comm;
 			MPI_Comm_dup(MPI_COMM_WORLD, &comm);
-			m_threads.emplace(std::piecewise_construct, std::tuple{cgid}, std::tuple{comm, 1, m_id++});
+			m_threads.emplace(std::piecewise_construct, std::tuple{cgid}, std::tuple{comm, 1, m_id++, m_cores.worker_cores});
 		}
 
 		template <typename Fn>
@@ -135,24 +188,23 @@ namespace detail {
 
 		template <typename Fn>
 		std::future<execution_info> submit(collective_group_id cgid, Fn&& fn) {
+			if(cgid == collective_group_id{0}) {
+				std::packaged_task<execution_info()> task(make_job(MPI_COMM_NULL, std::forward<Fn>(fn)));
+				auto future = task.get_future();
+				m_pool->submit(work_stealing_pool::job(std::move(task)));
+				return future;
+			}
+
 			const std::lock_guard lock(m_mutex); // called by executor thread
 			auto& [comm, pool] = m_threads.at(cgid);
-			return pool.push([fn = std::forward<Fn>(fn), submit_time = std::chrono::steady_clock::now(), comm = comm](int) {
-				auto start_time = std::chrono::steady_clock::now();
-				try {
-					fn(comm);
-				} catch(std::exception& e) { CELERITY_ERROR("exception in thread pool: {}", e.what()); } catch(...) {
-					CELERITY_ERROR("unknown exception in thread pool");
-				}
-				auto end_time = std::chrono::steady_clock::now();
-				return execution_info{submit_time, start_time, end_time};
-			});
+			return pool.push([job = make_job(comm, std::forward<Fn>(fn))](int) { return job(); });
 		}
 
 		/**
 		 * @brief Waits until all currently submitted operations have completed.
 		 */
 		void wait() {
+			m_pool->stop();
 			const std::lock_guard lock(m_mutex); // called by main thread - never contended because the executor is shut down at this point
 			for(auto& [_, ct] : m_threads) {
 				ct.pool.stop(true /* isWait */);
@@ -164,17 +216,45 @@ namespace detail {
 			MPI_Comm comm;
 			ctpl::thread_pool pool;
 
-			comm_thread(MPI_Comm comm, size_t n_threads, size_t id) : comm(comm), pool(n_threads) {
+			comm_thread(MPI_Comm comm, size_t n_threads, size_t id, const std::vector<uint32_t>& core_ids) : comm(comm), pool(n_threads) {
 				for(size_t i = 0; i < n_threads; ++i) {
 					auto& worker = pool.get_thread(i);
 					set_thread_name(worker.native_handle(), fmt::format("cy-worker-{}.{}", id, i));
+#ifndef __APPLE__
+					// Collective groups are created from the main thread, whose affinity the new thread would otherwise inherit
+					if(!core_ids.empty()) { set_thread_affinity(worker.native_handle(), core_ids); }
+#endif
 				}
 			}
 		};
 
+		core_assignment m_cores;
+		std::unique_ptr<work_stealing_pool> m_pool;
 		std::mutex m_mutex;
 		std::unordered_map<collective_group_id, comm_thread> m_threads;
 		size_t m_id = 0;
+
+		static std::vector<uint32_t> available_core_ids() {
+#ifndef __APPLE__
+			return affinity_core_ids();
+#else
+			return {};
+#endif
+		}
+
+		template <typename Fn>
+		static auto make_job(MPI_Comm comm, Fn&& fn) {
+			return [fn = std::forward<Fn>(fn), submit_time = std::chrono::steady_clock::now(), comm]() {
+				auto start_time = std::chrono::steady_clock::now();
+				try {
+					fn(comm);
+				} catch(std::exception& e) { CELERITY_ERROR("exception in thread pool: {}", e.what()); } catch(...) {
+					CELERITY_ERROR("unknown exception in thread pool");
+				}
+				auto end_time = std::chrono::steady_clock::now();
+				return execution_info{submit_time, start_time, end_time};
+			};
+		}
 	};
 
 } // namespace detail
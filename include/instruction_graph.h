@@ -1,13 +1,17 @@
 #pragma once
 
+#include "arena.h"
 #include "grid.h"
 #include "launcher.h"
 #include "ranges.h"
 #include "types.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstdlib>
+#include <deque>
 #include <memory>
+#include <numeric>
 #include <vector>
 
 #include <gch/small_vector.hpp>
@@ -23,9 +27,9 @@ class fence_promise;
 class instruction
     // Accept visitors to enable matchbox::match() on the instruction inheritance hierarchy
     : public matchbox::acceptor<class clone_collective_group_instruction, class alloc_instruction, class free_instruction, class copy_instruction,
-          class device_kernel_instruction, class host_task_instruction, class send_instruction, class receive_instruction, class split_receive_instruction,
-          class await_receive_instruction, class gather_receive_instruction, class fill_identity_instruction, class reduce_instruction, class fence_instruction,
-          class destroy_host_object_instruction, class horizon_instruction, class epoch_instruction> {
+          class device_kernel_instruction, class host_task_instruction, class linearize_instruction, class send_instruction, class receive_instruction,
+          class split_receive_instruction, class await_receive_instruction, class gather_receive_instruction, class fill_identity_instruction,
+          class reduce_instruction, class fence_instruction, class destroy_host_object_instruction, class horizon_instruction, class epoch_instruction> {
   public:
 	using edge_set = gch::small_vector<instruction_id>;
 
@@ -36,6 +40,14 @@ class instruction
 	instruction_id get_id() const { return m_id; }
 	int get_priority() const { return m_priority; }
 
+	/// Called by the instruction_graph_generator once the critical path through the batch of the instruction is known.
+	void set_priority(const int priority) { m_priority = priority; }
+
+	/// The run time of this instruction as predicted by the `cost_model` of the instruction_graph_generator, or zero if the instruction was not generated by it.
+	std::chrono::nanoseconds get_estimated_duration() const { return m_estimated_duration; }
+
+	void set_estimated_duration(const std::chrono::nanoseconds duration) { m_estimated_duration = duration; }
+
 	const edge_set& get_dependencies() const { return m_dependencies; }
 
 	void add_dependency(const instruction_id iid) {
@@ -48,6 +60,7 @@ class instruction
   private:
 	instruction_id m_id;
 	int m_priority;
+	std::chrono::nanoseconds m_estimated_duration{0};
 	edge_set m_dependencies;
 };
 
@@ -76,17 +89,23 @@ class clone_collective_group_instruction : public matchbox::implement_acceptor<i
 /// Allocates a contiguous range of memory, either for use as a backing allocation for a buffer or for other purposes i.e. staging for transfer operations.
 class alloc_instruction final : public matchbox::implement_acceptor<instruction, alloc_instruction> {
   public:
-	explicit alloc_instruction(const instruction_id iid, const int priority, const allocation_id aid, const size_t size, const size_t alignment)
-	    : acceptor_base(iid, priority), m_aid(aid), m_size(size), m_alignment(alignment) {}
+	explicit alloc_instruction(
+	    const instruction_id iid, const int priority, const allocation_id aid, const size_t size, const size_t alignment, const bool is_staging = false)
+	    : acceptor_base(iid, priority), m_aid(aid), m_size(size), m_alignment(alignment), m_is_staging(is_staging) {}
 
 	allocation_id get_allocation_id() const { return m_aid; }
 	size_t get_size_bytes() const { return m_size; }
 	size_t get_alignment_bytes() const { return m_alignment; }
 
+	/// Staging allocations are short-lived host buffers that only serve a single transfer. The executor recycles them like the destinations of
+	/// `linearize_instruction`s instead of returning them to the system on every free.
+	bool is_staging() const { return m_is_staging; }
+
   private:
 	allocation_id m_aid;
 	size_t m_size;
 	size_t m_alignment;
+	bool m_is_staging;
 };
 
 /// Returns an allocation made with alloc_instruction to the system.
@@ -215,6 +234,33 @@ class host_task_instruction final : public matchbox::implement_acceptor<instruct
 #endif
 };
 
+/// Packs a strided subrange of a host allocation densely into a staging allocation, so that a subsequent send_instruction can transmit it as a contiguous
+/// message. Instead of being allocated by an alloc_instruction, the staging allocation is taken from a pool of pinned host buffers owned by the executor and
+/// is returned to that pool by a regular free_instruction.
+class linearize_instruction final : public matchbox::implement_acceptor<instruction, linearize_instruction> {
+  public:
+	explicit linearize_instruction(const instruction_id iid, const int priority, const allocation_id source_aid, const range<3>& source_alloc_range,
+	    const id<3>& offset_in_alloc, const range<3>& linearize_range, const size_t elem_size, const allocation_id staging_aid)
+	    : acceptor_base(iid, priority), m_source_aid(source_aid), m_source_range(source_alloc_range), m_offset_in_source(offset_in_alloc),
+	      m_linearize_range(linearize_range), m_elem_size(elem_size), m_staging_aid(staging_aid) {}
+
+	allocation_id get_source_allocation_id() const { return m_source_aid; }
+	const range<3>& get_source_allocation_range() const { return m_source_range; }
+	const id<3>& get_offset_in_source_allocation() const { return m_offset_in_source; }
+	const range<3>& get_linearize_range() const { return m_linearize_range; }
+	size_t get_element_size() const { return m_elem_size; }
+	allocation_id get_staging_allocation_id() const { return m_staging_aid; }
+	size_t get_staging_size_bytes() const { return m_linearize_range.size() * m_elem_size; }
+
+  private:
+	allocation_id m_source_aid;
+	range<3> m_source_range;
+	id<3> m_offset_in_source;
+	range<3> m_linearize_range;
+	size_t m_elem_size;
+	allocation_id m_staging_aid;
+};
+
 /// (MPI_) sends a subrange of an allocation to a single remote node. The send must have be announced by transmitting a pilot_message first.
 class send_instruction final : public matchbox::implement_acceptor<instruction, send_instruction> {
   public:
@@ -427,25 +473,32 @@ class instruction_graph {
 	// Call this before pushing horizon or epoch instruction in order to be able to call erase_before_epoch on the same task id later.
 	void begin_epoch(const task_id tid) {
 		assert(m_epochs.empty() || (m_epochs.back().epoch_tid < tid && !m_epochs.back().instructions.empty()));
-		m_epochs.push_back({tid, {}});
+		m_epochs.push_back(instruction_epoch{tid, arena(), {}});
 	}
 
-	// Add an instruction to the current epoch. Its instruction id must be higher than any instruction inserted into the graph before.
-	void push_instruction(std::unique_ptr<instruction> instr) {
+	// Construct an instruction in the current epoch. Its instruction id must be higher than any instruction inserted into the graph before.
+	template <typename Instruction, typename... CtorParams>
+	Instruction* create_instruction(CtorParams&&... ctor_args) {
 		assert(!m_epochs.empty());
-		auto& instructions = m_epochs.back().instructions;
-		assert(instructions.empty() || instruction_id_less{}(instructions.back().get(), instr.get()));
-		instructions.push_back(std::move(instr));
+		auto& epoch = m_epochs.back();
+		const auto instr = epoch.storage.create<Instruction>(std::forward<CtorParams>(ctor_args)...);
+		assert(epoch.instructions.empty() || instruction_id_less{}(epoch.instructions.back().get(), instr));
+		epoch.instructions.emplace_back(instr);
+		return instr;
 	}
 
 	// Free all instructions that were pushed before begin_epoch(tid) was called.
 	void prune_before_epoch(const task_id tid) {
-		const auto first_retained =
-		    std::partition_point(m_epochs.begin(), m_epochs.end(), [=](const instruction_epoch& epoch) { return epoch.epoch_tid < tid; });
-		assert(first_retained != m_epochs.end() && first_retained->epoch_tid == tid);
-		m_epochs.erase(m_epochs.begin(), first_retained);
+		assert(std::any_of(m_epochs.begin(), m_epochs.end(), [=](const instruction_epoch& epoch) { return epoch.epoch_tid == tid; }));
+		// Epochs are only ever destroyed in place: Move-assigning over a pruned epoch would release its arena before destroying its instructions.
+		while(m_epochs.front().epoch_tid < tid) {
+			m_epochs.pop_front();
+		}
 	}
 
+	// The number of epochs (and horizons) whose instructions have not been pruned yet.
+	size_t get_live_epoch_count() const { return m_epochs.size(); }
+
 	// The total number of instructions currently owned and not yet pruned, across all epochs.
 	size_t get_live_instruction_count() const {
 		return std::accumulate(
@@ -453,12 +506,15 @@ class instruction_graph {
 	}
 
   private:
+	// Instructions of an epoch are allocated from a common arena, so that pruning an epoch releases all of its memory at once instead of freeing
+	// instructions one by one. Instruction pointers are stable, so it is safe to hand them to another thread.
 	struct instruction_epoch {
 		task_id epoch_tid;
-		std::vector<std::unique_ptr<instruction>> instructions; // instruction pointers are stable, so it is safe to hand them to another thread
+		arena storage; // declared before `instructions` so that instructions are destroyed before their memory is released
+		std::vector<std::unique_ptr<instruction, arena_destroyer>> instructions;
 	};
 
-	std::vector<instruction_epoch> m_epochs;
+	std::deque<instruction_epoch> m_epochs;
 };
 
 } // namespace celerity::detail
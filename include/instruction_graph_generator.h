@@ -10,6 +10,7 @@
 namespace celerity::detail {
 
 class abstract_command;
+class cost_model;
 class instruction;
 class instruction_graph;
 class instruction_recorder;
@@ -56,7 +57,8 @@ class instruction_graph_generator {
 		virtual void flush_instructions(std::vector<const instruction*> instrs) = 0;
 
 		/// Called whenever new pilot messages have been generated that must be transmitted to peer nodes before they can accept data transmitted through
-		/// `send_instruction`s originating from the local node.
+		/// `send_instruction`s originating from the local node. All pilots of one instruction batch are passed in a single call, which allows the
+		/// communicator to coalesce pilots to the same peer into one message.
 		virtual void flush_outbound_pilots(std::vector<outbound_pilot> pilots) = 0;
 	};
 
@@ -74,6 +76,16 @@ class instruction_graph_generator {
 		error_policy overlapping_write_error = error_policy::panic;
 	};
 
+	/// Size of the tracking structures the generator maintains between calls to `compile`. These are bounded by horizons and epochs, which collapse the
+	/// access fronts and let region maps merge adjacent entries.
+	struct state_statistics {
+		size_t num_buffers = 0;
+		size_t num_allocations = 0;
+		size_t num_region_map_entries = 0;        ///< across last-writer, access-front, coherence and original-writer maps of all buffers
+		size_t num_access_front_instructions = 0; ///< sum of the sizes of all access fronts
+		size_t approximate_bytes = 0;             ///< lower bound on the memory held by region map entries, ignoring tree nodes and spilled access fronts
+	};
+
 	/// Instruction graph generation requires information about the target system. `num_nodes` and `local_nid` affect the generation of communication
 	/// instructions and reductions, and `system` is used to determine work assignment, memory allocation and data migration between memories.
 	///
@@ -86,8 +98,12 @@ class instruction_graph_generator {
 	/// Specify a non-default `policy` to influence what user-errors are detected at runtime and how they are reported. The default is is to throw exceptions
 	/// which catch errors early in tests, but users of this class will want to ease these settings. Any policy set to a value other than
 	/// `error_policy::ignore` will have a performance penalty.
+	///
+	/// Every instruction is annotated with its estimated duration from `costs`, which raises the priority of instructions on the critical path of each
+	/// command and lets the executor assign longer instructions first. If no cost model is provided, the generator uses a `static_cost_model` with default
+	/// parameters. A provided cost model must outlive the generator.
 	explicit instruction_graph_generator(const task_manager& tm, size_t num_nodes, node_id local_nid, const system_info& system, instruction_graph& idag,
-	    delegate* dlg = nullptr, instruction_recorder* recorder = nullptr, const policy_set& policy = default_policy_set());
+	    delegate* dlg = nullptr, instruction_recorder* recorder = nullptr, const policy_set& policy = default_policy_set(), const cost_model* costs = nullptr);
 
 	instruction_graph_generator(const instruction_graph_generator&) = delete;
 	instruction_graph_generator(instruction_graph_generator&&) = default;
@@ -115,9 +131,18 @@ class instruction_graph_generator {
 	/// End tracking the host object with id `hoid`. Emits `destroy_host_object_instruction` if `create_host_object` was called with `owns_instance == true`.
 	void notify_host_object_destroyed(host_object_id hoid);
 
+	/// Announces a command that will be passed to `compile` later, before the next horizon or epoch command. Anticipating all commands of a lookahead window
+	/// lets the generator size buffer allocations for their combined access pattern instead of growing and resize-copying them one command at a time. Calling
+	/// this is optional and does not change the semantics of the generated graph.
+	void anticipate(const abstract_command& cmd);
+
 	/// Compiles a command-graph node into a set of instructions, which are inserted into the shared instruction graph, and updates tracking structures.
 	void compile(const abstract_command& cmd);
 
+	/// Walks all tracking structures to determine their current size. Takes time linear in the number of region map entries, so this is intended for
+	/// diagnostics and benchmarks only.
+	state_statistics get_state_statistics() const;
+
   private:
 	/// Default-constructs a `policy_set` - this must be a function because we can't use the implicit default constructor of `policy_set`, which has member
 	/// initializers, within its surrounding class (Clang diagnostic).
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include "grid.h"
+#include "region_map.h"
+
+namespace celerity::detail {
+
+/**
+ * A one-dimensional counterpart to region_map that stores its values as a sorted list of runs.
+ *
+ * Each entry holds the value for all points from its own start up to the start of the next entry (or the end of the extent). Adjacent entries never hold
+ * the same value, so the number of entries equals the number of distinct runs. Updates and queries are logarithmic in the number of entries plus linear in
+ * the number of entries they touch, which beats the R-tree of region_map by a wide margin for the contiguous, mostly-ordered accesses typical of 1D buffers.
+ */
+template <typename ValueType>
+class interval_map {
+  public:
+	/**
+	 * @param extent All points in [0, extent) initially hold `default_value`. Updates and query results are clamped to this extent.
+	 */
+	explicit interval_map(const size_t extent, const ValueType& default_value = ValueType{}) : m_extent(extent) { m_entries.push_back({0, default_value}); }
+
+	/**
+	 * Sets a new value for all points in [begin, end).
+	 */
+	void update(const size_t begin, size_t end, const ValueType& value) {
+		end = std::min(end, m_extent);
+		if(begin >= end) return;
+
+		// [first, last) are the entries overlapping [begin, end)
+		auto first = static_cast<size_t>(std::upper_bound(m_entries.begin(), m_entries.end(), begin, starts_after) - m_entries.begin()) - 1;
+		auto last = static_cast<size_t>(std::lower_bound(m_entries.begin(), m_entries.end(), end, starts_before) - m_entries.begin());
+
+		entry replacement[2];
+		size_t num_replacements = 0;
+
+		// A head entry starting before `begin` is truncated implicitly by the new entry. If it (or its predecessor) already holds the new value, it is extended
+		// instead.
+		const bool keep_head = m_entries[first].start < begin;
+		const bool merge_head = keep_head ? m_entries[first].value == value : first > 0 && m_entries[first - 1].value == value;
+		if(!merge_head) { replacement[num_replacements++] = entry{begin, value}; }
+
+		// The entry overlapping `end` continues past the update, unless it is followed by an entry starting exactly at `end`.
+		if(end < m_extent && (last == m_entries.size() || m_entries[last].start != end)) {
+			const auto& tail_value = m_entries[last - 1].value;
+			if(!(tail_value == value)) { replacement[num_replacements++] = entry{end, tail_value}; }
+		} else if(last < m_entries.size() && m_entries[last].value == value) {
+			++last; // absorb the following entry
+		}
+
+		const auto erase_begin = keep_head ? first + 1 : first;
+		const auto num_erased = last - erase_begin;
+		const auto num_assigned = std::min(num_erased, num_replacements);
+		for(size_t i = 0; i < num_assigned; ++i) {
+			m_entries[erase_begin + i] = std::move(replacement[i]);
+		}
+		if(num_erased > num_assigned) {
+			m_entries.erase(m_entries.begin() + static_cast<ptrdiff_t>(erase_begin + num_assigned), m_entries.begin() + static_cast<ptrdiff_t>(last));
+		} else {
+			m_entries.insert(m_entries.begin() + static_cast<ptrdiff_t>(erase_begin + num_assigned), std::make_move_iterator(replacement + num_assigned),
+			    std::make_move_iterator(replacement + num_replacements));
+		}
+	}
+
+	/**
+	 * Invokes `f(begin, end, value)` for every run intersecting [begin, end), clamped to that interval and in ascending order.
+	 */
+	template <typename Functor>
+	void for_each_in(const size_t begin, size_t end, const Functor& f) const {
+		end = std::min(end, m_extent);
+		if(begin >= end) return;
+		auto i = static_cast<size_t>(std::upper_bound(m_entries.begin(), m_entries.end(), begin, starts_after) - m_entries.begin()) - 1;
+		for(; i < m_entries.size() && m_entries[i].start < end; ++i) {
+			const auto run_end = i + 1 < m_entries.size() ? m_entries[i + 1].start : m_extent;
+			f(std::max(begin, m_entries[i].start), std::min(end, run_end), m_entries[i].value);
+		}
+	}
+
+	/**
+	 * Applies a function f to every value within the interval map and stores the result in its place.
+	 */
+	template <typename Functor>
+	void apply_to_values(const Functor& f) {
+		static_assert(std::is_invocable_r_v<ValueType, Functor, const ValueType&>, "Functor must receive and return a value of type ValueType");
+		size_t num_merged = 0;
+		for(size_t i = 0; i < m_entries.size(); ++i) {
+			auto new_value = f(std::as_const(m_entries[i].value));
+			if(num_merged > 0 && m_entries[num_merged - 1].value == new_value) continue;
+			m_entries[num_merged++] = entry{m_entries[i].start, std::move(new_value)};
+		}
+		m_entries.erase(m_entries.begin() + static_cast<ptrdiff_t>(num_merged), m_entries.end());
+	}
+
+	size_t get_extent() const { return m_extent; }
+
+	size_t get_num_entries() const { return m_entries.size(); }
+
+  private:
+	struct entry {
+		size_t start = 0;
+		ValueType value{};
+	};
+
+	size_t m_extent;
+	std::vector<entry> m_entries; ///< sorted by start, never empty, m_entries.front().start == 0
+
+	static bool starts_after(const size_t pos, const entry& e) { return pos < e.start; }
+	static bool starts_before(const entry& e, const size_t pos) { return e.start < pos; }
+};
+
+/**
+ * Drop-in replacement for region_map which stores values in an interval_map whenever the extent has at most one effective dimension, and falls back to
+ * the R-tree based region_map for everything else.
+ */
+template <typename ValueType>
+class interval_or_region_map {
+  public:
+	interval_or_region_map(const range<3>& extent, const ValueType& default_value = ValueType{}) {
+		const auto extent_box = box(subrange<3>({}, extent));
+		if(extent_box.get_effective_dims() <= 1) {
+			m_map.template emplace<interval_map<ValueType>>(box_cast<1>(extent_box).get_range()[0], default_value);
+		} else {
+			m_map.template emplace<region_map<ValueType>>(extent, default_value);
+		}
+	}
+
+	/// Returns true if values are stored in an interval_map rather than a region_map.
+	bool is_interval_map() const { return std::holds_alternative<interval_map<ValueType>>(m_map); }
+
+	void update_region(const region<3>& region, const ValueType& value) {
+		for(const auto& box : region.get_boxes()) {
+			update_box(box, value);
+		}
+	}
+
+	void update_box(const box<3>& box, const ValueType& value) {
+		if(auto* const im = std::get_if<interval_map<ValueType>>(&m_map)) {
+			if(box.empty()) return;
+			assert(box.get_effective_dims() <= 1);
+			im->update(box.get_min()[0], box.get_max()[0], value);
+		} else {
+			std::get<region_map<ValueType>>(m_map).update_box(box, value);
+		}
+	}
+
+	/**
+	 * Returns all entries that intersect with the request region.
+	 *
+	 * @returns A list of boxes clamped to the request region, and their associated values.
+	 */
+	std::vector<std::pair<box<3>, ValueType>> get_region_values(const region<3>& request) const {
+		if(const auto* const im = std::get_if<interval_map<ValueType>>(&m_map)) {
+			std::vector<std::pair<box<3>, ValueType>> results;
+			for(const auto& box : request.get_boxes()) {
+				assert(box.get_effective_dims() <= 1);
+				im->for_each_in(box.get_min()[0], box.get_max()[0], [&](const size_t begin, const size_t end, const ValueType& value) {
+					results.emplace_back(detail::box<3>({begin, 0, 0}, {end, 1, 1}), value);
+				});
+			}
+			return results;
+		}
+		return std::get<region_map<ValueType>>(m_map).get_region_values(request);
+	}
+
+	template <typename Functor>
+	void apply_to_values(const Functor& f) {
+		if(auto* const im = std::get_if<interval_map<ValueType>>(&m_map)) return im->apply_to_values(f);
+		std::get<region_map<ValueType>>(m_map).apply_to_values(f);
+	}
+
+	size_t get_num_entries() const {
+		if(const auto* const im = std::get_if<interval_map<ValueType>>(&m_map)) return im->get_num_entries();
+		return std::get<region_map<ValueType>>(m_map).get_num_entries();
+	}
+
+  private:
+	std::variant<std::monostate, interval_map<ValueType>, region_map<ValueType>> m_map;
+};
+
+} // namespace celerity::detail
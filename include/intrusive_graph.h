@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <optional>
 #include <type_traits>
 
@@ -57,6 +58,14 @@ namespace detail {
 	  public:
 		intrusive_graph_node() { static_assert(std::is_base_of_v<intrusive_graph_node<T>, T>, "T must be child class (CRTP)"); }
 
+		// Nodes are referenced by address from their neighbors, so they can only be moved before being connected to any other node
+		intrusive_graph_node(intrusive_graph_node&& other) noexcept : m_pseudo_critical_path_length(other.m_pseudo_critical_path_length) {
+			assert(other.m_dependencies.empty() && other.m_dependents.empty());
+		}
+		intrusive_graph_node(const intrusive_graph_node&) = delete;
+		intrusive_graph_node& operator=(const intrusive_graph_node&) = delete;
+		intrusive_graph_node& operator=(intrusive_graph_node&&) = delete;
+
 	  protected:
 		~intrusive_graph_node() { // protected: Statically disallow destruction through base pointer, since dtor is not polymorphic
 			for(auto& dep : m_dependents) {
@@ -129,11 +138,14 @@ namespace detail {
 		int get_pseudo_critical_path_length() const { return m_pseudo_critical_path_length; }
 
 	  private:
-		gch::small_vector<dependency> m_dependencies;
+		// Most nodes only have a handful of dependencies and dependents, which we store inline to avoid a heap allocation per list in the common case.
+		constexpr static size_t inline_edge_capacity = 4;
+
+		gch::small_vector<dependency, inline_edge_capacity> m_dependencies;
 
 		// TODO This variable can be modified even after a DAG node is final, which easily leads to data races when a DAG is created by one thread and read /
 		// processed by another. Remove this member altogether after refactoring TDAG / CDAG generation to work without it.
-		gch::small_vector<dependent> m_dependents;
+		gch::small_vector<dependent, inline_edge_capacity> m_dependents;
 
 		// This only (potentially) grows when adding dependencies,
 		// it never shrinks and does not take into account later changes further up in the dependency chain
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "instruction_graph_generator.h"
+#include "types.h"
+
+#include <memory>
+#include <vector>
+
+#include <CL/sycl.hpp>
+
+namespace celerity::detail::live_executor_detail {
+struct executor_impl;
+}
+
+namespace celerity::detail {
+
+class communicator;
+class cost_model;
+class instruction;
+class reduction_manager;
+struct outbound_pilot;
+struct system_info;
+
+/// Executes the instruction graph on the local node as it is being generated.
+///
+/// Instructions and pilots are passed in from the scheduler thread through the `instruction_graph_generator::delegate` interface and are dispatched from a
+/// dedicated executor thread in the order determined by `out_of_order_engine`. Host tasks and host-to-host copies run on in-order worker threads (one per
+/// engine lane), device kernels and device copies are submitted to in-order SYCL queues (one per device and lane), and peer-to-peer transfers are handled
+/// by a `communicator` and `receive_arbiter`.
+class live_executor final : public instruction_graph_generator::delegate {
+  public:
+	/// Implement this as the owner of live_executor to receive callbacks on reached horizons and epochs. Callbacks are invoked from the executor thread.
+	class delegate {
+	  protected:
+		delegate() = default;
+		delegate(const delegate&) = default;
+		delegate(delegate&&) = default;
+		delegate& operator=(const delegate&) = default;
+		delegate& operator=(delegate&&) = default;
+		~delegate() = default; // do not allow destruction through base pointer
+
+	  public:
+		/// Called once all instructions preceding the horizon instruction for `tid` have completed.
+		virtual void horizon_reached(task_id tid) = 0;
+
+		/// Called once all instructions preceding the epoch instruction for `tid` have completed (and, for barrier epochs, all nodes have arrived).
+		virtual void epoch_reached(task_id tid) = 0;
+	};
+
+	/// `devices[did]` is the SYCL device for device id `did` in `system`. `root_comm` carries pilots and payloads between nodes and is the origin for
+	/// cloning collective groups. Allocations and copies are only dispatched for memories listed in `system`. If `costs` is non-null, it observes the
+	/// time between dispatch and completion of every instruction. If `host_core_ids` is non-empty, the threads executing host tasks and host copies are
+	/// confined to these cores instead of inheriting the affinity of the executor thread that spawns them.
+	explicit live_executor(const system_info& system, std::vector<sycl::device> devices, std::unique_ptr<communicator> root_comm,
+	    reduction_manager& reduction_mngr, delegate* dlg, cost_model* costs = nullptr, std::vector<uint32_t> host_core_ids = {});
+
+	live_executor(const live_executor&) = delete;
+	live_executor(live_executor&&) = delete;
+	live_executor& operator=(const live_executor&) = delete;
+	live_executor& operator=(live_executor&&) = delete;
+
+	~live_executor();
+
+	void startup();
+
+	/// Only valid between startup() and shutdown().
+	std::thread::native_handle_type get_thread_handle();
+
+	/// Makes a user-owned allocation (host-initialization data or a fence snapshot) known to the executor. Must be called before passing on the first
+	/// instruction referencing `aid`. The executor forgets about the pointer once `aid` appears in the garbage list of a horizon or epoch instruction.
+	void announce_user_allocation(allocation_id aid, void* ptr);
+
+	void flush_instructions(std::vector<const instruction*> instrs) override;
+
+	void flush_outbound_pilots(std::vector<outbound_pilot> pilots) override;
+
+	/// Waits until the shutdown epoch has been executed and all backend resources have been released.
+	void shutdown();
+
+  private:
+	std::unique_ptr<live_executor_detail::executor_impl> m_impl;
+};
+
+} // namespace celerity::detail
@@ -2,12 +2,18 @@
 
 #include "communicator.h"
 
+#include <list>
 #include <memory>
 #include <unordered_map>
 #include <vector>
 
 #include <mpi.h>
 
+namespace celerity::detail::mpi_detail {
+class recurring_operation;
+MPI_Comm duplicate_with_hints(MPI_Comm comm, bool exact_length, bool allow_overtaking);
+} // namespace celerity::detail::mpi_detail
+
 namespace celerity::detail {
 
 /// Constructor tag for mpi_communicator
@@ -17,10 +23,57 @@ struct collective_clone_from_tag {
 /// MPI implementation of the `communicator` interface.
 ///
 /// Wraps an `MPI_Comm`, manages strided MPI datatypes for sends / receives and optionally maintains an inbound / outbound queue of pilot messages.
+///
+/// Pilots are exchanged on a separate duplicate of the wrapped communicator. Payloads always match the size of their receive exactly, so the payload
+/// communicator carries the `mpi_assert_exact_length` hint, while coalesced pilots are received into buffers of the maximum message size and cannot.
+/// Conversely, only the pilot communicator carries `mpi_assert_allow_overtaking`, since recurring payloads rely on MPI's non-overtaking guarantee.
+///
+/// All pilots sent to the same peer in one call to `send_outbound_pilots` are coalesced into a single variable-length message. On the receiving side,
+/// several receives are kept pre-posted so that a burst of pilot messages from different peers does not need one poll round-trip per message.
+///
+/// Committed subarray datatypes are cached by their normalized stride. The cache holds at most `max_cached_array_types` entries and frees the least-recently
+/// used datatype when it overflows, which keeps the number of committed types bounded for applications whose transfer shapes change over time. MPI defers
+/// the actual deallocation of a freed type until all pending operations using it have completed.
+///
+/// Payloads with a recurring message id (see `is_recurring_message_id`) are transferred through persistent requests, which are bound once per peer, message
+/// id, base pointer and stride and then re-started with `MPI_Start` for every repetition, skipping tag matching setup and datatype lookup. Each channel keeps
+/// the last few requests bound, so that transfers alternating between a small set of (e.g. pooled staging) buffers keep re-starting them. Transfers on the
+/// same peer and recurring message id are started in the order of their submission, each one after its predecessor has completed. A standard-mode send can
+/// complete before the receiver has matched it, so several messages of one channel may be pending at the receiver, but since the payload communicator does
+/// not allow messages with the same tag to overtake each other, every send is still matched with its receive without a synchronous-mode rendezvous.
 class mpi_communicator final : public communicator {
   public:
+	/// Hit / miss counters of the subarray datatype cache. Lookups for zero-dimensional transfers resolve to a scalar type and are not counted.
+	struct datatype_cache_metrics {
+		size_t hits = 0;
+		size_t misses = 0;
+		size_t evictions = 0;
+		size_t num_cached_types = 0;
+	};
+
+	/// Counters of transfers with recurring message ids.
+	struct persistent_request_metrics {
+		size_t num_created = 0;   ///< persistent requests initialized for a base pointer and stride that none of the channel's bound requests matched
+		size_t num_restarted = 0; ///< transfers that re-started an existing persistent request
+	};
+
+	/// Upper bound on the number of pilots coalesced into one message, which determines the size of each pre-posted receive buffer.
+	constexpr static size_t max_pilots_per_message = 64;
+
+	/// Number of pilot receives that are kept in flight once poll_inbound_pilots() has been called.
+	constexpr static size_t num_pre_posted_pilot_receives = 4;
+
+	/// Default upper bound on the number of subarray datatypes kept committed at any time.
+	constexpr static size_t default_max_cached_array_types = 256;
+
+	/// Upper bound on the number of (direction, peer, recurring message id) channels whose persistent requests are retained for re-use.
+	constexpr static size_t max_recurring_channels = 1024;
+
+	/// Number of persistent requests with distinct base pointers or strides that each recurring channel keeps bound for re-use.
+	constexpr static size_t max_bound_requests_per_channel = 4;
+
 	/// Creates a new `mpi_communicator` by cloning the given `MPI_Comm`, which must not be `MPI_COMM_NULL`.
-	explicit mpi_communicator(collective_clone_from_tag tag, MPI_Comm mpi_comm);
+	explicit mpi_communicator(collective_clone_from_tag tag, MPI_Comm mpi_comm, size_t max_cached_array_types = default_max_cached_array_types);
 
 	mpi_communicator(const mpi_communicator&) = delete;
 	mpi_communicator(mpi_communicator&&) = delete;
@@ -32,6 +85,7 @@ class mpi_communicator final : public communicator {
 	node_id get_local_node_id() const override;
 
 	void send_outbound_pilot(const outbound_pilot& pilot) override;
+	void send_outbound_pilots(const std::vector<outbound_pilot>& pilots) override;
 	[[nodiscard]] std::vector<inbound_pilot> poll_inbound_pilots() override;
 
 	[[nodiscard]] async_event send_payload(node_id to, message_id msgid, const void* base, const stride& stride) override;
@@ -43,6 +97,10 @@ class mpi_communicator final : public communicator {
 	/// Returns the underlying `MPI_Comm`. The result is never `MPI_COMM_NULL`.
 	MPI_Comm get_native() const { return m_mpi_comm; }
 
+	datatype_cache_metrics get_datatype_cache_metrics() const;
+
+	persistent_request_metrics get_persistent_request_metrics() const { return m_persistent_request_metrics; }
+
   private:
 	friend struct mpi_communicator_testspy;
 
@@ -51,22 +109,57 @@ class mpi_communicator final : public communicator {
 	};
 	using unique_datatype = std::unique_ptr<std::remove_pointer_t<MPI_Datatype>, datatype_deleter>;
 
-	/// Keeps a stable pointer to a `pilot_message` alive during an asynchronous pilot send / receive operation.
-	struct in_flight_pilot {
-		std::unique_ptr<pilot_message> message;
+	/// Keeps the buffer of a coalesced pilot message alive during an asynchronous pilot send / receive operation. Moving the vector does not move its
+	/// elements, so the buffer address remains stable.
+	struct in_flight_pilots {
+		std::vector<pilot_message> messages;
 		MPI_Request request = MPI_REQUEST_NULL;
 	};
 
-	MPI_Comm m_mpi_comm = MPI_COMM_NULL;
+	MPI_Comm m_mpi_comm = MPI_COMM_NULL;   ///< for payloads and collectives
+	MPI_Comm m_pilot_comm = MPI_COMM_NULL; ///< for pilot messages, which do not promise exact message lengths
 
-	in_flight_pilot m_inbound_pilot; ///< continually Irecv'd into after the first call to poll_inbound_pilots()
-	std::vector<in_flight_pilot> m_outbound_pilots;
+	std::vector<in_flight_pilots> m_inbound_pilots; ///< continually Irecv'd into after the first call to poll_inbound_pilots()
+	std::vector<in_flight_pilots> m_outbound_pilots;
 
+	// Scalar types are few (one per buffer element size) and serve as the base of array types, so they are never evicted
 	std::unordered_map<size_t, unique_datatype> m_scalar_type_cache;
-	std::unordered_map<stride, unique_datatype> m_array_type_cache;
+
+	using array_type_lru_list = std::list<std::pair<stride, unique_datatype>>;
+	size_t m_max_cached_array_types;
+	array_type_lru_list m_array_type_lru; ///< most recently used first
+	std::unordered_map<stride, array_type_lru_list::iterator> m_array_type_cache;
+	datatype_cache_metrics m_array_type_metrics;
+
+	struct recurring_channel_key {
+		bool is_send = false;
+		node_id peer = 0;
+		message_id msgid = 0;
+
+		friend bool operator==(const recurring_channel_key& lhs, const recurring_channel_key& rhs) {
+			return lhs.is_send == rhs.is_send && lhs.peer == rhs.peer && lhs.msgid == rhs.msgid;
+		}
+		friend bool operator!=(const recurring_channel_key& lhs, const recurring_channel_key& rhs) { return !(lhs == rhs); }
+	};
+
+	struct recurring_channel_key_hash {
+		size_t operator()(const recurring_channel_key& key) const;
+	};
+
+	struct recurring_channel {
+		std::shared_ptr<mpi_detail::recurring_operation> last_operation; ///< the next transfer on the channel is started after this one completes
+		std::vector<std::shared_ptr<mpi_detail::persistent_request>> bound_requests; ///< most recently used first
+	};
+
+	using recurring_channel_lru_list = std::list<std::pair<recurring_channel_key, recurring_channel>>;
+	recurring_channel_lru_list m_recurring_channel_lru; ///< most recently used first
+	std::unordered_map<recurring_channel_key, recurring_channel_lru_list::iterator, recurring_channel_key_hash> m_recurring_channels;
+	persistent_request_metrics m_persistent_request_metrics;
 
 	MPI_Datatype get_scalar_type(size_t bytes);
 	MPI_Datatype get_array_type(const stride& stride);
+
+	async_event start_recurring_transfer(bool is_send, node_id peer, message_id msgid, const void* base, const stride& stride);
 };
 
 } // namespace celerity::detail
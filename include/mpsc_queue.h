@@ -0,0 +1,157 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <optional>
+#include <thread>
+#include <type_traits>
+
+
+namespace celerity::detail {
+
+/// Bounded, lock-free multi-producer single-consumer queue.
+///
+/// Slots are arranged in a ring and carry a sequence number that producers and the consumer use to hand off ownership (D. Vyukov's bounded queue scheme).
+/// Producers never take a lock unless the consumer is parked; they only yield while the ring is full. The consumer spins on the head slot for an adaptive
+/// number of iterations before parking on a condition variable, which keeps the wakeup latency low in bursts while not burning a core when idle.
+template <typename T>
+class mpsc_queue {
+  public:
+	/// Upper and lower bound of the adaptive spin budget (in polling iterations) before the consumer parks.
+	constexpr static size_t min_spin_iterations = 16;
+	constexpr static size_t max_spin_iterations = 16 * 1024;
+
+	/// `capacity` must be a power of two.
+	explicit mpsc_queue(const size_t capacity) : m_mask(capacity - 1), m_slots(new slot[capacity]) {
+		assert(capacity > 0 && (capacity & (capacity - 1)) == 0 && "mpsc_queue capacity must be a power of two");
+		for(size_t i = 0; i < capacity; ++i) {
+			m_slots[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	mpsc_queue(const mpsc_queue&) = delete;
+	mpsc_queue(mpsc_queue&&) = delete;
+	mpsc_queue& operator=(const mpsc_queue&) = delete;
+	mpsc_queue& operator=(mpsc_queue&&) = delete;
+
+	~mpsc_queue() {
+		while(try_pop().has_value()) {}
+	}
+
+	size_t capacity() const { return m_mask + 1; }
+
+	/// Thread-safe. Blocks (by yielding) only while the queue is full.
+	template <typename... CtorParams>
+	void emplace(CtorParams&&... ctor_args) {
+		// Arguments are only consumed once an element has actually been constructed, so forwarding them on every attempt is fine
+		while(!try_emplace(std::forward<CtorParams>(ctor_args)...)) {
+			std::this_thread::yield(); // The ring is full - wait for the consumer to free up the slot.
+		}
+	}
+
+	void push(const T& v) { emplace(v); }
+	void push(T&& v) { emplace(std::move(v)); }
+
+	/// Thread-safe. Never blocks, and returns false without constructing an element if the queue is full.
+	template <typename... CtorParams>
+	bool try_emplace(CtorParams&&... ctor_args) {
+		size_t pos = m_enqueue_pos.load(std::memory_order_relaxed);
+		slot* s;
+		for(;;) {
+			s = &m_slots[pos & m_mask];
+			const auto seq = s->sequence.load(std::memory_order_acquire);
+			const auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+			if(diff == 0) {
+				if(m_enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+			} else if(diff < 0) {
+				return false;
+			} else {
+				pos = m_enqueue_pos.load(std::memory_order_relaxed);
+			}
+		}
+		new(&s->storage) T(std::forward<CtorParams>(ctor_args)...);
+		s->sequence.store(pos + 1, std::memory_order_release);
+
+		// Pairs with the fence in park(): Either we observe the parked flag, or the consumer observes our sequence number before going to sleep.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if(m_consumer_parked.load(std::memory_order_relaxed)) {
+			{
+				std::lock_guard lock(m_park_mutex);
+				m_consumer_parked.store(false, std::memory_order_relaxed);
+			}
+			m_park_cv.notify_one();
+		}
+		return true;
+	}
+
+	bool try_push(const T& v) { return try_emplace(v); }
+	bool try_push(T&& v) { return try_emplace(std::move(v)); }
+
+	/// Consumer only.
+	bool empty() const { return !is_head_ready(); }
+
+	/// Consumer only. Returns the head element if there is one without waiting.
+	std::optional<T> try_pop() {
+		if(!is_head_ready()) return std::nullopt;
+		auto& s = m_slots[m_dequeue_pos & m_mask];
+		T* const item = std::launder(reinterpret_cast<T*>(&s.storage));
+		std::optional<T> result(std::move(*item));
+		item->~T();
+		s.sequence.store(m_dequeue_pos + m_mask + 1, std::memory_order_release);
+		++m_dequeue_pos;
+		return result;
+	}
+
+	/// Consumer only. Spins for a while, then parks until an element becomes available.
+	T pop() {
+		for(;;) {
+			for(size_t i = 0; i < m_spin_iterations; ++i) {
+				if(auto item = try_pop()) {
+					// We found work while spinning, so spinning a little longer next time is likely worth it.
+					m_spin_iterations = std::min(m_spin_iterations * 2, max_spin_iterations);
+					return std::move(*item);
+				}
+				if(i % 64 == 63) std::this_thread::yield();
+			}
+			// Spinning was in vain, so we spend less time on it next time.
+			m_spin_iterations = std::max(m_spin_iterations / 2, min_spin_iterations);
+			park();
+		}
+	}
+
+  private:
+	struct slot {
+		std::atomic<size_t> sequence;
+		std::aligned_storage_t<sizeof(T), alignof(T)> storage;
+	};
+
+	const size_t m_mask;
+	std::unique_ptr<slot[]> m_slots;
+
+	// Keep producer and consumer positions on separate cache lines to avoid false sharing
+	alignas(64) std::atomic<size_t> m_enqueue_pos{0};
+	alignas(64) size_t m_dequeue_pos = 0;
+	size_t m_spin_iterations = min_spin_iterations;
+
+	std::atomic<bool> m_consumer_parked{false};
+	std::mutex m_park_mutex;
+	std::condition_variable m_park_cv;
+
+	bool is_head_ready() const { return m_slots[m_dequeue_pos & m_mask].sequence.load(std::memory_order_acquire) == m_dequeue_pos + 1; }
+
+	void park() {
+		std::unique_lock lock(m_park_mutex);
+		m_consumer_parked.store(true, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		m_park_cv.wait(lock, [this] { return is_head_ready(); });
+		m_consumer_parked.store(false, std::memory_order_relaxed);
+	}
+};
+
+} // namespace celerity::detail
@@ -6,12 +6,24 @@
 
 namespace celerity::detail {
 
+/// Message ids from this value upwards are recurring: instruction_graph_generator assigns the same recurring id to every repetition of a send with identical
+/// peer, buffer and box (as in the halo exchange of an iterative stencil), and orders each such send after the previous one. Communicators can rely on this
+/// to bind persistent requests to recurring ids, since receive_arbiter issues the matching receives in send order (see `pilot_message::sequence`).
+inline constexpr message_id first_recurring_message_id = size_t{1} << 62;
+
+inline bool is_recurring_message_id(const message_id msgid) { return msgid >= first_recurring_message_id; }
+
+/// A recurring send that has not been repeated for this many horizons or epochs is forgotten by instruction_graph_generator, and its next occurrence will
+/// use a one-off message id again. Recurring ids are never re-used once forgotten.
+inline constexpr size_t max_idle_recurring_send_epochs = 4;
+
 /// Metadata exchanged in preparation for a peer-to-peer data transfer with send_instruction / receive_instruction (and cousins). Pilots allow the receiving
 /// side to issue MPI_*recv instructions directly to the appropriate target memory and (optionally) stride without additional staging or buffering.
 struct pilot_message {
 	detail::message_id id = -1;
 	detail::transfer_id transfer_id;
 	detail::box<3> box;
+	size_t sequence = 0; ///< position of this message among all messages with the same recurring id and sender, 0 for one-off ids
 };
 
 /// A pilot message as packaged on the sender side.
@@ -3,6 +3,8 @@
 #include "communicator.h"
 #include "pilot.h"
 
+#include <map>
+#include <optional>
 #include <unordered_map>
 #include <variant>
 
@@ -72,6 +74,23 @@ struct gather_transfer {
 	bool do_complete();
 };
 
+/// A payload-receive with a recurring message id that is held back until all receives for earlier sequence numbers from the same peer have been issued.
+struct deferred_receive {
+	node_id from;
+	message_id msgid;
+	void* base;
+	communicator::stride stride;
+	std::optional<async_event> communication; ///< set once the receive has been issued to the communicator
+};
+
+/// Issue state of all receives from one peer with one recurring message id.
+struct recurring_receive_channel {
+	size_t next_sequence = 0;                                              ///< pilot_message::sequence of the next receive to issue
+	std::map<size_t, std::shared_ptr<deferred_receive>> deferred_receives; ///< by sequence number
+	/// Number of horizons and epochs reached by the executor when a receive on this channel was last issued or deferred
+	size_t last_active_epoch = 0;
+};
+
 /// Depending on the order of inputs, transfers may start out as unassigned and will be replaced by either `multi_region_transfer`s or `gather_transfer`s
 /// once explicit calls to the respective receive arbiter functions are made.
 using transfer = std::variant<unassigned_transfer, multi_region_transfer, gather_transfer>;
@@ -89,6 +108,10 @@ namespace celerity::detail {
 /// The receive_arbiter's job is to match these inbound pilots to receive instructions generated from await-push commands to issue in-place receives (i.e.
 /// `MPI_Recv`) of the data into an appropriate host allocation. Since these inputs may arrive in arbitrary order, it maintains a separate state machine for
 /// each `transfer_id` to drive all operations that eventually result in completing an `async_event` for each receive instruction.
+///
+/// Pilots for a recurring message id (see `is_recurring_message_id`) may arrive, and be matched with their receive instructions, in a different order than
+/// their sends were issued. Since the communicator matches recurring transfers in issue order, such payload-receives are deferred until the receives for
+/// all lower `pilot_message::sequence` numbers from the same peer have been issued.
 class receive_arbiter {
   public:
 	/// `receive_arbiter` will use `comm` to poll for inbound pilots and issue payload-receives.
@@ -126,19 +149,39 @@ class receive_arbiter {
 	/// unconditionally.
 	void poll_communicator();
 
+	/// To be called whenever the executor reaches a horizon or epoch. Forgets the sequence state of recurring message ids that senders have retired.
+	void notify_epoch_reached();
+
+	/// A recurring channel without deferred receives is forgotten once this many horizons or epochs have been reached after its last receive was issued.
+	///
+	/// A receive for a task following horizon k is issued after horizon k - 1 has been reached, and the sender's next message on the same id (if it has not
+	/// retired the id) belongs to a task at most `max_idle_recurring_send_epochs` horizons later, whose receive must be issued before the horizon after that
+	/// task can be reached. Twice the sender's limit leaves ample margin for counting differences between both sides.
+	constexpr static size_t recurring_channel_retention_epochs = 2 * max_idle_recurring_send_epochs;
+
   private:
+	friend struct receive_arbiter_testspy;
+
 	communicator* m_comm;
 	size_t m_num_nodes;
+	size_t m_num_reached_epochs = 0;
 
 	/// State machines for all `transfer_id`s that were mentioned in an inbound pilot or call to one of the receive functions. Once a transfer is complete, it
 	/// is cleared from `m_transfers`, but `multi_region_transfer`s can be re-created if there later appears another pair of inbound pilots and `receive`s for
 	/// the same transfer id that did not temporally overlap with the original ones.
 	std::unordered_map<transfer_id, receive_arbiter_detail::transfer> m_transfers;
 
+	/// Sequence state for every (peer, recurring message id) pair that a pilot has been received for, until the id is retired (see notify_epoch_reached).
+	std::unordered_map<std::pair<node_id, message_id>, receive_arbiter_detail::recurring_receive_channel, utils::pair_hash> m_recurring_receive_channels;
+
 	/// Initiates a new `region_request` for which the caller can construct events to await either the entire region or sub-regions.
 	receive_arbiter_detail::stable_region_request& initiate_region_request(
 	    const transfer_id& trid, const region<3>& request, void* allocation, const box<3>& allocated_box, size_t elem_size);
 
+	/// Issues the payload-receive announced by `pilot` to the communicator, or defers it if it carries a recurring message id and an earlier receive on the
+	/// same channel has not been issued yet.
+	async_event begin_payload_receive(const inbound_pilot& pilot, void* base, const communicator::stride& stride);
+
 	/// Updates the state of an active `region_request` from receiving an inbound pilot.
 	void handle_region_request_pilot(receive_arbiter_detail::region_request& rr, const inbound_pilot& pilot, size_t elem_size);
 
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "command.h"
+#include "horizon_policy.h"
 #include "instruction_graph.h"
 #include "pilot.h"
 #include "task.h"
@@ -56,6 +57,7 @@ struct task_record {
 	access_list accesses;
 	detail::side_effect_map side_effect_map;
 	task_dependency_list dependencies;
+	std::optional<detail::horizon_decision> horizon_decision; // set for horizons generated under the adaptive horizon policy
 };
 
 class task_recorder {
@@ -145,6 +147,7 @@ enum class instruction_dependency_origin {
 	last_epoch,             ///< Fall-back dependency to the effective epoch for instructions that have no other dependency
 	execution_front,        ///< Dependency from a new epoch- or horizon instruction to the previous execution front
 	split_receive,          ///< Ordering dependency between a `split_receive_instruction` and its `await_receive_instruction`s
+	recurring_send,         ///< Ordering dependency between two `send_instruction`s that share a recurring message id
 };
 
 struct instruction_dependency_record {
@@ -159,14 +162,15 @@ struct instruction_dependency_record {
 /// IDAG base record type for `detail::instruction`.
 struct instruction_record
     : matchbox::acceptor<struct clone_collective_group_instruction_record, struct alloc_instruction_record, struct free_instruction_record,
-          struct copy_instruction_record, struct device_kernel_instruction_record, struct host_task_instruction_record, struct send_instruction_record,
-          struct receive_instruction_record, struct split_receive_instruction_record, struct await_receive_instruction_record,
-          struct gather_receive_instruction_record, struct fill_identity_instruction_record, struct reduce_instruction_record, struct fence_instruction_record,
-          struct destroy_host_object_instruction_record, struct horizon_instruction_record,
+          struct copy_instruction_record, struct device_kernel_instruction_record, struct host_task_instruction_record,
+          struct linearize_instruction_record, struct send_instruction_record, struct receive_instruction_record, struct split_receive_instruction_record,
+          struct await_receive_instruction_record, struct gather_receive_instruction_record, struct fill_identity_instruction_record,
+          struct reduce_instruction_record, struct fence_instruction_record, struct destroy_host_object_instruction_record, struct horizon_instruction_record,
           struct epoch_instruction_record> //
 {
 	instruction_id id;
 	int priority;
+	std::chrono::nanoseconds estimated_duration;
 
 	explicit instruction_record(const instruction& instr);
 };
@@ -184,12 +188,14 @@ struct alloc_instruction_record : matchbox::implement_acceptor<instruction_recor
 	enum class alloc_origin {
 		buffer,
 		gather,
+		staging,
 	};
 
 	detail::allocation_id allocation_id;
 	size_t size_bytes;
 	size_t alignment_bytes;
 	alloc_origin origin;
+	bool is_staging;
 	std::optional<buffer_allocation_record> buffer_allocation;
 	std::optional<size_t> num_chunks;
 
@@ -213,6 +219,7 @@ struct copy_instruction_record : matchbox::implement_acceptor<instruction_record
 		coherence,
 		gather,
 		fence,
+		staging,
 	};
 
 	allocation_with_offset source_allocation;
@@ -280,6 +287,22 @@ struct host_task_instruction_record : matchbox::implement_acceptor<instruction_r
 	    const std::vector<buffer_memory_record>& buffer_memory_allocation_map);
 };
 
+/// IDAG record type for a `linearize_instruction`.
+struct linearize_instruction_record : matchbox::implement_acceptor<instruction_record, linearize_instruction_record> {
+	allocation_id source_allocation_id;
+	range<3> source_allocation_range;
+	celerity::id<3> offset_in_source_allocation;
+	range<3> linearize_range;
+	size_t element_size;
+	allocation_id staging_allocation_id;
+	detail::transfer_id transfer_id;
+	std::string buffer_name;
+	celerity::id<3> offset_in_buffer;
+
+	linearize_instruction_record(
+	    const linearize_instruction& linstr, const detail::transfer_id& trid, std::string buffer_name, const celerity::id<3>& offset_in_buffer);
+};
+
 /// IDAG record type for a `send_instruction`.
 struct send_instruction_record : matchbox::implement_acceptor<instruction_record, send_instruction_record> {
 	node_id dest_node_id;
@@ -423,6 +446,15 @@ class instruction_recorder {
 
 	void record_instruction(std::unique_ptr<instruction_record> record) { m_recorded_instructions.push_back(std::move(record)); }
 
+	/// Priorities are finalized when the generator flushes a batch, which happens after all its instructions have been recorded.
+	void record_instruction_priority(const instruction_id iid, const int priority) {
+		// the instruction is among the most recently recorded ones
+		const auto it = std::find_if(m_recorded_instructions.rbegin(), m_recorded_instructions.rend(),
+		    [=](const std::unique_ptr<instruction_record>& instr) { return instr->id == iid; });
+		assert(it != m_recorded_instructions.rend());
+		(*it)->priority = priority;
+	}
+
 	void record_outbound_pilot(const outbound_pilot& pilot) { m_recorded_pilots.push_back(pilot); }
 
 	void record_dependency(const instruction_dependency_record& dependency) { m_recorded_dependencies.push_back(dependency); }
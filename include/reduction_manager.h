@@ -4,6 +4,8 @@
 #include "runtime.h"
 #include "types.h"
 
+#include <memory>
+#include <mutex>
 #include <vector>
 
 namespace celerity {
@@ -18,6 +20,12 @@ namespace detail {
 
 		virtual void reduce_to_buffer() = 0;
 
+		/// Writes the identity value to `count` consecutive elements at `ptr` (used by live_executor).
+		virtual void fill_identity(void* ptr, size_t count) const = 0;
+
+		/// Overwrites `*dest` with the reduction of the identity and `count` consecutive elements at `src` (used by live_executor).
+		virtual void reduce(void* dest, const void* src, size_t count) const = 0;
+
 	  protected:
 		buffer_id m_output_bid;
 		std::vector<std::pair<node_id, unique_payload_ptr>> m_overlapping_data;
@@ -41,6 +49,16 @@ namespace detail {
 			*static_cast<DataT*>(info.ptr) = acc;
 		}
 
+		void fill_identity(void* const ptr, const size_t count) const override { std::uninitialized_fill_n(static_cast<DataT*>(ptr), count, m_init); }
+
+		void reduce(void* const dest, const void* const src, const size_t count) const override {
+			DataT acc = m_init;
+			for(size_t i = 0; i < count; ++i) {
+				acc = m_op(acc, static_cast<const DataT*>(src)[i]);
+			}
+			*static_cast<DataT*>(dest) = acc;
+		}
+
 	  private:
 		BinaryOperation m_op;
 		DataT m_init;
@@ -72,6 +90,22 @@ namespace detail {
 			m_reductions.erase(rid);
 		}
 
+		void fill_identity(const reduction_id rid, void* const ptr, const size_t count) const {
+			std::lock_guard lock{m_mutex};
+			m_reductions.at(rid)->fill_identity(ptr, count);
+		}
+
+		void reduce(const reduction_id rid, void* const dest, const void* const src, const size_t count) const {
+			std::lock_guard lock{m_mutex};
+			m_reductions.at(rid)->reduce(dest, src, count);
+		}
+
+		/// Called by live_executor once a reduction is no longer referenced by any instruction.
+		void erase_reduction(const reduction_id rid) {
+			std::lock_guard lock{m_mutex};
+			m_reductions.erase(rid);
+		}
+
 	  private:
 		mutable std::mutex m_mutex;
 		reduction_id m_next_rid = 1;
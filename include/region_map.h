@@ -948,17 +948,21 @@ namespace region_map_detail {
 		std::vector<typename types::entry> get_region_values(const box<Dims>& request) const {
 			assert(m_root != nullptr && "Moved from?");
 
-			m_query_results_raw.clear();
-			m_root->query(request, m_query_results_raw);
+			// Scratch buffers are kept per thread so that concurrent queries on the same (const) region map are safe
+			thread_local std::vector<typename types::entry> query_results_raw;
+			thread_local std::vector<typename types::entry> query_results_clamped;
+
+			query_results_raw.clear();
+			m_root->query(request, query_results_raw);
 
 #if !CELERITY_DETAIL_REGION_MAP_CLAMP_RESULTS_TO_REQUEST_BOUNDARY && !CELERITY_DETAIL_REGION_MAP_MERGE_RESULTS
-			return m_query_results_raw;
+			return query_results_raw;
 #endif
 
 #if CELERITY_DETAIL_REGION_MAP_CLAMP_RESULTS_TO_REQUEST_BOUNDARY
 			// Clamp to query request box
-			m_query_results_clamped.clear();
-			for(auto& [b, v] : m_query_results_raw) {
+			query_results_clamped.clear();
+			for(auto& [b, v] : query_results_raw) {
 				const auto r_min = request.get_min();
 				const auto r_max = request.get_max();
 				const auto v_min = b.get_min();
@@ -970,37 +974,37 @@ namespace region_map_detail {
 					clamped_min[d] = std::max(v_min[d], r_min[d]);
 					clamped_max[d] = std::min(v_max[d], r_max[d]);
 				}
-				m_query_results_clamped.push_back(std::make_pair(box<Dims>{clamped_min, clamped_max}, v));
+				query_results_clamped.push_back(std::make_pair(box<Dims>{clamped_min, clamped_max}, v));
 			}
 #else
-			std::swap(m_query_results_raw, m_query_results_clamped);
+			std::swap(query_results_raw, query_results_clamped);
 #endif
 
 #ifdef NDEBUG
 			// In 1D everything that can be merged will be merged on update.
 			// (Nevertheless, assert this in debug builds).
-			if(Dims == 1) return m_query_results_clamped;
+			if(Dims == 1) return query_results_clamped;
 #endif
 
 #if !CELERITY_DETAIL_REGION_MAP_MERGE_RESULTS
-			return m_query_results_clamped;
+			return query_results_clamped;
 #endif
 
 			// Do a greedy quadratic merge
 			// TODO PERF: Can we come up with a more efficient solution here? Maybe some sort of line-sweeping algorithm?
 			bool did_merge = true;
-			std::vector<bool> is_merged(m_query_results_clamped.size(), false);
+			std::vector<bool> is_merged(query_results_clamped.size(), false);
 			while(did_merge) {
 				did_merge = false;
-				for(size_t i = 0; i < m_query_results_clamped.size(); ++i) {
+				for(size_t i = 0; i < query_results_clamped.size(); ++i) {
 					if(is_merged[i]) continue;
-					for(size_t j = i + 1; j < m_query_results_clamped.size(); ++j) {
+					for(size_t j = i + 1; j < query_results_clamped.size(); ++j) {
 						if(is_merged[j]) continue;
-						if(m_query_results_clamped[i].second != m_query_results_clamped[j].second) continue;
-						if(can_merge(m_query_results_clamped[i].first, m_query_results_clamped[j].first)) {
+						if(query_results_clamped[i].second != query_results_clamped[j].second) continue;
+						if(can_merge(query_results_clamped[i].first, query_results_clamped[j].first)) {
 							assert(Dims > 1 || !CELERITY_DETAIL_REGION_MAP_MERGE_ON_UPDATE); // 1D should already have merged on update.
 							// TODO PERF: Computing the bbox from scratch isn't ideal, as we really only need to adjust one dimension.
-							m_query_results_clamped[i].first = compute_bounding_box(m_query_results_clamped[i].first, m_query_results_clamped[j].first);
+							query_results_clamped[i].first = compute_bounding_box(query_results_clamped[i].first, query_results_clamped[j].first);
 							is_merged[j] = true;
 							did_merge = true;
 						}
@@ -1008,8 +1012,8 @@ namespace region_map_detail {
 				}
 			}
 			std::vector<typename types::entry> results_merged;
-			for(size_t i = 0; i < m_query_results_clamped.size(); ++i) {
-				if(!is_merged[i]) results_merged.emplace_back(std::move(m_query_results_clamped[i]));
+			for(size_t i = 0; i < query_results_clamped.size(); ++i) {
+				if(!is_merged[i]) results_merged.emplace_back(std::move(query_results_clamped[i]));
 			}
 
 			return results_merged;
@@ -1039,8 +1043,6 @@ namespace region_map_detail {
 		std::vector<typename types::entry> m_merge_candidates;
 		std::vector<typename types::entry> m_updated_nodes;
 		std::vector<typename types::orphan> m_erase_orphans;
-		mutable std::vector<typename types::entry> m_query_results_raw;
-		mutable std::vector<typename types::entry> m_query_results_clamped;
 
 		/**
 		 * Inserts a new entry into the tree.
@@ -1357,6 +1359,19 @@ class region_map {
 		}
 	}
 
+	/**
+	 * Returns the number of box/value entries in the region map, which grows as the map becomes fragmented. Takes time linear in the number of entries.
+	 */
+	size_t get_num_entries() const {
+		switch(m_dims) {
+		case 0: return 1;
+		case 1: return count_entries<1>();
+		case 2: return count_entries<2>();
+		case 3: return count_entries<3>();
+		default: assert(false); return 0;
+		}
+	}
+
 	auto format_to(fmt::format_context::iterator out) const {
 		switch(m_dims) {
 		case 1: return get_map<1>().format_to(out);
@@ -1382,6 +1397,13 @@ class region_map {
 		static_assert(Dims >= 0 && Dims <= 3);
 		return std::get<Dims + 1>(m_region_map);
 	}
+
+	template <int Dims>
+	size_t count_entries() const {
+		size_t num_entries = 0;
+		get_map<Dims>().for_each([&num_entries](const auto& /* box */, const auto& /* value */) { ++num_entries; });
+		return num_entries;
+	}
 };
 
 } // namespace celerity::detail
@@ -1,12 +1,15 @@
 #pragma once
 
 #include <memory>
+#include <new>
+#include <unordered_map>
 
 #include "buffer_manager.h"
 #include "command.h"
 #include "config.h"
 #include "device_queue.h"
 #include "host_queue.h"
+#include "live_executor.h"
 #include "recorders.h"
 #include "types.h"
 
@@ -26,13 +29,15 @@ namespace detail {
 	class executor;
 	class task_manager;
 	class host_object_manager;
+	class instruction_graph;
+	class cost_model;
 
 	class runtime_already_started_error : public std::runtime_error {
 	  public:
 		runtime_already_started_error() : std::runtime_error("The Celerity runtime has already been started") {}
 	};
 
-	class runtime {
+	class runtime : private live_executor::delegate {
 		friend struct runtime_testspy;
 
 	  public:
@@ -73,8 +78,9 @@ namespace detail {
 
 		template <typename DataT, int Dims>
 		buffer_id create_buffer(const range<3>& range, const DataT* host_init_ptr) {
-			const auto bid = m_buffer_mngr->register_buffer<DataT, Dims>(range, host_init_ptr);
-			this->register_buffer(bid, range, host_init_ptr != nullptr);
+			// With the live executor, host-initialization data is read from a user allocation instead of being copied into the buffer manager
+			const auto bid = m_buffer_mngr->register_buffer<DataT, Dims>(range, m_live_exec == nullptr ? host_init_ptr : nullptr);
+			this->register_buffer(bid, range, sizeof(DataT), alignof(DataT), host_init_ptr);
 			return bid;
 		}
 
@@ -91,6 +97,18 @@ namespace detail {
 
 		bool is_dry_run() const { return m_cfg->is_dry_run(); }
 
+		/**
+		 * @brief Whether the instruction graph is executed by the live executor (CELERITY_LIVE_EXECUTOR) instead of the legacy command executor.
+		 */
+		bool uses_live_executor() const { return m_live_exec != nullptr; }
+
+		/**
+		 * @brief Makes memory owned by the caller available to the live executor as a user allocation, e.g. as the destination of a buffer fence.
+		 *
+		 * The memory must remain valid until the instruction that uses it has completed. Must only be called if uses_live_executor() is true.
+		 */
+		allocation_id create_user_allocation(void* ptr);
+
 	  private:
 		inline static bool m_mpi_initialized = false;
 		inline static bool m_mpi_finalized = false;
@@ -122,6 +140,18 @@ namespace detail {
 		std::unique_ptr<task_manager> m_task_mngr;
 		std::unique_ptr<executor> m_exec;
 
+		// Only constructed when the live executor is enabled, in which case m_exec is null.
+		std::unique_ptr<instruction_graph> m_idag;
+		std::unique_ptr<cost_model> m_cost_model; // shared between the instruction graph generator (estimates) and the live executor (observations)
+		std::unique_ptr<live_executor> m_live_exec;
+		size_t m_next_user_allocation_id = 1; // user allocations are only created from the main thread
+
+		struct aligned_deleter {
+			size_t alignment;
+			void operator()(void* const ptr) const { ::operator delete(ptr, std::align_val_t(alignment)); }
+		};
+		std::unordered_map<buffer_id, std::unique_ptr<void, aligned_deleter>> m_host_init_allocations; // copies of host-initialization data
+
 		std::unique_ptr<detail::task_recorder> m_task_recorder;
 		std::unique_ptr<detail::command_recorder> m_command_recorder;
 
@@ -130,7 +160,11 @@ namespace detail {
 		runtime(runtime&&) = delete;
 
 		// The outlined non-templated part of create_buffer (so we don't need definitions of task_manager or distributed_graph_generator in this header)
-		void register_buffer(buffer_id bid, const range<3>& range, bool host_initialized);
+		void register_buffer(buffer_id bid, const range<3>& range, size_t elem_size, size_t elem_align, const void* host_init_ptr);
+
+		// live_executor::delegate
+		void horizon_reached(task_id tid) override;
+		void epoch_reached(task_id tid) override;
 
 		/**
 		 * @brief Destroys the runtime if it is no longer active and all buffers have been unregistered.
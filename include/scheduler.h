@@ -1,12 +1,11 @@
 #pragma once
 
-#include <condition_variable>
-#include <mutex>
-#include <queue>
+#include <atomic>
 #include <thread>
 #include <variant>
 
 #include "distributed_graph_generator.h"
+#include "mpsc_queue.h"
 #include "ranges.h"
 #include "types.h"
 
@@ -16,6 +15,8 @@ namespace detail {
 	class command_graph;
 	class command_recorder;
 	class executor;
+	class instruction_graph;
+	class instruction_graph_generator;
 	class task;
 
 	// Abstract base class to allow different threading implementation in tests
@@ -23,7 +24,16 @@ namespace detail {
 	  public:
 		abstract_scheduler(const bool is_dry_run, std::unique_ptr<distributed_graph_generator> dggen, executor& exec);
 
-		virtual ~abstract_scheduler() = default;
+		/**
+		 * @brief Constructs a scheduler that compiles commands into instructions instead of passing them to the (legacy) executor.
+		 *
+		 * Instructions are inserted into @p idag, which the scheduler prunes as horizons and epochs are reported as reached. Consumers of the generated
+		 * instructions are notified through the delegate of @p iggen.
+		 */
+		abstract_scheduler(const bool is_dry_run, std::unique_ptr<distributed_graph_generator> dggen, instruction_graph& idag,
+		    std::unique_ptr<instruction_graph_generator> iggen);
+
+		virtual ~abstract_scheduler();
 
 		virtual void startup() = 0;
 
@@ -35,7 +45,17 @@ namespace detail {
 		void notify_task_created(const task* const tsk) { notify(event_task_available{tsk}); }
 
 		void notify_buffer_created(const buffer_id bid, const range<3>& range, bool host_initialized) {
-			notify(event_buffer_created{bid, range, host_initialized});
+			notify(event_buffer_created{bid, range, host_initialized, 1, 1, null_allocation_id});
+		}
+
+		/**
+		 * @brief Variant of notify_buffer_created() that carries the information required for instruction graph generation.
+		 *
+		 * The buffer is host-initialized iff @p user_allocation_id is not the null allocation id.
+		 */
+		void notify_buffer_created(
+		    const buffer_id bid, const range<3>& range, const size_t elem_size, const size_t elem_align, const allocation_id user_allocation_id) {
+			notify(event_buffer_created{bid, range, user_allocation_id != null_allocation_id, elem_size, elem_align, user_allocation_id});
 		}
 
 		void notify_buffer_debug_name_changed(const buffer_id bid, const std::string& name) { notify(event_buffer_debug_name_changed{bid, name}); }
@@ -46,6 +66,34 @@ namespace detail {
 
 		void notify_host_object_destroyed(const host_object_id hoid) { notify(event_host_object_destroyed{hoid}); }
 
+		/**
+		 * @brief Called by the executor once a horizon has been reached, so that instructions that can no longer be referenced are freed.
+		 *
+		 * Never blocks: The scheduler thread may itself be waiting for room in the executor's submission queue.
+		 */
+		void notify_horizon_reached(const task_id tid) {
+			m_latest_horizon_reached.store(tid, std::memory_order_release);
+			notify_executor_progress();
+		}
+
+		/**
+		 * @brief Called by the executor once an epoch has been reached, so that instructions that can no longer be referenced are freed.
+		 *
+		 * Never blocks, see notify_horizon_reached().
+		 */
+		void notify_epoch_reached(const task_id tid) {
+			m_latest_epoch_reached.store(tid, std::memory_order_release);
+			notify_executor_progress();
+		}
+
+		/**
+		 * @brief Holds back the commands of up to @p num_tasks tasks before passing them on, so that later stages can take subsequent accesses into account.
+		 *
+		 * Commands are always passed on when a horizon, epoch or fence task arrives. Only has an effect when the scheduler generates an instruction graph.
+		 * Must be called before startup().
+		 */
+		void set_lookahead(const size_t num_tasks) { m_lookahead = num_tasks; }
+
 	  protected:
 		/**
 		 * This is called by the worker thread.
@@ -53,8 +101,14 @@ namespace detail {
 		void schedule();
 
 		// Constructor for tests that does not require an executor
-		abstract_scheduler(const bool is_dry_run, std::unique_ptr<distributed_graph_generator> dggen)
-		    : m_is_dry_run(is_dry_run), m_dggen(std::move(dggen)), m_exec(nullptr) {}
+		abstract_scheduler(const bool is_dry_run, std::unique_ptr<distributed_graph_generator> dggen);
+
+		// Number of events that can be in flight between the main thread and the scheduler before submission blocks.
+		// This comfortably exceeds the task ring buffer size, so in practice only buffer / host object churn can fill it up.
+		constexpr static size_t event_queue_capacity = 4096;
+
+		// Upper bound on the number of tasks compiled before the resulting commands are handed to the executor.
+		constexpr static size_t max_tasks_per_batch = 64;
 
 	  private:
 		struct event_shutdown {};
@@ -65,6 +119,9 @@ namespace detail {
 			buffer_id bid;
 			celerity::range<3> range;
 			bool host_initialized;
+			size_t elem_size;
+			size_t elem_align;
+			allocation_id user_allocation_id;
 		};
 		struct event_buffer_debug_name_changed {
 			buffer_id bid;
@@ -79,20 +136,28 @@ namespace detail {
 		struct event_host_object_destroyed {
 			host_object_id hoid;
 		};
+		struct event_executor_progress {}; ///< wakes up the scheduler to pick up m_latest_horizon_reached / m_latest_epoch_reached
 		using event = std::variant<event_shutdown, event_task_available, event_buffer_created, event_buffer_debug_name_changed, event_buffer_destroyed,
-		    event_host_object_created, event_host_object_destroyed>;
+		    event_host_object_created, event_host_object_destroyed, event_executor_progress>;
 
 		bool m_is_dry_run;
 		std::unique_ptr<distributed_graph_generator> m_dggen;
 		executor* m_exec; // Pointer instead of reference so we can omit for tests / benchmarks
+		instruction_graph* m_idag = nullptr;
+		std::unique_ptr<instruction_graph_generator> m_iggen; // only set if commands are compiled into instructions
+		size_t m_lookahead = 0;
 
-		std::queue<event> m_available_events;
-		std::queue<event> m_in_flight_events;
+		mpsc_queue<event> m_available_events{event_queue_capacity};
 
-		mutable std::mutex m_events_mutex;
-		std::condition_variable m_events_cv;
+		// Reached horizons and epochs are published through atomics instead of m_available_events, since the executor must never block on a full event
+		// queue while the scheduler is blocked on a full executor queue. Both are monotonic, and task 0 (the initial epoch) means "nothing reached yet".
+		std::atomic<task_id> m_latest_horizon_reached{0};
+		std::atomic<task_id> m_latest_epoch_reached{0};
 
 		void notify(const event& evt);
+
+		/// If the event queue is full, the scheduler thread is awake or about to be and will observe the progress on its own.
+		void notify_executor_progress() { (void)m_available_events.try_push(event_executor_progress{}); }
 	};
 
 	class scheduler final : public abstract_scheduler {
@@ -105,6 +170,9 @@ namespace detail {
 
 		void shutdown() override;
 
+		/// Only valid between startup() and shutdown().
+		std::thread::native_handle_type get_thread_handle() { return m_worker_thread.native_handle(); }
+
 	  private:
 		std::thread m_worker_thread;
 	};
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace celerity::detail {
+
+/// Recycles host staging buffers, such as the destination allocations of `linearize_instruction`s, so that steady-state communication does not allocate.
+///
+/// Buffers are handed out in power-of-two size classes, which lets a released buffer satisfy any later request of similar size. Released buffers are
+/// retained for reuse until their total size would exceed `max_retained_bytes`, after which they are returned to the system immediately. Memory is obtained
+/// through user-supplied functions, which allows the executor to hand out pinned memory.
+class staging_pool {
+  public:
+	using allocate_function = std::function<void*(size_t size_bytes, size_t alignment_bytes)>;
+	using free_function = std::function<void(void* ptr)>;
+
+	constexpr static size_t min_buffer_size = 4096;
+	constexpr static size_t buffer_alignment = 64; ///< covers the alignment requirements of all practical buffer element types
+	constexpr static size_t default_max_retained_bytes = size_t{256} << 20;
+
+	explicit staging_pool(allocate_function allocate, free_function free, const size_t max_retained_bytes = default_max_retained_bytes)
+	    : m_allocate(std::move(allocate)), m_free(std::move(free)), m_max_retained_bytes(max_retained_bytes) {}
+
+	staging_pool(const staging_pool&) = delete;
+	staging_pool(staging_pool&&) = delete;
+	staging_pool& operator=(const staging_pool&) = delete;
+	staging_pool& operator=(staging_pool&&) = delete;
+
+	~staging_pool() {
+		assert(m_acquired.empty() && "staging buffers are still in use");
+		for(const auto& [size_class, buffers] : m_retained) {
+			for(const auto ptr : buffers) {
+				m_free(ptr);
+			}
+		}
+	}
+
+	/// Returns a buffer of at least `size_bytes` bytes, aligned to `buffer_alignment`.
+	void* acquire(const size_t size_bytes) {
+		const auto size_class = get_size_class(size_bytes);
+		void* ptr = nullptr;
+		if(auto& retained = m_retained[size_class]; !retained.empty()) {
+			ptr = retained.back();
+			retained.pop_back();
+			m_retained_bytes -= size_class;
+		} else {
+			ptr = m_allocate(size_class, buffer_alignment);
+			++m_num_allocations;
+		}
+		m_acquired.emplace(ptr, size_class);
+		return ptr;
+	}
+
+	/// Returns true if `ptr` was handed out by `acquire()` and has not been released yet.
+	bool is_acquired(const void* const ptr) const { return m_acquired.count(ptr) != 0; }
+
+	/// Makes a buffer returned from `acquire()` available for reuse.
+	void release(void* const ptr) {
+		const auto it = m_acquired.find(ptr);
+		assert(it != m_acquired.end());
+		const auto size_class = it->second;
+		m_acquired.erase(it);
+		if(m_retained_bytes + size_class > m_max_retained_bytes) {
+			m_free(ptr);
+			return;
+		}
+		m_retained[size_class].push_back(ptr);
+		m_retained_bytes += size_class;
+	}
+
+	/// Total size of all released buffers that are held for reuse.
+	size_t get_retained_bytes() const { return m_retained_bytes; }
+
+	/// Number of times the pool had to call its allocate function.
+	size_t get_num_allocations() const { return m_num_allocations; }
+
+	static size_t get_size_class(const size_t size_bytes) {
+		size_t size_class = min_buffer_size;
+		while(size_class < size_bytes) {
+			size_class *= 2;
+		}
+		return size_class;
+	}
+
+  private:
+	allocate_function m_allocate;
+	free_function m_free;
+	size_t m_max_retained_bytes;
+	std::unordered_map<size_t, std::vector<void*>> m_retained; ///< by size class
+	std::unordered_map<const void*, size_t> m_acquired;        ///< size class of every buffer currently in use
+	size_t m_retained_bytes = 0;
+	size_t m_num_allocations = 0;
+};
+
+} // namespace celerity::detail
@@ -4,6 +4,7 @@
 #include "types.h"
 
 #include <bitset>
+#include <limits>
 
 namespace celerity::detail {
 
@@ -35,6 +36,10 @@ struct memory_info {
 	/// Further, copies must always be possible between `host_memory_id` and `user_memory_id` as well as between `host_memory_id` and every other memory.
 	/// instruction_graph_generator will create a staging copy in host memory if data must be transferred between two memories that are not copy peers.
 	memory_mask copy_peers;
+
+	/// Number of bytes instruction_graph_generator may keep allocated for buffers in this memory. When an allocation on a device memory would exceed it,
+	/// the least-recently accessed allocations of buffers that the current command does not access are spilled to host memory and freed.
+	size_t capacity = std::numeric_limits<size_t>::max();
 };
 
 /// All information about the local system that influences the generated instruction graph.
@@ -1,11 +1,16 @@
 #pragma once
 
+#include <algorithm>
 #include <memory>
+#include <stdexcept>
 #include <unordered_map>
 #include <unordered_set>
 #include <utility>
 #include <vector>
 
+#include <gch/small_vector.hpp>
+
+#include "arena.h"
 #include "device_queue.h"
 #include "grid.h"
 #include "hint.h"
@@ -50,8 +55,21 @@ namespace detail {
 		virtual sycl::event operator()(
 		    device_queue& q, const subrange<3> execution_sr, const std::vector<void*>& reduction_ptrs, const bool is_reduction_initializer) const = 0;
 		virtual std::future<host_queue::execution_info> operator()(host_queue& q, const subrange<3>& execution_sr) const = 0;
+
+		// Launch functions for instructions executed by live_executor (see launcher.h)
+		virtual void operator()(sycl::handler& cgh, const box<3>& execution_range, const std::vector<void*>& reduction_ptrs) const = 0;
+		virtual void operator()(const box<3>& execution_range, MPI_Comm mpi_comm) const = 0;
+	};
+
+	/// Combines the launch functions for the legacy executor and the live executor into one functor that can be stored in a `command_launcher_storage`.
+	template <typename... Launchers>
+	struct launcher_overload_set : Launchers... {
+		using Launchers::operator()...;
 	};
 
+	template <typename... Launchers>
+	launcher_overload_set(Launchers...) -> launcher_overload_set<Launchers...>;
+
 	template <typename Functor>
 	class command_launcher_storage : public command_launcher_storage_base {
 	  public:
@@ -66,6 +84,12 @@ namespace detail {
 			return invoke<std::future<host_queue::execution_info>>(q, execution_sr);
 		}
 
+		void operator()(sycl::handler& cgh, const box<3>& execution_range, const std::vector<void*>& reduction_ptrs) const override {
+			invoke<void>(cgh, execution_range, reduction_ptrs);
+		}
+
+		void operator()(const box<3>& execution_range, MPI_Comm mpi_comm) const override { invoke<void>(execution_range, mpi_comm); }
+
 	  private:
 		Functor m_fun;
 
@@ -79,9 +103,15 @@ namespace detail {
 		}
 	};
 
+	/// Range mappers, launchers and hints are constructed in the storage of the task_ring_buffer slot of their task if available (see `handler`), or on the
+	/// heap otherwise.
+	using unique_range_mapper_ptr = std::unique_ptr<range_mapper_base, arena_or_heap_deleter>;
+	using unique_launcher_ptr = std::unique_ptr<command_launcher_storage_base, arena_or_heap_deleter>;
+	using unique_hint_ptr = std::unique_ptr<hint_base, arena_or_heap_deleter>;
+
 	class buffer_access_map {
 	  public:
-		void add_access(buffer_id bid, std::unique_ptr<range_mapper_base>&& rm) { m_accesses.emplace_back(bid, std::move(rm)); }
+		void add_access(buffer_id bid, unique_range_mapper_ptr&& rm) { m_accesses.emplace_back(bid, std::move(rm)); }
 
 		std::unordered_set<buffer_id> get_accessed_buffers() const;
 		std::unordered_set<cl::sycl::access::mode> get_access_modes(buffer_id bid) const;
@@ -116,29 +146,52 @@ namespace detail {
 		box_vector<3> get_required_contiguous_boxes(const buffer_id bid, const int kernel_dims, const subrange<3>& sr, const range<3>& global_size) const;
 
 	  private:
-		std::vector<std::pair<buffer_id, std::unique_ptr<range_mapper_base>>> m_accesses;
+		// Tasks are stored in-place in the task_ring_buffer, so keeping the typical handful of accesses inline avoids a heap allocation per task
+		gch::small_vector<std::pair<buffer_id, unique_range_mapper_ptr>, 4> m_accesses;
 	};
 
 	using reduction_set = std::vector<reduction_info>;
 
-	class side_effect_map : private std::unordered_map<host_object_id, experimental::side_effect_order> {
+	/// Host objects affected by a task, in the order their side effects were declared. Tasks are stored in-place in the task_ring_buffer and rarely affect
+	/// more than a couple of host objects, so entries are kept inline instead of in a node-based map.
+	class side_effect_map {
 	  private:
-		using map_base = std::unordered_map<host_object_id, experimental::side_effect_order>;
+		using entry_vector = gch::small_vector<std::pair<host_object_id, experimental::side_effect_order>, 2>;
 
 	  public:
-		using typename map_base::const_iterator, map_base::value_type, map_base::key_type, map_base::mapped_type, map_base::const_reference,
-		    map_base::const_pointer;
+		using value_type = entry_vector::value_type;
+		using key_type = host_object_id;
+		using mapped_type = experimental::side_effect_order;
+		using const_iterator = entry_vector::const_iterator;
+		using const_reference = entry_vector::const_reference;
+		using const_pointer = entry_vector::const_pointer;
 		using iterator = const_iterator;
 		using reference = const_reference;
 		using pointer = const_pointer;
 
-		using map_base::size, map_base::count, map_base::empty, map_base::cbegin, map_base::cend, map_base::at;
+		size_t size() const { return m_entries.size(); }
+		bool empty() const { return m_entries.empty(); }
+		size_t count(const host_object_id key) const { return find(key) != end() ? 1 : 0; }
+
+		iterator begin() const { return m_entries.cbegin(); }
+		iterator end() const { return m_entries.cend(); }
+		const_iterator cbegin() const { return m_entries.cbegin(); }
+		const_iterator cend() const { return m_entries.cend(); }
+
+		iterator find(const host_object_id key) const {
+			return std::find_if(m_entries.begin(), m_entries.end(), [=](const value_type& entry) { return entry.first == key; });
+		}
 
-		iterator begin() const { return cbegin(); }
-		iterator end() const { return cend(); }
-		iterator find(host_object_id key) const { return map_base::find(key); }
+		const mapped_type& at(const host_object_id key) const {
+			const auto it = find(key);
+			if(it == end()) { throw std::out_of_range("side_effect_map::at"); }
+			return it->second;
+		}
 
 		void add_side_effect(host_object_id hoid, experimental::side_effect_order order);
+
+	  private:
+		entry_vector m_entries;
 	};
 
 	class fence_promise {
@@ -205,10 +258,16 @@ namespace detail {
 
 		fence_promise* get_fence_promise() const { return m_fence_promise.get(); }
 
+		/// Returns a `device_kernel_launcher` or `host_task_launcher` (see launcher.h) that refers to the command group function of this task.
+		///
+		/// The launcher does not own the function, which lives in the task_ring_buffer slot of the task. This is safe because tasks are only deleted once
+		/// the executor has reached a later horizon or epoch, at which point all instructions generated from the task have completed. Capturing a single
+		/// pointer also allows `std::function` to store the launcher without a heap allocation.
 		template <typename Launcher>
 		Launcher get_launcher() const {
-			return {};
-		} // placeholder
+			if(m_launcher == nullptr) return {};
+			return [launcher = m_launcher.get()](auto&&... args) { (*launcher)(std::forward<decltype(args)>(args)...); };
+		}
 
 		template <typename... Args>
 		auto launch(Args&&... args) const {
@@ -217,7 +276,7 @@ namespace detail {
 
 		void extend_lifetime(std::shared_ptr<lifetime_extending_state> state) { m_attached_state.emplace_back(std::move(state)); }
 
-		void add_hint(std::unique_ptr<hint_base>&& h) { m_hints.emplace_back(std::move(h)); }
+		void add_hint(unique_hint_ptr&& h) { m_hints.emplace_back(std::move(h)); }
 
 		template <typename Hint>
 		const Hint* get_hint() const {
@@ -228,43 +287,41 @@ namespace detail {
 			return nullptr;
 		}
 
-		static std::unique_ptr<task> make_epoch(task_id tid, detail::epoch_action action) {
-			return std::unique_ptr<task>(new task(tid, task_type::epoch, non_collective_group_id, task_geometry{}, nullptr, {}, {}, {}, action, nullptr));
+		// Tasks are returned by value so that they can be moved into their task_ring_buffer slot without an intermediate heap allocation
+		static task make_epoch(task_id tid, detail::epoch_action action) {
+			return task(tid, task_type::epoch, non_collective_group_id, task_geometry{}, nullptr, {}, {}, {}, action, nullptr);
 		}
 
-		static std::unique_ptr<task> make_host_compute(task_id tid, task_geometry geometry, std::unique_ptr<command_launcher_storage_base> launcher,
-		    buffer_access_map access_map, side_effect_map side_effect_map, reduction_set reductions) {
-			return std::unique_ptr<task>(new task(tid, task_type::host_compute, non_collective_group_id, geometry, std::move(launcher), std::move(access_map),
-			    std::move(side_effect_map), std::move(reductions), {}, nullptr));
+		static task make_host_compute(task_id tid, task_geometry geometry, unique_launcher_ptr launcher, buffer_access_map access_map,
+		    side_effect_map side_effect_map, reduction_set reductions) {
+			return task(tid, task_type::host_compute, non_collective_group_id, geometry, std::move(launcher), std::move(access_map), std::move(side_effect_map),
+			    std::move(reductions), {}, nullptr);
 		}
 
-		static std::unique_ptr<task> make_device_compute(task_id tid, task_geometry geometry, std::unique_ptr<command_launcher_storage_base> launcher,
-		    buffer_access_map access_map, reduction_set reductions) {
-			return std::unique_ptr<task>(new task(tid, task_type::device_compute, non_collective_group_id, geometry, std::move(launcher), std::move(access_map),
-			    {}, std::move(reductions), {}, nullptr));
+		static task make_device_compute(
+		    task_id tid, task_geometry geometry, unique_launcher_ptr launcher, buffer_access_map access_map, reduction_set reductions) {
+			return task(tid, task_type::device_compute, non_collective_group_id, geometry, std::move(launcher), std::move(access_map), {}, std::move(reductions),
+			    {}, nullptr);
 		}
 
-		static std::unique_ptr<task> make_collective(task_id tid, collective_group_id cgid, size_t num_collective_nodes,
-		    std::unique_ptr<command_launcher_storage_base> launcher, buffer_access_map access_map, side_effect_map side_effect_map) {
+		static task make_collective(task_id tid, collective_group_id cgid, size_t num_collective_nodes, unique_launcher_ptr launcher,
+		    buffer_access_map access_map, side_effect_map side_effect_map) {
 			const task_geometry geometry{1, detail::range_cast<3>(range(num_collective_nodes)), {}, {1, 1, 1}};
-			return std::unique_ptr<task>(
-			    new task(tid, task_type::collective, cgid, geometry, std::move(launcher), std::move(access_map), std::move(side_effect_map), {}, {}, nullptr));
+			return task(tid, task_type::collective, cgid, geometry, std::move(launcher), std::move(access_map), std::move(side_effect_map), {}, {}, nullptr);
 		}
 
-		static std::unique_ptr<task> make_master_node(
-		    task_id tid, std::unique_ptr<command_launcher_storage_base> launcher, buffer_access_map access_map, side_effect_map side_effect_map) {
-			return std::unique_ptr<task>(new task(tid, task_type::master_node, non_collective_group_id, task_geometry{}, std::move(launcher),
-			    std::move(access_map), std::move(side_effect_map), {}, {}, nullptr));
+		static task make_master_node(task_id tid, unique_launcher_ptr launcher, buffer_access_map access_map, side_effect_map side_effect_map) {
+			return task(tid, task_type::master_node, non_collective_group_id, task_geometry{}, std::move(launcher), std::move(access_map),
+			    std::move(side_effect_map), {}, {}, nullptr);
 		}
 
-		static std::unique_ptr<task> make_horizon(task_id tid) {
-			return std::unique_ptr<task>(new task(tid, task_type::horizon, non_collective_group_id, task_geometry{}, nullptr, {}, {}, {}, {}, nullptr));
+		static task make_horizon(task_id tid) {
+			return task(tid, task_type::horizon, non_collective_group_id, task_geometry{}, nullptr, {}, {}, {}, {}, nullptr);
 		}
 
-		static std::unique_ptr<task> make_fence(
-		    task_id tid, buffer_access_map access_map, side_effect_map side_effect_map, std::unique_ptr<fence_promise> fence_promise) {
-			return std::unique_ptr<task>(new task(tid, task_type::fence, non_collective_group_id, task_geometry{}, nullptr, std::move(access_map),
-			    std::move(side_effect_map), {}, {}, std::move(fence_promise)));
+		static task make_fence(task_id tid, buffer_access_map access_map, side_effect_map side_effect_map, std::unique_ptr<fence_promise> fence_promise) {
+			return task(tid, task_type::fence, non_collective_group_id, task_geometry{}, nullptr, std::move(access_map), std::move(side_effect_map), {}, {},
+			    std::move(fence_promise));
 		}
 
 	  private:
@@ -272,7 +329,7 @@ namespace detail {
 		task_type m_type;
 		collective_group_id m_cgid;
 		task_geometry m_geometry;
-		std::unique_ptr<command_launcher_storage_base> m_launcher;
+		unique_launcher_ptr m_launcher;
 		buffer_access_map m_access_map;
 		detail::side_effect_map m_side_effects;
 		reduction_set m_reductions;
@@ -281,12 +338,12 @@ namespace detail {
 		// TODO I believe that `struct task` should not store command_group_launchers, fence_promise or other state that is related to execution instead of
 		// abstract DAG building. For user-initialized buffers we already notify the runtime -> executor of this state directly. Maybe also do that for these.
 		std::unique_ptr<fence_promise> m_fence_promise;
-		std::vector<std::shared_ptr<lifetime_extending_state>> m_attached_state;
-		std::vector<std::unique_ptr<hint_base>> m_hints;
+		// typically one entry per accessed buffer or host object and only a few hints, stored inline like the accesses in buffer_access_map
+		gch::small_vector<std::shared_ptr<lifetime_extending_state>, 4> m_attached_state;
+		gch::small_vector<unique_hint_ptr, 2> m_hints;
 
-		task(task_id tid, task_type type, collective_group_id cgid, task_geometry geometry, std::unique_ptr<command_launcher_storage_base> launcher,
-		    buffer_access_map access_map, detail::side_effect_map side_effects, reduction_set reductions, detail::epoch_action epoch_action,
-		    std::unique_ptr<fence_promise> fence_promise)
+		task(task_id tid, task_type type, collective_group_id cgid, task_geometry geometry, unique_launcher_ptr launcher, buffer_access_map access_map,
+		    detail::side_effect_map side_effects, reduction_set reductions, detail::epoch_action epoch_action, std::unique_ptr<fence_promise> fence_promise)
 		    : m_tid(tid), m_type(type), m_cgid(cgid), m_geometry(geometry), m_launcher(std::move(launcher)), m_access_map(std::move(access_map)),
 		      m_side_effects(std::move(side_effects)), m_reductions(std::move(reductions)), m_epoch_action(epoch_action),
 		      m_fence_promise(std::move(fence_promise)) {
@@ -1,15 +1,18 @@
 #pragma once
 
+#include <atomic>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "handler.h"
+#include "horizon_policy.h"
 #include "host_queue.h"
-#include "region_map.h"
+#include "interval_map.h"
 #include "task.h"
 #include "task_ring_buffer.h"
 #include "types.h"
@@ -72,17 +75,18 @@ namespace detail {
 			auto reservation = m_task_buffer.reserve_task_entry(await_free_task_slot_callback());
 			const auto tid = reservation.get_tid();
 
-			handler cgh = make_command_group_handler(tid, m_num_collective_nodes);
+			// Range mappers are constructed directly in the storage of the reserved ring buffer slot
+			handler cgh = make_command_group_handler(tid, m_num_collective_nodes, &reservation.get_task_storage());
 			cgf(cgh);
 
-			auto unique_tsk = into_task(std::move(cgh));
+			auto new_tsk = into_task(std::move(cgh));
 
 			// Require the collective group before inserting the task into the ring buffer, otherwise the executor will try to schedule the collective host
 			// task on a collective-group thread that does not yet exist.
 			// The queue pointer will be null in non-runtime tests.
-			if(m_queue) m_queue->require_collective_group(unique_tsk->get_collective_group_id());
+			if(m_queue) m_queue->require_collective_group(new_tsk.get_collective_group_id());
 
-			auto& tsk = register_task_internal(std::move(reservation), std::move(unique_tsk));
+			auto& tsk = register_task_internal(std::move(reservation), std::move(new_tsk));
 			compute_dependencies(tsk);
 
 			// the following deletion is intentionally redundant with the one happening when waiting for free task slots
@@ -162,6 +166,15 @@ namespace detail {
 			m_task_horizon_max_parallelism = para;
 		}
 
+		/// Tunes the horizon step at run time based on the executor lag and graph sizes observed at each horizon, starting from the current step size.
+		/// Decisions are recorded with the corresponding horizon task.
+		void enable_adaptive_horizons() { m_horizon_policy.emplace(m_task_horizon_step_size); }
+
+		int get_horizon_step() const { return m_task_horizon_step_size; }
+
+		/// Submission blocks until a horizon or epoch is reached once live tasks occupy (approximately) this many bytes.
+		void set_task_window_memory_limit(const size_t bytes) { m_task_buffer.set_memory_limit(bytes); }
+
 		/**
 		 * @brief Notifies the task manager that the given horizon has been executed (used for task deletion).
 		 *
@@ -196,7 +209,7 @@ namespace detail {
 
 		struct buffer_state {
 			std::string debug_name;
-			region_map<std::optional<task_id>> last_writers; ///< nullopt for uninitialized regions
+			interval_or_region_map<std::optional<task_id>> last_writers; ///< nullopt for uninitialized regions
 
 			explicit buffer_state(const range<3>& range) : last_writers(range) {}
 		};
@@ -234,6 +247,13 @@ namespace detail {
 		// Maximum number of independent tasks (task graph breadth) allowed in a single horizon step
 		int m_task_horizon_max_parallelism = 64;
 
+		// If set, overrides m_task_horizon_step_size after every horizon
+		std::optional<adaptive_horizon_policy> m_horizon_policy;
+
+		// Generated horizons are counted on the main thread, reached horizons on the executor thread; their difference is the executor lag.
+		size_t m_num_horizons_generated = 0;
+		std::atomic<size_t> m_num_horizons_reached = 0;
+
 		// This only (potentially) grows when adding dependencies,
 		// it never shrinks and does not take into account later changes further up in the dependency chain
 		int m_max_pseudo_critical_path_length = 0;
@@ -251,15 +271,16 @@ namespace detail {
 		// The last epoch task that has been processed by the executor. Behind a monitor to allow awaiting this change from the main thread.
 		epoch_monitor m_latest_epoch_reached{initial_epoch_task};
 
-		// Set of tasks with no dependents
-		std::unordered_set<task*> m_execution_front;
+		// Set of tasks with no dependents. This is bounded by the horizon parallelism in practice, and a vector keeps its capacity across horizons, so
+		// submitting a task does not allocate.
+		std::vector<task*> m_execution_front;
 
 		// An optional task_recorder which records information about tasks for e.g. printing graphs.
 		mutable detail::task_recorder* m_task_recorder;
 
-		task& register_task_internal(task_ring_buffer::reservation&& reserve, std::unique_ptr<task> task);
+		task& register_task_internal(task_ring_buffer::reservation&& reserve, task&& tsk);
 
-		void invoke_callbacks(const task* tsk) const;
+		void invoke_callbacks(const task* tsk, const std::optional<horizon_decision>& decision = std::nullopt) const;
 
 		void add_dependency(task& depender, task& dependee, dependency_kind kind, dependency_origin origin);
 
@@ -267,14 +288,16 @@ namespace detail {
 
 		int get_max_pseudo_critical_path_length() const { return m_max_pseudo_critical_path_length; }
 
-		task& reduce_execution_front(task_ring_buffer::reservation&& reserve, std::unique_ptr<task> new_front);
+		task& reduce_execution_front(task_ring_buffer::reservation&& reserve, task&& new_front);
 
 		void set_epoch_for_new_tasks(task_id epoch);
 
-		const std::unordered_set<task*>& get_execution_front() { return m_execution_front; }
+		const std::vector<task*>& get_execution_front() { return m_execution_front; }
 
 		task_id generate_horizon_task();
 
+		horizon_feedback sample_horizon_feedback() const;
+
 		void compute_dependencies(task& tsk);
 
 		// Finds the first in-flight epoch, or returns the currently reached one if there are none in-flight
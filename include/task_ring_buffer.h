@@ -1,20 +1,49 @@
 #pragma once
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <functional>
 #include <memory>
+#include <optional>
+#include <vector>
 
+#include "arena.h"
 #include "log.h"
 #include "task.h"
 #include "types.h"
 
 namespace celerity::detail {
 
+// Number of task slots per segment of the task store. The store grows and shrinks one segment at a time.
 constexpr unsigned long task_ringbuffer_size = 1024;
 
+// Upper bound for the number of segments holding live tasks at once, i.e. the live task window is limited to roughly four million tasks.
+constexpr size_t max_task_segments = 4096;
+
+// Fully-deleted segments kept around for reuse instead of being freed, so that a steady-state task window does not allocate.
+constexpr size_t max_free_task_segments = 2;
+
+// Default for the approximate memory held by live tasks before submission blocks until a horizon or epoch has been reached.
+constexpr size_t default_task_window_memory_limit = 256 * 1024 * 1024;
+
+// Range mappers, launcher and hints of a typical task fit into a single block of this size; larger ones spill into additional blocks until the slot is
+// recycled.
+constexpr size_t task_slot_storage_block_size = 1024;
+
+/// Stores all live tasks, indexed by task id.
+///
+/// Tasks live in fixed-size segments which are allocated as the window of live tasks grows and recycled once all of their tasks have been deleted, so
+/// task pointers remain stable and growing never moves existing tasks. Reads from other threads (`has_task`, `find_task`, `get_task`) are lock-free and
+/// synchronize with `put` through `m_next_active_tid` and with `delete_up_to` through `m_number_of_deleted_tasks`. Since a reader can still act on a task
+/// id that was deleted concurrently, released segments beyond the reuse quota are only freed after a grace period. Instead of a fixed slot count,
+/// submission is throttled by an (approximate) limit on the memory held by live tasks: `reserve_task_entry` only invokes the wait callback once that limit
+/// has been exceeded.
 class task_ring_buffer {
 	friend struct task_ring_buffer_testspy;
 
+	struct slot;
+
   public:
 	// This is an RAII type for ensuring correct handling of task id reservations
 	// in the presence of exceptions (i.e. revoking the reservation on stack unwinding)
@@ -35,6 +64,9 @@ class task_ring_buffer {
 
 		task_id get_tid() const { return m_tid; }
 
+		// Memory for objects owned by the task that is going to be put into the reserved slot, e.g. its range mappers.
+		arena& get_task_storage() const { return m_buffer.get_slot(m_tid).storage; }
+
 	  private:
 		void consume() {
 			assert(m_consumed == false);
@@ -47,17 +79,25 @@ class task_ring_buffer {
 	};
 
 	bool has_task(task_id tid) const {
-		return tid >= m_number_of_deleted_tasks.load(std::memory_order_relaxed) // best effort, only reliable from application thread
+		return tid >= m_number_of_deleted_tasks.load(std::memory_order_acquire) // synchronizes with delete_up_to(...)
 		       && tid < m_next_active_tid.load(std::memory_order_acquire);      // synchronizes access to data with put(...)
 	}
 
 	size_t get_total_task_count() const { return m_next_active_tid.load(std::memory_order_relaxed); }
 
-	task* find_task(task_id tid) const { return has_task(tid) ? m_data[tid % task_ringbuffer_size].get() : nullptr; }
+	task* find_task(task_id tid) const {
+		if(!has_task(tid)) return nullptr;
+		// On threads other than the application thread, the task may have been deleted since has_task(), leaving its slot empty or re-used by a newer task
+		const auto seg = m_segment_table[(tid / task_ringbuffer_size) % max_task_segments].load(std::memory_order_acquire);
+		if(seg == nullptr) return nullptr;
+		auto& slot = seg->slots[tid % task_ringbuffer_size];
+		if(!slot.tsk.has_value() || slot.tsk->get_id() != tid) return nullptr;
+		return &*slot.tsk;
+	}
 
 	task* get_task(task_id tid) const {
 		assert(has_task(tid));
-		return m_data[tid % task_ringbuffer_size].get();
+		return &*get_slot(tid).tsk;
 	}
 
 	// all member functions beyond this point may *only* be called by the main application thread
@@ -66,11 +106,25 @@ class task_ring_buffer {
 		return m_next_active_tid.load(std::memory_order_relaxed) - m_number_of_deleted_tasks.load(std::memory_order_relaxed);
 	}
 
+	/// Approximate memory held by all live tasks, i.e. the size of each task object plus the storage used for its range mappers.
+	size_t get_live_task_bytes() const { return m_live_task_bytes; }
+
+	size_t get_memory_limit() const { return m_memory_limit; }
+
+	void set_memory_limit(const size_t bytes) {
+		assert(bytes > 0);
+		m_memory_limit = bytes;
+	}
+
+	/// Number of segments that are currently allocated, including the ones kept for reuse and the ones awaiting the end of their grace period.
+	size_t get_allocated_segment_count() const { return m_segments.size(); }
+
 	// the task id passed to the wait callback identifies the lowest in-use TID that the ring buffer is aware of
 	using wait_callback = std::function<void(task_id)>;
 
 	reservation reserve_task_entry(const wait_callback& wc) {
 		wait_for_available_slot(wc);
+		if(m_next_task_id % task_ringbuffer_size == 0) { acquire_segment(m_next_task_id / task_ringbuffer_size); }
 		reservation ret(m_next_task_id, *this);
 		m_next_task_id++;
 		return ret;
@@ -79,29 +133,61 @@ class task_ring_buffer {
 	void revoke_reservation(reservation&& reserve) {
 		reserve.consume();
 		assert(reserve.m_tid == m_next_task_id - 1); // this is the only allowed (and extant) pattern
+		get_slot(reserve.m_tid).storage.reset();
+		if(reserve.m_tid % task_ringbuffer_size == 0) { release_segment(reserve.m_tid / task_ringbuffer_size); }
 		m_next_task_id--;
 	}
 
-	void put(reservation&& reserve, std::unique_ptr<task> task) {
+	task& put(reservation&& reserve, task&& tsk) {
+		auto& emplaced = emplace(reserve, std::move(tsk));
+		publish(std::move(reserve));
+		return emplaced;
+	}
+
+	/// Moves a task into its reserved slot without making it visible to other threads. Since tasks must not be moved once they have dependencies, this
+	/// allows adding dependencies to the task at its final address before `publish` hands it out.
+	task& emplace(reservation& reserve, task&& tsk) {
+		assert(!reserve.m_consumed);
+		assert(m_next_active_tid.load(std::memory_order_relaxed) == reserve.m_tid);
+		auto& slot = get_slot(reserve.m_tid);
+		assert(!slot.tsk.has_value());
+		return slot.tsk.emplace(std::move(tsk));
+	}
+
+	/// Makes the task previously placed through `emplace` visible to other threads.
+	void publish(reservation&& reserve) {
 		reserve.consume();
 		assert(m_next_active_tid.load(std::memory_order_relaxed) == reserve.m_tid);
-		m_data[reserve.m_tid % task_ringbuffer_size] = std::move(task);
+		auto& slot = get_slot(reserve.m_tid);
+		assert(slot.tsk.has_value());
+		slot.accounted_bytes = sizeof(task) + slot.storage.get_allocated_bytes();
+		m_live_task_bytes += slot.accounted_bytes;
 		m_next_active_tid.store(reserve.m_tid + 1, std::memory_order_release);
 	}
 
 	void delete_up_to(task_id target_tid) {
-		assert(target_tid >= m_number_of_deleted_tasks.load(std::memory_order_relaxed));
-		for(task_id tid = m_number_of_deleted_tasks.load(std::memory_order_relaxed); tid < target_tid; ++tid) {
-			m_data[tid % task_ringbuffer_size].reset();
+		const task_id first_tid = m_number_of_deleted_tasks.load(std::memory_order_relaxed);
+		assert(target_tid >= first_tid);
+		for(task_id tid = first_tid; tid < target_tid; ++tid) {
+			recycle(get_slot(tid));
+			// the segment is released once its last slot has been recycled
+			if((tid + 1) % task_ringbuffer_size == 0) { release_segment(tid / task_ringbuffer_size); }
 		}
-		m_number_of_deleted_tasks.store(target_tid, std::memory_order_relaxed);
+		m_number_of_deleted_tasks.store(target_tid, std::memory_order_release);
+		free_retired_segments();
 	}
 
 	void clear() {
-		for(auto&& d : m_data) {
-			d.reset();
+		const task_id first_tid = m_number_of_deleted_tasks.load(std::memory_order_relaxed);
+		for(task_id tid = first_tid; tid < m_next_active_tid.load(std::memory_order_relaxed); ++tid) {
+			recycle(get_slot(tid));
+		}
+		// Segments can only be released in order, so the partially filled segment (if any) holding m_next_task_id is kept for the next reservation
+		for(size_t sid = first_tid / task_ringbuffer_size; sid < m_next_task_id / task_ringbuffer_size; ++sid) {
+			release_segment(sid);
 		}
-		m_number_of_deleted_tasks.store(m_next_task_id, std::memory_order_relaxed);
+		m_number_of_deleted_tasks.store(m_next_task_id, std::memory_order_release);
+		free_retired_segments();
 	}
 
 	class task_buffer_iterator {
@@ -122,16 +208,102 @@ class task_ring_buffer {
 	task_buffer_iterator end() const { return task_buffer_iterator(m_next_task_id, *this); }
 
   private:
+	struct slot {
+		// declared before the task so that the memory outlives the range mappers destroyed along with the task
+		arena storage{task_slot_storage_block_size};
+		std::optional<task> tsk;
+		size_t accounted_bytes = 0; // contribution to m_live_task_bytes
+	};
+
+	struct segment {
+		std::array<slot, task_ringbuffer_size> slots;
+	};
+
+	struct retired_segment {
+		size_t segment_idx;
+		segment* seg;
+	};
+
 	// the id of the next task that will be reserved
 	task_id m_next_task_id = 0;
 	// the next task id that will actually be emplaced
 	std::atomic<task_id> m_next_active_tid = task_id(0);
 	// the number of deleted tasks (which is implicitly the start of the active range of the ringbuffer)
 	std::atomic<size_t> m_number_of_deleted_tasks = 0;
-	std::array<std::unique_ptr<task>, task_ringbuffer_size> m_data;
+
+	// Maps (tid / task_ringbuffer_size) % max_task_segments to the segment holding that task. Entries are published to other threads through the release
+	// store on m_next_active_tid in put(), and an entry is only overwritten once all tasks in the segment it previously pointed to have been deleted.
+	std::unique_ptr<std::atomic<segment*>[]> m_segment_table = std::make_unique<std::atomic<segment*>[]>(max_task_segments);
+	std::vector<std::unique_ptr<segment>> m_segments; // owns all allocated segments, live or free
+	std::vector<segment*> m_free_segments;
+	std::vector<retired_segment> m_retired_segments; ///< released beyond max_free_task_segments, freed once their grace period has passed
+
+	size_t m_live_task_bytes = 0;
+	size_t m_memory_limit = default_task_window_memory_limit;
+
+	slot& get_slot(const task_id tid) const {
+		auto* const seg = m_segment_table[(tid / task_ringbuffer_size) % max_task_segments].load(std::memory_order_relaxed);
+		assert(seg != nullptr);
+		return seg->slots[tid % task_ringbuffer_size];
+	}
+
+	void acquire_segment(const size_t segment_idx) {
+		segment* seg;
+		if(!m_free_segments.empty()) {
+			seg = m_free_segments.back();
+			m_free_segments.pop_back();
+		} else {
+			seg = m_segments.emplace_back(std::make_unique<segment>()).get();
+		}
+		m_segment_table[segment_idx % max_task_segments].store(seg, std::memory_order_relaxed);
+	}
+
+	void release_segment(const size_t segment_idx) {
+		// The table entry keeps pointing to the released segment until it is re-acquired for a later index or freed, so that a reader on another thread
+		// which acts on a concurrently deleted task id finds an empty or re-used slot instead of a dangling pointer
+		auto* const seg = m_segment_table[segment_idx % max_task_segments].load(std::memory_order_relaxed);
+		assert(seg != nullptr);
+		if(m_free_segments.size() < max_free_task_segments) {
+			m_free_segments.push_back(seg);
+		} else {
+			m_retired_segments.push_back(retired_segment{segment_idx, seg});
+		}
+	}
+
+	/// Frees retired segments once another full segment worth of tasks has been deleted after them. Tasks are only deleted once the executor has reached a
+	/// later horizon, so by then no reader can still be acting on a task id from a retired segment.
+	void free_retired_segments() {
+		const auto num_deleted = m_number_of_deleted_tasks.load(std::memory_order_relaxed);
+		const auto grace_period_over = [&](const retired_segment& r) { return num_deleted >= (r.segment_idx + 2) * task_ringbuffer_size; };
+		for(const auto& retired : m_retired_segments) {
+			if(!grace_period_over(retired)) continue;
+			auto expected = retired.seg;
+			m_segment_table[retired.segment_idx % max_task_segments].compare_exchange_strong(expected, nullptr, std::memory_order_relaxed);
+			const auto it = std::find_if(m_segments.begin(), m_segments.end(), [&](const auto& s) { return s.get() == retired.seg; });
+			assert(it != m_segments.end());
+			std::swap(*it, m_segments.back());
+			m_segments.pop_back();
+		}
+		m_retired_segments.erase(
+		    std::remove_if(m_retired_segments.begin(), m_retired_segments.end(), grace_period_over), m_retired_segments.end());
+	}
+
+	void recycle(slot& s) {
+		m_live_task_bytes -= s.accounted_bytes;
+		s.accounted_bytes = 0;
+		s.tsk.reset();
+		s.storage.reset();
+	}
+
+	bool is_window_exhausted() const {
+		const auto num_live_tasks = m_next_task_id - m_number_of_deleted_tasks.load(std::memory_order_relaxed);
+		// keep one segment in reserve so that the segment table entry of a new segment never aliases a live one
+		return m_live_task_bytes >= m_memory_limit || num_live_tasks >= (max_task_segments - 1) * task_ringbuffer_size;
+	}
 
 	void wait_for_available_slot(const wait_callback& wc) const {
-		if(m_next_task_id - m_number_of_deleted_tasks.load(std::memory_order_relaxed) >= task_ringbuffer_size) {
+		// every invocation of the callback deletes at least one task (or throws), so this terminates
+		while(is_window_exhausted()) {
 			wc(static_cast<task_id>(m_number_of_deleted_tasks.load(std::memory_order_relaxed)));
 		}
 	}
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <bitset>
 #include <cassert>
 #include <cstdint>
 #include <functional>
@@ -43,6 +44,35 @@ constexpr inline uint32_t popcount(const BitMaskT bit_mask) noexcept {
 	return counter;
 }
 
+/// Returns the index of the lowest set bit in a non-zero word.
+inline uint32_t count_trailing_zeros(const uint64_t word) noexcept {
+	assert(word != 0);
+#if defined(__GNUC__) || defined(__clang__)
+	return static_cast<uint32_t>(__builtin_ctzll(word));
+#else
+	uint32_t counter = 0;
+	for(auto w = word; (w & 1) == 0; w >>= 1) {
+		++counter;
+	}
+	return counter;
+#endif
+}
+
+/// Invokes `f(i)` for every set bit `i` in ascending order. The bitset is scanned one 64-bit word at a time, so the cost depends on the number of words
+/// and set bits rather than on the number of bits.
+template <size_t N, typename Functor>
+void for_each_set_bit(const std::bitset<N>& bits, const Functor& f) {
+	constexpr size_t word_bits = 64;
+	const std::bitset<N> word_mask(~uint64_t{0});
+	for(size_t first = 0; first < N; first += word_bits) {
+		const auto remaining = bits >> first;
+		if(remaining.none()) break;
+		for(auto word = static_cast<uint64_t>((remaining & word_mask).to_ullong()); word != 0; word &= word - 1) {
+			f(first + count_trailing_zeros(word));
+		}
+	}
+}
+
 // Implementation from Boost.ContainerHash, licensed under the Boost Software License, Version 1.0.
 inline void hash_combine(std::size_t& seed, std::size_t value) { seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2); }
 
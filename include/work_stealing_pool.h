@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace celerity::detail {
+
+/// Thread pool where every worker owns a deque of jobs and steals from its peers once it runs dry.
+///
+/// Submitted jobs are distributed round-robin across the worker deques. A worker takes jobs from the front of its own deque (preserving submission order
+/// for a single worker) and steals from the back of other workers' deques, so a worker blocked on a long-running job does not hold back the jobs queued
+/// behind it. Each deque is protected by its own mutex, which is only ever contended by a thief and the submitting thread.
+class work_stealing_pool {
+  public:
+	using job = std::packaged_task<void()>;
+
+	/// Spawns `num_workers` threads named `{thread_name_prefix}.{i}`. If `core_ids` is non-empty, worker `i` is pinned to `core_ids[i % core_ids.size()]`.
+	explicit work_stealing_pool(size_t num_workers, const std::string& thread_name_prefix, const std::vector<uint32_t>& core_ids = {});
+
+	work_stealing_pool(const work_stealing_pool&) = delete;
+	work_stealing_pool(work_stealing_pool&&) = delete;
+	work_stealing_pool& operator=(const work_stealing_pool&) = delete;
+	work_stealing_pool& operator=(work_stealing_pool&&) = delete;
+
+	~work_stealing_pool();
+
+	size_t get_num_workers() const { return m_workers.size(); }
+
+	/// Thread-safe.
+	void submit(job j);
+
+	/// Waits until all submitted jobs have completed and joins all worker threads. No jobs must be submitted after calling `stop`.
+	void stop();
+
+  private:
+	struct alignas(64) worker {
+		std::mutex mutex;
+		std::deque<job> jobs;
+		std::thread thread;
+	};
+
+	std::vector<std::unique_ptr<worker>> m_workers;
+	std::atomic<size_t> m_next_worker{0};
+
+	// Number of jobs in all deques combined. Incremented before a job is enqueued, so a worker might briefly observe a count > 0 without finding a job.
+	std::atomic<size_t> m_num_queued{0};
+	std::mutex m_sleep_mutex;
+	std::condition_variable m_sleep_cv;
+	bool m_stop_requested = false; // protected by m_sleep_mutex
+
+	std::optional<job> try_acquire(size_t worker_idx);
+	void work(size_t worker_idx);
+};
+
+} // namespace celerity::detail
@@ -37,7 +37,7 @@ namespace detail {
 
 	  protected:
 		template <typename... Es>
-		explicit worker_job(command_pkg pkg, std::tuple<Es...> ctx = {}) : m_pkg(pkg), m_lctx(make_log_context(pkg, ctx)) {}
+		explicit worker_job(command_pkg pkg, std::tuple<Es...> ctx = {}) : m_pkg(std::move(pkg)), m_lctx(make_log_context(m_pkg, ctx)) {}
 
 	  private:
 		command_pkg m_pkg;
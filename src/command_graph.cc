@@ -1,5 +1,7 @@
 #include "command_graph.h"
 
+#include <algorithm>
+
 namespace celerity {
 namespace detail {
 
@@ -9,19 +11,37 @@ namespace detail {
 			m_by_task[tcmd->get_tid()].erase(std::find(m_by_task[tcmd->get_tid()].begin(), m_by_task[tcmd->get_tid()].end(), cmd));
 		}
 		m_execution_front.erase(cmd);
-		m_commands.erase(cmd->get_cid());
+		const auto cid = cmd->get_cid();
+		m_commands.erase(cid);
+		release_segment_of(cid);
 	}
 
 
 	void command_graph::erase_if(std::function<bool(abstract_command*)> condition) {
 		for(auto it = m_commands.begin(); it != m_commands.end();) {
 			if(condition(it->second.get())) {
+				const auto cid = it->first;
 				it = m_commands.erase(it);
+				release_segment_of(cid);
 			} else {
 				++it;
 			}
 		}
 	}
 
+	void command_graph::release_segment_of(const command_id cid) {
+		// Segments are ordered by the id of their first command
+		auto segment = std::upper_bound(m_segments.begin(), m_segments.end(), cid, [](const command_id c, const storage_segment& s) { return c < s.first_cid; });
+		assert(segment != m_segments.begin());
+		--segment;
+		assert(segment->num_live_commands > 0);
+		--segment->num_live_commands;
+
+		// Release all leading segments that have become empty. The last segment is kept around, since it receives new commands.
+		while(m_segments.size() > 1 && m_segments.front().num_live_commands == 0) {
+			m_segments.pop_front();
+		}
+	}
+
 } // namespace detail
 } // namespace celerity
@@ -81,6 +81,12 @@ size_t parse_validate_dry_run_nodes(const std::string_view str) {
 	return drn;
 }
 
+size_t parse_validate_task_window_memory(const std::string_view str) {
+	const size_t bytes = env::default_parser<size_t>{}(str);
+	if(bytes == 0) throw env::validation_error{"CELERITY_TASK_WINDOW_MEMORY must be a positive number of bytes"};
+	return bytes;
+}
+
 std::vector<size_t> parse_validate_devices(const std::string_view str, const celerity::detail::host_config host_cfg) {
 	std::vector<size_t> devices;
 	const auto split_str = split(str, ' ');
@@ -159,6 +165,11 @@ namespace detail {
 		constexpr int horizon_max = 1024 * 64;
 		const auto env_horizon_step = pref.register_range<int>("HORIZON_STEP", 1, horizon_max);
 		const auto env_horizon_max_para = pref.register_range<int>("HORIZON_MAX_PARALLELISM", 1, horizon_max);
+		const auto env_adaptive_horizons = pref.register_variable<bool>("ADAPTIVE_HORIZONS");
+		const auto env_scheduler_lookahead = pref.register_range<int>("SCHEDULER_LOOKAHEAD", 0, horizon_max);
+		const auto env_live_executor = pref.register_variable<bool>("LIVE_EXECUTOR");
+		const auto env_task_window_memory = pref.register_variable<size_t>("TASK_WINDOW_MEMORY", parse_validate_task_window_memory);
+		const auto env_graph_generation_threads = pref.register_range<int>("GRAPH_GENERATION_THREADS", 0, 256);
 		[[maybe_unused]] const auto env_gpmv = pref.register_variable<size_t>("GRAPH_PRINT_MAX_VERTS", parse_validate_graph_print_max_verts);
 		[[maybe_unused]] const auto env_force_wg =
 		    pref.register_variable<bool>("FORCE_WG", [](const std::string_view str) { return parse_validate_force_wg(str); });
@@ -197,6 +208,11 @@ namespace detail {
 			m_should_print_graphs = parsed_and_validated_envs.get_or(env_print_graphs, false);
 			m_horizon_step = parsed_and_validated_envs.get(env_horizon_step);
 			m_horizon_max_parallelism = parsed_and_validated_envs.get(env_horizon_max_para);
+			m_use_adaptive_horizons = parsed_and_validated_envs.get_or(env_adaptive_horizons, false);
+			m_scheduler_lookahead = parsed_and_validated_envs.get(env_scheduler_lookahead);
+			m_use_live_executor = parsed_and_validated_envs.get_or(env_live_executor, false);
+			m_task_window_memory_limit = parsed_and_validated_envs.get(env_task_window_memory);
+			m_graph_generation_threads = parsed_and_validated_envs.get(env_graph_generation_threads);
 
 		} else {
 			for(const auto& warn : parsed_and_validated_envs.warnings()) {
@@ -0,0 +1,95 @@
+#include "cost_model.h"
+
+#include <algorithm>
+#include <optional>
+#include <typeinfo>
+
+#include "instruction_graph.h"
+
+namespace celerity::detail {
+
+namespace {
+
+	std::chrono::nanoseconds to_nanoseconds(const double ns) { return std::chrono::nanoseconds(static_cast<std::chrono::nanoseconds::rep>(ns)); }
+
+	/// Kernel identity and execution range area of device kernels and host tasks. Instructions with an empty launcher (as in tests) are not calibrated.
+	struct kernel_signature {
+		std::type_index key;
+		size_t area;
+	};
+
+	std::optional<kernel_signature> get_kernel_signature(const instruction& instr) {
+		return matchbox::match(
+		    instr, //
+		    [](const device_kernel_instruction& dkinstr) {
+			    if(!dkinstr.get_launcher()) return std::optional<kernel_signature>();
+			    return std::optional{kernel_signature{dkinstr.get_launcher().target_type(), dkinstr.get_execution_range().get_area()}};
+		    },
+		    [](const host_task_instruction& htinstr) {
+			    if(!htinstr.get_launcher()) return std::optional<kernel_signature>();
+			    return std::optional{kernel_signature{htinstr.get_launcher().target_type(), htinstr.get_execution_range().get_area()}};
+		    },
+		    [](const auto& /* other */) { return std::optional<kernel_signature>(); });
+	}
+
+} // namespace
+
+std::chrono::nanoseconds static_cost_model::estimate(const instruction& instr) const {
+	const auto& p = m_params;
+	const auto transfer = [&](const size_t bytes) { return p.transfer_latency + to_nanoseconds(static_cast<double>(bytes) / p.transfer_bytes_per_ns); };
+	const auto receive = [&](const receive_instruction_impl& rinstr) { return transfer(rinstr.get_requested_region().get_area() * rinstr.get_element_size()); };
+	return matchbox::match(
+	    instr, //
+	    [&](const alloc_instruction& /* ainstr */) { return p.alloc_duration; },
+	    [&](const free_instruction& /* finstr */) { return p.free_duration; },
+	    [&](const copy_instruction& cinstr) {
+		    const auto bytes = cinstr.get_copy_region().get_area() * cinstr.get_element_size();
+		    return p.copy_overhead + to_nanoseconds(static_cast<double>(bytes) / p.copy_bytes_per_ns);
+	    },
+	    [&](const device_kernel_instruction& dkinstr) {
+		    return p.kernel_launch_overhead + to_nanoseconds(static_cast<double>(dkinstr.get_execution_range().get_area()) * p.kernel_ns_per_item);
+	    },
+	    [&](const host_task_instruction& htinstr) {
+		    return p.host_task_overhead + to_nanoseconds(static_cast<double>(htinstr.get_execution_range().get_area()) * p.host_task_ns_per_item);
+	    },
+	    [&](const linearize_instruction& linstr) {
+		    return p.copy_overhead + to_nanoseconds(static_cast<double>(linstr.get_staging_size_bytes()) / p.copy_bytes_per_ns);
+	    },
+	    [&](const send_instruction& sinstr) { return transfer(sinstr.get_send_range().size() * sinstr.get_element_size()); },
+	    [&](const receive_instruction& rinstr) { return receive(rinstr); },
+	    [&](const split_receive_instruction& srinstr) { return receive(srinstr); },
+	    // the element size is not known to an await-receive, so we assume one byte per element as a lower bound
+	    [&](const await_receive_instruction& arinstr) { return transfer(arinstr.get_received_region().get_area()); },
+	    [&](const gather_receive_instruction& grinstr) { return transfer(grinstr.get_node_chunk_size()); },
+	    [&](const fill_identity_instruction& fiinstr) { return to_nanoseconds(static_cast<double>(fiinstr.get_num_values()) * p.reduce_ns_per_value); },
+	    [&](const reduce_instruction& rinstr) { return to_nanoseconds(static_cast<double>(rinstr.get_num_source_values()) * p.reduce_ns_per_value); },
+	    [](const auto& /* other */) { return std::chrono::nanoseconds(0); });
+}
+
+std::chrono::nanoseconds calibrated_cost_model::estimate(const instruction& instr) const {
+	if(const auto sig = get_kernel_signature(instr)) {
+		std::lock_guard lock(m_mutex);
+		if(const auto it = m_ns_per_item.find(sig->key); it != m_ns_per_item.end()) {
+			return to_nanoseconds(it->second * static_cast<double>(std::max<size_t>(sig->area, 1)));
+		}
+	}
+	return static_cost_model::estimate(instr);
+}
+
+void calibrated_cost_model::observe(const instruction& instr, const std::chrono::nanoseconds elapsed) {
+	const auto sig = get_kernel_signature(instr);
+	if(!sig.has_value()) return;
+
+	const auto ns_per_item = static_cast<double>(elapsed.count()) / static_cast<double>(std::max<size_t>(sig->area, 1));
+	std::lock_guard lock(m_mutex);
+	if(const auto [it, inserted] = m_ns_per_item.emplace(sig->key, ns_per_item); !inserted) {
+		it->second += smoothing_factor * (ns_per_item - it->second);
+	}
+}
+
+size_t calibrated_cost_model::get_num_calibrated_kernels() const {
+	std::lock_guard lock(m_mutex);
+	return m_ns_per_item.size();
+}
+
+} // namespace celerity::detail
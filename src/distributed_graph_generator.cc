@@ -7,6 +7,10 @@
 #include "split.h"
 #include "task.h"
 #include "task_manager.h"
+#include "work_stealing_pool.h"
+
+#include <exception>
+#include <future>
 
 namespace celerity::detail {
 
@@ -29,6 +33,55 @@ distributed_graph_generator::distributed_graph_generator(
 	m_epoch_for_new_commands = epoch_cmd->get_cid();
 }
 
+distributed_graph_generator::~distributed_graph_generator() = default;
+
+void distributed_graph_generator::enable_parallel_generation(const size_t num_workers) {
+	assert(num_workers > 0);
+	m_worker_pool = std::make_unique<work_stealing_pool>(num_workers, "cy-dggen");
+}
+
+// Spreading fewer items across threads costs more in synchronization than it saves.
+constexpr size_t min_items_for_parallel_generation = 16;
+
+template <typename Functor>
+void distributed_graph_generator::parallel_for(const size_t n, const Functor& f) {
+	if(m_worker_pool == nullptr || n < min_items_for_parallel_generation) {
+		for(size_t i = 0; i < n; ++i) {
+			f(i);
+		}
+		return;
+	}
+
+	// Contiguous batches, one per worker plus one for the calling thread, which would otherwise sit idle
+	const auto num_batches = std::min(n, m_worker_pool->get_num_workers() + 1);
+	const auto run_batch = [&](const size_t batch) {
+		for(size_t i = n * batch / num_batches; i < n * (batch + 1) / num_batches; ++i) {
+			f(i);
+		}
+	};
+	std::vector<std::future<void>> batches;
+	batches.reserve(num_batches - 1);
+	for(size_t batch = 1; batch < num_batches; ++batch) {
+		work_stealing_pool::job job([&run_batch, batch] { run_batch(batch); });
+		batches.push_back(job.get_future());
+		m_worker_pool->submit(std::move(job));
+	}
+
+	// All batches reference our stack frame, so we must wait for every one of them before propagating an exception
+	std::exception_ptr error;
+	try {
+		run_batch(0);
+	} catch(...) { error = std::current_exception(); }
+	for(auto& batch : batches) {
+		try {
+			batch.get();
+		} catch(...) {
+			if(error == nullptr) { error = std::current_exception(); }
+		}
+	}
+	if(error != nullptr) { std::rethrow_exception(error); }
+}
+
 void distributed_graph_generator::notify_buffer_created(const buffer_id bid, const range<3>& range, bool host_initialized) {
 	m_buffers.emplace(std::piecewise_construct, std::tuple{bid}, std::tuple{range, range});
 	if(host_initialized && m_policy.uninitialized_read_error != error_policy::ignore) { m_buffers.at(bid).initialized_region = box(subrange({}, range)); }
@@ -222,6 +275,114 @@ void distributed_graph_generator::generate_distributed_commands(const task& tsk)
 	const box<3> empty_reduction_box({0, 0, 0}, {0, 0, 0});
 	const box<3> scalar_reduction_box({0, 0, 0}, {1, 1, 1});
 
+	// Range mappers are evaluated for all chunks up front, which allows spreading the work across the worker pool
+	std::vector<buffer_requirements_map> chunk_requirements(chunks.size());
+	parallel_for(chunks.size(), [&](const size_t i) {
+		const node_id nid = (i / chunks_per_node) % m_num_nodes;
+		auto& requirements = chunk_requirements[i];
+		requirements = get_buffer_requirements_for_mapped_access(tsk, chunks[i], tsk.get_global_size());
+
+		// Add requirements for reductions
+		for(const auto& reduction : tsk.get_reductions()) {
+			auto rmode = access_mode::discard_write;
+			if(nid == reduction_initializer_nid && reduction.init_from_buffer) { rmode = access_mode::read_write; }
+#ifndef NDEBUG
+			for(auto pmode : access::producer_modes) {
+				assert(requirements[reduction.bid].count(pmode) == 0); // task_manager verifies that there are no reduction <-> write-access conflicts
+			}
+#endif
+			requirements[reduction.bid][rmode] = scalar_reduction_box;
+		}
+	});
+
+	std::vector<std::vector<size_t>> chunks_by_node(m_num_nodes);
+	for(size_t i = 0; i < chunks.size(); ++i) {
+		chunks_by_node[(i / chunks_per_node) % m_num_nodes].push_back(i);
+	}
+
+	// For every buffer read by remote chunks, determine which parts of the locally owned data each remote node is still missing. Instead of querying
+	// replicated_regions once per remote chunk and testing a single node bit per entry, we sweep over the relevant entries once and mask the bitset of
+	// all reading nodes with the replication state word by word, so fully replicated entries cost a few word operations regardless of the node count.
+	std::unordered_map<buffer_id, std::vector<region<3>>> per_buffer_unreplicated_regions;
+	{
+		std::unordered_map<buffer_id, std::pair<node_bitset, box_vector<3>>> remote_reads;
+		for(size_t i = 0; i < chunks.size(); ++i) {
+			const node_id nid = (i / chunks_per_node) % m_num_nodes;
+			if(nid == m_local_nid) continue;
+			for(const auto& [bid, reqs_by_mode] : chunk_requirements[i]) {
+				if(m_buffers.at(bid).pending_reduction.has_value()) continue;
+				for(const auto& [mode, req] : reqs_by_mode) {
+					if(!detail::access::mode_traits::is_consumer(mode) || req.empty()) continue;
+					auto& [readers, read_boxes] = remote_reads[bid];
+					readers.set(nid);
+					read_boxes.insert(read_boxes.end(), req.get_boxes().begin(), req.get_boxes().end());
+				}
+			}
+		}
+
+		std::vector<std::pair<buffer_id, std::pair<node_bitset, box_vector<3>>>> sweeps(remote_reads.begin(), remote_reads.end());
+		std::vector<std::vector<region<3>>> sweep_results(sweeps.size());
+		parallel_for(sweeps.size(), [&](const size_t s) {
+			auto& [bid, reads] = sweeps[s];
+			auto& [readers, read_boxes] = reads;
+			const auto& buffer = m_buffers.at(bid);
+			box_vector<3> owned_boxes;
+			for(const auto& [box, wcs] : buffer.local_last_writer.get_region_values(region<3>(std::move(read_boxes)))) {
+				if(wcs.is_fresh() && !wcs.is_replicated()) { owned_boxes.push_back(box); }
+			}
+			if(owned_boxes.empty()) return;
+
+			std::vector<box_vector<3>> unreplicated_boxes(m_num_nodes);
+			for(const auto& entry : buffer.replicated_regions.get_region_values(region<3>(std::move(owned_boxes)))) {
+				utils::for_each_set_bit(readers & ~entry.second, [&](const size_t nid) { unreplicated_boxes[nid].push_back(entry.first); });
+			}
+			auto& unreplicated = sweep_results[s];
+			unreplicated.reserve(m_num_nodes);
+			for(auto& boxes : unreplicated_boxes) {
+				unreplicated.emplace_back(std::move(boxes));
+			}
+		});
+		for(size_t s = 0; s < sweeps.size(); ++s) {
+			if(!sweep_results[s].empty()) { per_buffer_unreplicated_regions.emplace(sweeps[s].first, std::move(sweep_results[s])); }
+		}
+	}
+
+	// Plan the pushes for all remote chunks. Nodes are independent of each other, but the chunks of one node must be processed in order so that a
+	// region pushed for one chunk is not pushed again for a later one. Commands are only created afterwards, in chunk order on this thread.
+	struct planned_push {
+		access_mode mode;
+		write_command_state source;
+		region<3> push_region;
+	};
+	std::vector<std::unordered_map<buffer_id, std::vector<planned_push>>> push_plans(chunks.size());
+	parallel_for(m_num_nodes, [&](const size_t nid) {
+		if(nid == m_local_nid) return;
+		for(const auto i : chunks_by_node[nid]) {
+			for(const auto& [bid, reqs_by_mode] : chunk_requirements[i]) {
+				const auto unreplicated_it = per_buffer_unreplicated_regions.find(bid);
+				if(unreplicated_it == per_buffer_unreplicated_regions.end()) continue; // nothing we own is missing on any remote node
+				auto& unreplicated = unreplicated_it->second[nid];
+				const auto& buffer = m_buffers.at(bid);
+				for(const auto mode : detail::access::all_modes) {
+					const auto req_it = reqs_by_mode.find(mode);
+					if(req_it == reqs_by_mode.end() || req_it->second.empty() || !detail::access::mode_traits::is_consumer(mode)) continue;
+
+					// We generate separate push command for each last writer command for now, possibly even multiple for partially already-replicated data.
+					// TODO: Can and/or should we consolidate?
+					for(const auto& [local_box, wcs] : buffer.local_last_writer.get_region_values(req_it->second)) {
+						if(!wcs.is_fresh() || wcs.is_replicated()) { continue; }
+
+						// Make sure we don't push anything we've already pushed to this node before
+						auto push_region = region_intersection(unreplicated, local_box);
+						if(push_region.empty()) continue;
+						unreplicated = region_difference(unreplicated, push_region);
+						push_plans[i][bid].push_back(planned_push{mode, wcs, std::move(push_region)});
+					}
+				}
+			}
+		}
+	});
+
 	// Iterate over all chunks, distinguish between local / remote chunks and normal / reduction access.
 	//
 	// Normal buffer access:
@@ -239,20 +400,7 @@ void distributed_graph_generator::generate_distributed_commands(const task& tsk)
 	for(size_t i = 0; i < chunks.size(); ++i) {
 		const node_id nid = (i / chunks_per_node) % m_num_nodes;
 		const bool is_local_chunk = nid == m_local_nid;
-
-		auto requirements = get_buffer_requirements_for_mapped_access(tsk, chunks[i], tsk.get_global_size());
-
-		// Add requirements for reductions
-		for(const auto& reduction : tsk.get_reductions()) {
-			auto rmode = access_mode::discard_write;
-			if(nid == reduction_initializer_nid && reduction.init_from_buffer) { rmode = access_mode::read_write; }
-#ifndef NDEBUG
-			for(auto pmode : access::producer_modes) {
-				assert(requirements[reduction.bid].count(pmode) == 0); // task_manager verifies that there are no reduction <-> write-access conflicts
-			}
-#endif
-			requirements[reduction.bid][rmode] = scalar_reduction_box;
-		}
+		auto& requirements = chunk_requirements[i];
 
 		abstract_command* cmd = nullptr;
 		if(is_local_chunk) {
@@ -357,35 +505,25 @@ void distributed_graph_generator::generate_distributed_commands(const task& tsk)
 							buffer.local_last_writer.update_region(missing_parts, {ap_cmd->get_cid(), true /* is_replicated */});
 						}
 					} else if(!is_pending_reduction) {
-						// We generate separate push command for each last writer command for now, possibly even multiple for partially already-replicated data.
-						// TODO: Can and/or should we consolidate?
-						const auto local_sources = buffer.local_last_writer.get_region_values(req);
-						for(const auto& [local_box, wcs] : local_sources) {
-							if(!wcs.is_fresh() || wcs.is_replicated()) { continue; }
-
-							// Make sure we don't push anything we've already pushed to this node before
-							box_vector<3> non_replicated_boxes;
-							for(const auto& [replicated_box, nodes] : buffer.replicated_regions.get_region_values(local_box)) {
-								if(nodes.test(nid)) continue;
-								non_replicated_boxes.push_back(replicated_box);
-							}
-
-							// Merge all connected boxes to determine final set of pushes
-							const auto push_region = region<3>(std::move(non_replicated_boxes));
-							for(auto& push_box : push_region.get_boxes()) {
-								auto* const push_cmd =
-								    create_command<push_command>(nid, transfer_id(tsk.get_id(), bid, no_reduction_id), push_box.get_subrange());
-								assert(!utils::isa<await_push_command>(m_cdag.get(wcs)) && "Attempting to push non-owned data?!");
-								m_cdag.add_dependency(push_cmd, m_cdag.get(wcs), dependency_kind::true_dep, dependency_origin::dataflow);
-								generated_pushes.push_back(push_cmd);
-
-								// Store the read access for determining anti-dependencies later on
-								m_command_buffer_reads[push_cmd->get_cid()][bid] = push_box;
-							}
-
-							// Remember that we've replicated this region
-							for(const auto& [replicated_box, nodes] : buffer.replicated_regions.get_region_values(push_region)) {
-								buffer.replicated_regions.update_box(replicated_box, node_bitset{nodes}.set(nid));
+						// Pushes were already determined above, but commands are created here to keep command ids in chunk order
+						if(const auto plan_it = push_plans[i].find(bid); plan_it != push_plans[i].end()) {
+							for(const auto& [push_mode, wcs, push_region] : plan_it->second) {
+								if(push_mode != mode) continue;
+								for(auto& push_box : push_region.get_boxes()) {
+									auto* const push_cmd =
+									    create_command<push_command>(nid, transfer_id(tsk.get_id(), bid, no_reduction_id), push_box.get_subrange());
+									assert(!utils::isa<await_push_command>(m_cdag.get(wcs)) && "Attempting to push non-owned data?!");
+									m_cdag.add_dependency(push_cmd, m_cdag.get(wcs), dependency_kind::true_dep, dependency_origin::dataflow);
+									generated_pushes.push_back(push_cmd);
+
+									// Store the read access for determining anti-dependencies later on
+									m_command_buffer_reads[push_cmd->get_cid()][bid] = push_box;
+								}
+
+								// Remember that we've replicated this region
+								for(const auto& [replicated_box, nodes] : buffer.replicated_regions.get_region_values(push_region)) {
+									buffer.replicated_regions.update_box(replicated_box, node_bitset{nodes}.set(nid));
+								}
 							}
 						}
 					}
@@ -1,7 +1,5 @@
 #include "executor.h"
 
-#include <queue>
-
 #include "closure_hydrator.h"
 #include "distr_queue.h"
 #include "frame.h"
@@ -45,11 +43,46 @@ namespace detail {
 		    m_metrics.device_idle.get().count(), m_metrics.starvation.get().count());
 	}
 
+	void job_dependency_tracker::add(
+	    const command_id cid, const command_id* const dependencies_begin, const command_id* const dependencies_end, const bool prioritize) {
+		auto& n = m_nodes[cid];
+		assert(n.dependents.empty() && n.unsatisfied_dependencies == 0);
+		n.prioritize = prioritize;
+		for(auto dep = dependencies_begin; dep != dependencies_end; ++dep) {
+			if(const auto it = m_nodes.find(*dep); it != m_nodes.end()) {
+				it->second.dependents.push_back(cid);
+				n.unsatisfied_dependencies++;
+			}
+		}
+		if(n.unsatisfied_dependencies == 0) { push_ready(cid, prioritize); }
+	}
+
+	std::optional<command_id> job_dependency_tracker::pop_ready() {
+		auto& queue = !m_ready_prioritized.empty() ? m_ready_prioritized : m_ready;
+		if(queue.empty()) return std::nullopt;
+		const auto cid = queue.front();
+		queue.pop_front();
+		return cid;
+	}
+
+	void job_dependency_tracker::complete(const command_id cid) {
+		const auto it = m_nodes.find(cid);
+		assert(it != m_nodes.end());
+		assert(it->second.unsatisfied_dependencies == 0);
+		for(const auto dcid : it->second.dependents) {
+			auto& dependent = m_nodes.at(dcid);
+			assert(dependent.unsatisfied_dependencies > 0);
+			if(--dependent.unsatisfied_dependencies == 0) { push_ready(dcid, dependent.prioritize); }
+		}
+		m_nodes.erase(it);
+	}
+
+	void job_dependency_tracker::push_ready(const command_id cid, const bool prioritize) { (prioritize ? m_ready_prioritized : m_ready).push_back(cid); }
+
 	void executor::run() {
 		closure_hydrator::make_available();
-		bool done = false;
 
-		while(!done || !m_jobs.empty()) {
+		while(!m_shutdown_reached || !m_jobs.empty()) {
 			// Bail if a device error ocurred.
 			if(m_running_device_compute_jobs > 0) { m_d_queue.get_sycl_queue().throw_asynchronous(); }
 
@@ -59,72 +92,27 @@ namespace detail {
 			// The BTM uses non-blocking MPI routines internally, making this a relatively cheap operation.
 			m_btm->poll();
 
-			std::vector<command_id> ready_jobs;
-			for(auto it = m_jobs.begin(); it != m_jobs.end();) {
-				auto& job_handle = it->second;
-
-				if(job_handle.unsatisfied_dependencies > 0) {
-					++it;
-					continue;
-				}
-
-				if(!job_handle.job->is_running()) {
-					if(std::find(ready_jobs.cbegin(), ready_jobs.cend(), it->first) == ready_jobs.cend()) { ready_jobs.push_back(it->first); }
-					++it;
-					continue;
-				}
-
-				if(!job_handle.job->is_done()) {
-					job_handle.job->update();
-					++it;
-					continue;
+			// Only jobs with outstanding asynchronous work need to be polled - jobs waiting on dependencies are started once they become ready.
+			for(size_t i = 0; i < m_polled_jobs.size();) {
+				const auto cid = m_polled_jobs[i];
+				auto& job = *m_jobs.at(cid);
+				job.update();
+				if(job.is_done()) {
+					m_polled_jobs[i] = m_polled_jobs.back();
+					m_polled_jobs.pop_back();
+					retire_job(cid);
+				} else {
+					++i;
 				}
-
-				for(const auto& d : job_handle.dependents) {
-					assert(m_jobs.count(d) == 1);
-					m_jobs[d].unsatisfied_dependencies--;
-					if(m_jobs[d].unsatisfied_dependencies == 0) { ready_jobs.push_back(d); }
-				}
-
-				if(utils::isa<device_execute_job>(job_handle.job.get())) {
-					m_running_device_compute_jobs--;
-				} else if(const auto epoch = dynamic_cast<epoch_job*>(job_handle.job.get()); epoch && epoch->get_epoch_action() == epoch_action::shutdown) {
-					assert(m_command_queue.empty());
-					done = true;
-				}
-
-				it = m_jobs.erase(it);
 			}
 
-			// Process newly available jobs
-			if(!ready_jobs.empty()) {
-				// Make sure to start any push jobs before other jobs, as on some platforms copying data from a compute device while
-				// also reading it from within a kernel is not supported. To avoid stalling other nodes, we thus perform the push first.
-				std::sort(ready_jobs.begin(), ready_jobs.end(),
-				    [this](command_id a, command_id b) { return m_jobs[a].cmd == command_type::push && m_jobs[b].cmd != command_type::push; });
-				for(command_id cid : ready_jobs) {
-					auto* job = m_jobs.at(cid).job.get();
-					job->start();
-					job->update();
-					if(utils::isa<device_execute_job>(job)) { m_running_device_compute_jobs++; }
-				}
-			}
+			start_ready_jobs();
 
 			if(m_jobs.size() < MAX_CONCURRENT_JOBS) {
-				// TODO: Double-buffer command queue?
-				std::unique_lock lk(m_command_queue_mutex);
-				if(!m_command_queue.empty()) {
-					auto pkg = std::move(m_command_queue.front());
-					lk.unlock();
-					const auto handled = handle_command(pkg);
-					lk.lock();
-					if(handled) {
-						m_command_queue.pop();
-					} else {
-						// In case the command couldn't be handled, put it back into the queue.
-						m_command_queue.front() = std::move(pkg);
-						continue;
-					}
+				if(const auto* const cmd = m_command_ring.peek()) {
+					// In case the command couldn't be handled, it remains at the head of the ring and is retried in the next iteration.
+					if(!handle_command(*cmd)) continue;
+					m_command_ring.pop();
 				}
 			}
 
@@ -132,29 +120,59 @@ namespace detail {
 		}
 
 		assert(m_running_device_compute_jobs == 0);
+		assert(m_polled_jobs.empty() && m_job_dependencies.is_empty());
 		closure_hydrator::teardown();
 	}
 
-	bool executor::handle_command(const command_pkg& pkg) {
+	void executor::start_ready_jobs() {
+		// Retiring a job that completes immediately may make further jobs ready, which will be picked up by this same loop.
+		while(const auto cid = m_job_dependencies.pop_ready()) {
+			auto& job = *m_jobs.at(*cid);
+			job.start();
+			job.update();
+			if(utils::isa<device_execute_job>(&job)) { m_running_device_compute_jobs++; }
+			if(job.is_done()) {
+				retire_job(*cid);
+			} else {
+				m_polled_jobs.push_back(*cid);
+			}
+		}
+	}
+
+	void executor::retire_job(const command_id cid) {
+		const auto it = m_jobs.find(cid);
+		assert(it != m_jobs.end());
+		auto* const job = it->second.get();
+		if(utils::isa<device_execute_job>(job)) {
+			m_running_device_compute_jobs--;
+		} else if(const auto epoch = dynamic_cast<epoch_job*>(job); epoch && epoch->get_epoch_action() == epoch_action::shutdown) {
+			assert(m_command_ring.empty());
+			m_shutdown_reached = true;
+		}
+		m_job_dependencies.complete(cid);
+		m_jobs.erase(it);
+	}
+
+	bool executor::handle_command(const encoded_command& cmd) {
 		// A worker might receive a task command before creating the corresponding task graph node
-		if(const auto tid = pkg.get_tid()) {
+		if(const auto tid = cmd.get_tid()) {
 			if(!m_task_mngr.has_task(*tid)) { return false; }
 		}
 
-		switch(pkg.get_command_type()) {
-		case command_type::horizon: create_job<horizon_job>(pkg, m_task_mngr); break;
-		case command_type::epoch: create_job<epoch_job>(pkg, m_task_mngr); break;
-		case command_type::push: create_job<push_job>(pkg, *m_btm, m_buffer_mngr); break;
-		case command_type::await_push: create_job<await_push_job>(pkg, *m_btm); break;
-		case command_type::reduction: create_job<reduction_job>(pkg, m_reduction_mngr); break;
+		switch(cmd.type) {
+		case command_type::horizon: create_job<horizon_job>(cmd, m_task_mngr); break;
+		case command_type::epoch: create_job<epoch_job>(cmd, m_task_mngr); break;
+		case command_type::push: create_job<push_job>(cmd, *m_btm, m_buffer_mngr); break;
+		case command_type::await_push: create_job<await_push_job>(cmd, *m_btm); break;
+		case command_type::reduction: create_job<reduction_job>(cmd, m_reduction_mngr); break;
 		case command_type::execution:
-			if(m_task_mngr.get_task(pkg.get_tid().value())->get_execution_target() == execution_target::host) {
-				create_job<host_execute_job>(pkg, m_h_queue, m_task_mngr, m_buffer_mngr);
+			if(m_task_mngr.get_task(cmd.tid)->get_execution_target() == execution_target::host) {
+				create_job<host_execute_job>(cmd, m_h_queue, m_task_mngr, m_buffer_mngr);
 			} else {
-				create_job<device_execute_job>(pkg, m_d_queue, m_task_mngr, m_buffer_mngr, m_reduction_mngr, m_local_nid);
+				create_job<device_execute_job>(cmd, m_d_queue, m_task_mngr, m_buffer_mngr, m_reduction_mngr, m_local_nid);
 			}
 			break;
-		case command_type::fence: create_job<fence_job>(pkg, m_task_mngr); break;
+		case command_type::fence: create_job<fence_job>(cmd, m_task_mngr); break;
 		default: assert(!"Unexpected command");
 		}
 		return true;
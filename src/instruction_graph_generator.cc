@@ -2,6 +2,7 @@
 
 #include "access_modes.h"
 #include "command.h"
+#include "cost_model.h"
 #include "grid.h"
 #include "instruction_graph.h"
 #include "recorders.h"
@@ -11,7 +12,10 @@
 #include "task.h"
 #include "task_manager.h"
 #include "types.h"
+#include "utils.h"
 
+#include <limits>
+#include <optional>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -50,7 +54,8 @@ void split_into_communicator_compatible_boxes_recurse(
 /// pointer to using the stride as an offset. For 1D buffers this will no practical performance consequences because of the implied transfer sizes, but in
 /// degenerate higher-dimensional cases we might end up transferring individual buffer elements per send instruction.
 ///
-/// TODO The proper solution to this is to explicitly implement linearization / delinearization in the IDAG, which is also required to enable RDMA transfers.
+/// TODO Senders already pack strided boxes with a linearize_instruction, but receives into host buffer allocations remain strided. Once all receives go
+/// through dense staging allocations, this split becomes unnecessary.
 box_vector<3> split_into_communicator_compatible_boxes(const range<3>& buffer_range, const box<3>& send_box) {
 	assert(box(subrange<3>(zeros, buffer_range)).covers(send_box));
 
@@ -77,6 +82,20 @@ box_vector<3> split_into_communicator_compatible_boxes(const range<3>& buffer_ra
 	return compatible_boxes;
 }
 
+/// Determines whether the elements of `sub_box` form a single contiguous range of memory within an allocation of `allocation_box` in row-major order. This
+/// is the case if all dimensions faster than the slowest one in which `sub_box` has an extent > 1 span the entire allocation.
+bool is_contiguous_in_allocation(const box<3>& sub_box, const box<3>& allocation_box) {
+	assert(allocation_box.covers(sub_box));
+	int d = 0;
+	while(d < 2 && sub_box.get_range()[d] == 1) {
+		++d;
+	}
+	for(++d; d < 3; ++d) {
+		if(sub_box.get_range()[d] != allocation_box.get_range()[d]) return false;
+	}
+	return true;
+}
+
 /// Determines whether two boxes are either overlapping or touching on edges (not corners). This means on 2-connectivity for 1d boxes, 4-connectivity for 2d
 /// boxes and 6-connectivity for 3d boxes. For 0-dimensional boxes, always returns true.
 template <int Dims>
@@ -213,6 +232,9 @@ memory_id next_location(const memory_mask& location, memory_id first) {
 /// `allocation_id`s are "namespaced" to their memory ID, so we maintain the next `raw_allocation_id` for each memory separately.
 struct memory_state {
 	raw_allocation_id next_raw_aid = 1; // 0 is reserved for null_allocation_id
+
+	/// Sum of the sizes of all buffer allocations on this memory, compared against `memory_info::capacity` before allocating.
+	size_t allocated_buffer_bytes = 0;
 };
 
 /// Maintains a set of concurrent instructions that are accessing a subrange of a buffer allocation.
@@ -263,16 +285,21 @@ struct buffer_allocation_state {
 	detail::box<3> box;                                ///< in buffer coordinates
 	region_map<access_front> last_writers;             ///< in buffer coordinates
 	region_map<access_front> last_concurrent_accesses; ///< in buffer coordinates
+	instruction_id last_access = 0;                    ///< most recent instruction to read or write the allocation, for LRU eviction
+	detail::box<3> accessed_since_horizon;             ///< bounding box of all reads and writes since the last horizon, for compaction
 
 	explicit buffer_allocation_state(const allocation_id aid, alloc_instruction* const ainstr /* optional: null for user allocations */,
 	    const detail::box<3>& allocated_box, const range<3>& buffer_range)
 	    : aid(aid), box(allocated_box), //
 	      last_writers(allocated_box, ainstr != nullptr ? access_front(ainstr, access_front::allocate) : access_front()),
-	      last_concurrent_accesses(allocated_box, ainstr != nullptr ? access_front(ainstr, access_front::allocate) : access_front()) {}
+	      last_concurrent_accesses(allocated_box, ainstr != nullptr ? access_front(ainstr, access_front::allocate) : access_front()),
+	      last_access(ainstr != nullptr ? ainstr->get_id() : 0) {}
 
 	/// Add `instr` to the active set of concurrent reads, or replace the current access front if the last access was not a read.
 	void track_concurrent_read(const region<3>& region, instruction* const instr) {
 		if(region.empty()) return;
+		last_access = std::max(last_access, instr->get_id());
+		accessed_since_horizon = bounding_box(accessed_since_horizon, bounding_box(region));
 		for(auto& [box, front] : last_concurrent_accesses.get_region_values(region)) {
 			if(front.get_mode() == access_front::read) {
 				front.add_instruction(instr);
@@ -287,6 +314,8 @@ struct buffer_allocation_state {
 	/// happening simultaneously. This is true for all writes except those from device kernels and host tasks, which might specify overlapping write-accessors.
 	void track_atomic_write(const region<3>& region, instruction* const instr) {
 		if(region.empty()) return;
+		last_access = std::max(last_access, instr->get_id());
+		accessed_since_horizon = bounding_box(accessed_since_horizon, bounding_box(region));
 		last_writers.update_region(region, access_front(instr, access_front::write));
 		last_concurrent_accesses.update_region(region, access_front(instr, access_front::write));
 	}
@@ -304,6 +333,8 @@ struct buffer_allocation_state {
 	/// track multiple last-writers for the same buffer element.
 	void track_concurrent_write(const region<3>& region, instruction* const instr) {
 		if(region.empty()) return;
+		last_access = std::max(last_access, instr->get_id());
+		accessed_since_horizon = bounding_box(accessed_since_horizon, bounding_box(region));
 		for(auto& [box, front] : last_writers.get_region_values(region)) {
 			assert(front.get_mode() == access_front::write && "must call begin_concurrent_writes first");
 			front.add_instruction(instr);
@@ -325,6 +356,10 @@ struct buffer_memory_state {
 	// TODO evaluate if it ever makes sense to use a region_map here, or if we're better off expecting very few allocations and sticking to a vector here
 	std::vector<buffer_allocation_state> allocations; // disjoint
 
+	/// Contiguous boxes that commands in the scheduler's lookahead window will require on this memory. These are merged into the next allocation on this
+	/// memory so that it is sized for the final access pattern instead of being grown (and resize-copied) once per command.
+	box_vector<3> anticipated_contiguous_boxes;
+
 	const buffer_allocation_state& get_allocation(const allocation_id aid) const {
 		const auto it = std::find_if(allocations.begin(), allocations.end(), [=](const buffer_allocation_state& a) { return a.aid == aid; });
 		assert(it != allocations.end());
@@ -466,7 +501,7 @@ struct collective_group_state {
 /// instructions that are generated in the call stack without polluting internal state, we pass a `batch&` output parameter to any function that transitively
 /// generates instructions or pilots.
 struct batch { // NOLINT(cppcoreguidelines-special-member-functions) (do not complain about the asserting destructor)
-	std::vector<const instruction*> generated_instructions;
+	std::vector<instruction*> generated_instructions; ///< non-const until flushed, because priorities are only finalized by flush_batch()
 	std::vector<outbound_pilot> generated_pilots;
 
 	/// The base priority of a batch adds to the priority per instruction type to transitively prioritize dependencies of important instructions.
@@ -486,6 +521,7 @@ template <typename Instruction> constexpr int instruction_type_priority = 0; //
 template <> constexpr int instruction_type_priority<free_instruction> = -1; // only free when forced to - nothing except an epoch or horizon will depend on this
 template <> constexpr int instruction_type_priority<alloc_instruction> = 1; // allocations are synchronous and slow, so we postpone them as much as possible
 template <> constexpr int instruction_type_priority<copy_instruction> = 2;
+template <> constexpr int instruction_type_priority<linearize_instruction> = 2;
 template <> constexpr int instruction_type_priority<await_receive_instruction> = 2;
 template <> constexpr int instruction_type_priority<split_receive_instruction> = 2;
 template <> constexpr int instruction_type_priority<receive_instruction> = 2;
@@ -497,6 +533,26 @@ template <> constexpr int instruction_type_priority<epoch_instruction> = 5; // e
 template <> constexpr int instruction_type_priority<horizon_instruction> = 5;
 // clang-format on
 
+// Within each level of batch- and type priority, flush_batch() orders instructions by the estimated duration of the longest dependency chain they start
+// within their batch. The duration is bucketed logarithmically, so that chains of similar length do not reorder each other arbitrarily.
+constexpr int critical_path_priority_levels = 32;
+
+// Allocations smaller than this are never compacted on horizons, since the resize-copy would cost more than the memory it frees.
+constexpr size_t min_compacted_allocation_bytes = size_t{1} << 20;
+
+// On horizons, an allocation is compacted if the tight boxes around its live data cover at most 1 / compaction_area_ratio of its area.
+constexpr size_t compaction_area_ratio = 2;
+
+/// Maps the estimated duration of a critical path onto [0, critical_path_priority_levels).
+int critical_path_priority(const std::chrono::nanoseconds path_duration) {
+	int level = 0;
+	const auto ns = static_cast<uint64_t>(std::max<std::chrono::nanoseconds::rep>(0, path_duration.count()));
+	for(auto c = ns; c != 0 && level < critical_path_priority_levels - 1; c >>= 1) {
+		++level;
+	}
+	return level;
+}
+
 /// A chunk of a task's execution space that will be assigned to a device (or the host) and thus knows which memory its instructions will operate on.
 struct localized_chunk {
 	detail::memory_id memory_id = host_memory_id;
@@ -516,13 +572,45 @@ struct local_reduction {
 	alloc_instruction* gather_alloc_instr = nullptr;
 };
 
+/// Identifies sends that can recur between time steps of an iterative program, such as a halo exchange.
+struct recurring_send_key {
+	node_id target = 0;
+	buffer_id bid = 0;
+	box<3> send_box;
+
+	friend bool operator==(const recurring_send_key& lhs, const recurring_send_key& rhs) {
+		return lhs.target == rhs.target && lhs.bid == rhs.bid && lhs.send_box == rhs.send_box;
+	}
+	friend bool operator!=(const recurring_send_key& lhs, const recurring_send_key& rhs) { return !(lhs == rhs); }
+};
+
+struct recurring_send_key_hash {
+	size_t operator()(const recurring_send_key& key) const {
+		size_t h = std::hash<node_id>{}(key.target);
+		utils::hash_combine(h, std::hash<buffer_id>{}(key.bid));
+		for(int d = 0; d < 3; ++d) {
+			utils::hash_combine(h, key.send_box.get_min()[d]);
+			utils::hash_combine(h, key.send_box.get_max()[d]);
+		}
+		return h;
+	}
+};
+
+struct recurring_send_state {
+	std::optional<message_id> recurring_msgid; ///< assigned on the first repetition, the initial send uses a one-off message id
+	size_t next_sequence = 0;                  ///< pilot_message::sequence of the next send with `recurring_msgid`
+	instruction_id last_send_iid = 0;
+	size_t last_send_epoch = 0; ///< value of generator_impl::m_num_applied_epochs when the last send was generated
+};
+
 /// Maps instruction DAG types to their record type.
 template <typename Instruction>
 using record_type_for_t = utils::type_switch_t<Instruction, clone_collective_group_instruction(clone_collective_group_instruction_record),
     alloc_instruction(alloc_instruction_record), free_instruction(free_instruction_record), copy_instruction(copy_instruction_record),
-    device_kernel_instruction(device_kernel_instruction_record), host_task_instruction(host_task_instruction_record), send_instruction(send_instruction_record),
-    receive_instruction(receive_instruction_record), split_receive_instruction(split_receive_instruction_record),
-    await_receive_instruction(await_receive_instruction_record), gather_receive_instruction(gather_receive_instruction_record),
+    device_kernel_instruction(device_kernel_instruction_record), host_task_instruction(host_task_instruction_record),
+    linearize_instruction(linearize_instruction_record), send_instruction(send_instruction_record), receive_instruction(receive_instruction_record),
+    split_receive_instruction(split_receive_instruction_record), await_receive_instruction(await_receive_instruction_record),
+    gather_receive_instruction(gather_receive_instruction_record),
     fill_identity_instruction(fill_identity_instruction_record), reduce_instruction(reduce_instruction_record), fence_instruction(fence_instruction_record),
     destroy_host_object_instruction(destroy_host_object_instruction_record), horizon_instruction(horizon_instruction_record),
     epoch_instruction(epoch_instruction_record)>;
@@ -530,14 +618,17 @@ using record_type_for_t = utils::type_switch_t<Instruction, clone_collective_gro
 class generator_impl {
   public:
 	generator_impl(const task_manager& tm, size_t num_nodes, node_id local_nid, const system_info& system, instruction_graph& idag,
-	    instruction_graph_generator::delegate* dlg, instruction_recorder* recorder, const instruction_graph_generator::policy_set& policy);
+	    instruction_graph_generator::delegate* dlg, instruction_recorder* recorder, const instruction_graph_generator::policy_set& policy,
+	    const cost_model* costs);
 
 	void notify_buffer_created(buffer_id bid, const range<3>& range, size_t elem_size, size_t elem_align, allocation_id user_aid = null_allocation_id);
 	void notify_buffer_debug_name_changed(buffer_id bid, const std::string& name);
 	void notify_buffer_destroyed(buffer_id bid);
 	void notify_host_object_created(host_object_id hoid, bool owns_instance);
 	void notify_host_object_destroyed(host_object_id hoid);
+	void anticipate(const abstract_command& cmd);
 	void compile(const abstract_command& cmd);
+	instruction_graph_generator::state_statistics get_state_statistics() const;
 
   private:
 	inline static const box<3> scalar_reduction_box{zeros, ones};
@@ -551,9 +642,12 @@ class generator_impl {
 	instruction_graph_generator::delegate* m_delegate;
 	instruction_recorder* m_recorder;
 	instruction_graph_generator::policy_set m_policy;
+	static_cost_model m_default_cost_model; ///< used unless the generator is constructed with a different cost model
+	const cost_model* m_cost_model;          ///< annotates every instruction with its estimated duration
 
 	instruction_id m_next_instruction_id = 0;
 	message_id m_next_message_id = 0;
+	message_id m_next_recurring_message_id = first_recurring_message_id;
 
 	instruction* m_last_horizon = nullptr;
 	instruction* m_last_epoch = nullptr; // set once the initial epoch instruction is generated in the constructor
@@ -567,12 +661,22 @@ class generator_impl {
 	std::unordered_map<host_object_id, host_object_state> m_host_objects;
 	std::unordered_map<collective_group_id, collective_group_state> m_collective_groups;
 
+	/// Sends that have been generated since the last few horizons or epochs, to detect repetitions that can share a recurring message id.
+	std::unordered_map<recurring_send_key, recurring_send_state, recurring_send_key_hash> m_recurring_sends;
+	size_t m_num_applied_epochs = 0;
+
 	/// The instruction executor maintains a mapping of allocation_id -> USM pointer. For IDAG-managed memory, these entries are deleted after executing a
 	/// `free_instruction`, but since user allocations are not deallocated by us, we notify the executor on each horizon or epoch via the `instruction_garbage`
 	/// struct about entries that will no longer be used and can therefore be collected. We include user allocations for buffer fences immediately after
 	/// emitting the fence, and buffer host-initialization user allocations after the buffer has been destroyed.
 	std::vector<allocation_id> m_unreferenced_user_allocations;
 
+	/// Local chunks of execution commands that have been split during anticipate(), so that compile() does not split (and report errors) a second time.
+	std::unordered_map<command_id, std::vector<localized_chunk>> m_anticipated_chunks;
+
+	/// Buffers accessed by the execution command currently being compiled. The command's kernels will reference their allocations, so they must not be evicted.
+	std::unordered_set<buffer_id> m_buffers_accessed_by_current_command;
+
 	/// True if a recorder is present and create() will call the `record_with` lambda passed as its last parameter.
 	bool is_recording() const { return m_recorder != nullptr; }
 
@@ -594,6 +698,13 @@ class generator_impl {
 
 	message_id create_outbound_pilot(batch& batch, node_id target, const transfer_id& trid, const box<3>& box);
 
+	/// Announces a send of `box` to `target` through a pilot like create_outbound_pilot(), but re-uses the message id of an earlier send of the same box if
+	/// there was one since the last few horizons. The caller must pass the resulting send instruction to `order_recurring_send`.
+	message_id create_outbound_pilot_for_send(batch& batch, node_id target, const transfer_id& trid, const box<3>& box);
+
+	/// Makes `send_instr` depend on the previous send with the same recurring message id, so that at most one message is in flight for each such id.
+	void order_recurring_send(send_instruction* send_instr, const transfer_id& trid, const box<3>& box);
+
 	/// Inserts a graph dependency and removes `to` form the execution front (if present). The `record_origin` is debug information.
 	void add_dependency(instruction* const from, instruction* const to, const instruction_dependency_origin record_origin);
 
@@ -616,13 +727,32 @@ class generator_impl {
 
 	/// Ensure that all boxes in `required_contiguous_boxes` have a contiguous allocation on `mid`.
 	/// Re-allocation of one buffer on one memory never interacts with other buffers or other memories backing the same buffer, this function can be called
-	/// in any order of allocation requirements without generating additional dependencies.
+	/// in any order of allocation requirements without generating additional dependencies. The exception is a device memory that would exceed its capacity,
+	/// in which case allocations are evicted through `evict_allocations` first.
 	void allocate_contiguously(batch& batch, buffer_id bid, memory_id mid, box_vector<3>&& required_contiguous_boxes);
 
-	/// Insert one or more receive instructions in order to fulfil a pending receive, making the received data available in host_memory_id. This may entail
-	/// receiving a region that is larger than the union of all regions read.
-	void commit_pending_region_receive_to_host_memory(
-	    batch& batch, buffer_id bid, const buffer_state::region_receive& receives, const std::vector<region<3>>& concurrent_reads);
+	/// Frees least-recently accessed allocations on device memory `mid` until `required_bytes` more bytes fit into its capacity, or until no more allocations
+	/// can be evicted. Allocations of buffers that the current command accesses are never evicted, except for allocations of `bid` that do not intersect any
+	/// of the `retained_boxes`. Returns the free instructions, which new allocations must depend on to actually stay within capacity.
+	std::vector<instruction*> evict_allocations(batch& batch, buffer_id bid, memory_id mid, const box_vector<3>& retained_boxes, size_t required_bytes);
+
+	/// Copies all data for which `aid` holds the only up-to-date copy to host memory and frees the allocation. Returns the free instruction.
+	instruction* spill_and_free_allocation(batch& batch, buffer_id bid, memory_id mid, allocation_id aid);
+
+	/// Shrinks allocations whose live data and recent accesses only cover a small part of their box by copying the live data into tight allocations and
+	/// freeing the original. Called on horizons, so that the resulting instructions are collapsed into the horizon's execution front.
+	void compact_allocations(batch& batch);
+
+	/// Selects the memory that a pending receive applied for a task is made available in: The native memory of the device that reads it, if all local chunks
+	/// reading the received region execute on the same device, and host memory otherwise.
+	memory_id select_receive_target_memory(
+	    buffer_id bid, const task& tsk, const buffer_state::region_receive& receive, const std::vector<localized_chunk>& concurrent_chunks) const;
+
+	/// Insert one or more receive instructions in order to fulfil a pending receive, making the received data available in `dest_mid`. This may entail
+	/// receiving a region that is larger than the union of all regions read. Receives into host memory target the buffer allocation directly, while receives
+	/// for device memory are staged through a dense host allocation and scattered into the device allocation by a copy instruction.
+	void commit_pending_region_receive(
+	    batch& batch, buffer_id bid, const buffer_state::region_receive& receives, memory_id dest_mid, const std::vector<region<3>>& concurrent_reads);
 
 	/// Insert coherence copy instructions where necessary to make `dest_mid` coherent for all `concurrent_reads`. Requires the necessary allocations in
 	/// `dest_mid` to already be present. We deliberately allow overlapping read-regions to avoid aggregated copies introducing synchronization points between
@@ -665,6 +795,12 @@ class generator_impl {
 	void perform_task_collective_operations(
 	    const task& tsk, const std::vector<localized_chunk>& concurrent_chunks, const std::vector<instruction*>& command_instructions);
 
+	/// Record the contiguous allocations an execution command will require once it is compiled.
+	void anticipate_execution_command(const execution_command& ecmd);
+
+	/// Drop all anticipated allocations. Called on horizons and epochs, which the scheduler never looks beyond.
+	void discard_anticipations();
+
 	void compile_execution_command(batch& batch, const execution_command& ecmd);
 	void compile_push_command(batch& batch, const push_command& pcmd);
 	void defer_await_push_command(const await_push_command& apcmd);
@@ -673,6 +809,11 @@ class generator_impl {
 	void compile_horizon_command(batch& batch, const horizon_command& hcmd);
 	void compile_epoch_command(batch& batch, const epoch_command& ecmd);
 
+	/// Raises the priority of every instruction in `batch` by the estimated duration of the longest chain of dependent instructions it starts within the
+	/// batch, so that among concurrently eligible instructions, kernels and transfers on the critical path are issued first. Without a cost model, all
+	/// estimates are zero and priorities remain unchanged.
+	void prioritize_critical_paths(batch& batch);
+
 	/// Passes all instructions and outbound pilots that have been accumulated in `batch` to the delegate (if any). Called after compiling a command, creating
 	/// or destroying a buffer or host object, and also in our constructor for the creation of the initial epoch.
 	void flush_batch(batch&& batch);
@@ -681,8 +822,10 @@ class generator_impl {
 };
 
 generator_impl::generator_impl(const task_manager& tm, const size_t num_nodes, const node_id local_nid, const system_info& system, instruction_graph& idag,
-    instruction_graph_generator::delegate* const dlg, instruction_recorder* const recorder, const instruction_graph_generator::policy_set& policy)
+    instruction_graph_generator::delegate* const dlg, instruction_recorder* const recorder, const instruction_graph_generator::policy_set& policy,
+    const cost_model* const costs)
     : m_idag(&idag), m_tm(&tm), m_num_nodes(num_nodes), m_local_nid(local_nid), m_system(system), m_delegate(dlg), m_recorder(recorder), m_policy(policy),
+      m_cost_model(costs != nullptr ? costs : &m_default_cost_model),
       m_memories(m_system.memories.size()) //
 {
 #ifndef NDEBUG
@@ -751,6 +894,7 @@ void generator_impl::notify_buffer_destroyed(const buffer_id bid) {
 					record_debug_info(allocation.box.get_area() * buffer.elem_size, buffer_allocation_record{bid, buffer.debug_name, allocation.box});
 				});
 				add_dependencies_on_last_concurrent_accesses(free_instr, allocation, allocation.box, instruction_dependency_origin::allocation_lifetime);
+				m_memories[mid].allocated_buffer_bytes -= allocation.box.get_area() * buffer.elem_size;
 				// no need to modify the access front - we're removing the buffer altogether!
 			}
 		}
@@ -791,11 +935,10 @@ template <typename Instruction, typename... CtorParamsAndRecordWithFn, size_t...
 Instruction* generator_impl::create_internal(batch& batch, const std::tuple<CtorParamsAndRecordWithFn...>& ctor_args_and_record_with,
     std::index_sequence<CtorParamIndices...> /* ctor_param_indices*/, std::index_sequence<RecordWithFnIndex> /* record_with_fn_index */) {
 	const auto iid = m_next_instruction_id++;
-	const auto priority = batch.base_priority + instruction_type_priority<Instruction>;
-	auto unique_instr = std::make_unique<Instruction>(iid, priority, std::get<CtorParamIndices>(ctor_args_and_record_with)...);
-	const auto instr = unique_instr.get(); // we need to access the raw pointer after moving unique_ptr
-
-	m_idag->push_instruction(std::move(unique_instr));
+	// the critical-path component of the priority is added in flush_batch()
+	const auto priority = (batch.base_priority + instruction_type_priority<Instruction>) * critical_path_priority_levels;
+	const auto instr = m_idag->create_instruction<Instruction>(iid, priority, std::get<CtorParamIndices>(ctor_args_and_record_with)...);
+	instr->set_estimated_duration(m_cost_model->estimate(*instr));
 	m_execution_front.insert(iid);
 	batch.generated_instructions.push_back(instr);
 
@@ -834,6 +977,33 @@ message_id generator_impl::create_outbound_pilot(batch& current_batch, const nod
 	return msgid;
 }
 
+message_id generator_impl::create_outbound_pilot_for_send(batch& current_batch, const node_id target, const transfer_id& trid, const box<3>& box) {
+	const auto [it, first_send] = m_recurring_sends.try_emplace(recurring_send_key{target, trid.bid, box});
+	auto& recurring = it->second;
+	if(first_send) return create_outbound_pilot(current_batch, target, trid, box);
+
+	if(!recurring.recurring_msgid.has_value()) { recurring.recurring_msgid = m_next_recurring_message_id++; }
+	const outbound_pilot pilot{target, pilot_message{*recurring.recurring_msgid, trid, box, recurring.next_sequence++}};
+	current_batch.generated_pilots.push_back(pilot);
+	if(is_recording()) { m_recorder->record_outbound_pilot(pilot); }
+	return *recurring.recurring_msgid;
+}
+
+void generator_impl::order_recurring_send(send_instruction* const send_instr, const transfer_id& trid, const box<3>& box) {
+	auto& recurring = m_recurring_sends.at(recurring_send_key{send_instr->get_dest_node_id(), trid.bid, box});
+	if(is_recurring_message_id(send_instr->get_message_id())) {
+		// The previous send might have been generated before the last epoch, so we can't go through add_dependency(), which takes an instruction pointer
+		send_instr->add_dependency(recurring.last_send_iid);
+		if(is_recording()) {
+			m_recorder->record_dependency(
+			    instruction_dependency_record(recurring.last_send_iid, send_instr->get_id(), instruction_dependency_origin::recurring_send));
+		}
+		m_execution_front.erase(recurring.last_send_iid);
+	}
+	recurring.last_send_iid = send_instr->get_id();
+	recurring.last_send_epoch = m_num_applied_epochs;
+}
+
 void generator_impl::add_dependency(instruction* const from, instruction* const to, const instruction_dependency_origin record_origin) {
 	from->add_dependency(to->get_id());
 	if(is_recording()) { m_recorder->record_dependency(instruction_dependency_record(to->get_id(), from->get_id(), record_origin)); }
@@ -882,6 +1052,14 @@ void generator_impl::apply_epoch(instruction* const epoch) {
 	for(auto& [_, collective_group] : m_collective_groups) {
 		collective_group.apply_epoch(epoch);
 	}
+	++m_num_applied_epochs;
+	for(auto it = m_recurring_sends.begin(); it != m_recurring_sends.end();) {
+		if(m_num_applied_epochs - it->second.last_send_epoch > max_idle_recurring_send_epochs) {
+			it = m_recurring_sends.erase(it);
+		} else {
+			++it;
+		}
+	}
 	m_last_epoch = epoch;
 }
 
@@ -913,6 +1091,28 @@ void generator_impl::allocate_contiguously(batch& current_batch, const buffer_id
 		return;
 	}
 
+	// If this allocation would exceed the capacity of a device memory, first spill and free allocations that have not been accessed recently. The resize
+	// sources of the reallocation below stay alive until all new allocations have been populated, so they count towards the required capacity.
+	std::vector<instruction*> eviction_frees;
+	if(mid >= first_device_memory_id && m_system.memories[mid].capacity != std::numeric_limits<size_t>::max()) {
+		// This estimate ignores existing allocations that will be merged into the new ones, but those are already accounted for as resize sources.
+		box_vector<3> planned_boxes;
+		for(const auto& box : required_contiguous_boxes) {
+			if(!memory.is_allocated_contiguously(box)) { planned_boxes.push_back(box); }
+		}
+		planned_boxes.append(memory.anticipated_contiguous_boxes.begin(), memory.anticipated_contiguous_boxes.end());
+		merge_overlapping_bounding_boxes(planned_boxes);
+		size_t planned_bytes = 0;
+		for(const auto& box : planned_boxes) {
+			planned_bytes += box.get_area() * buffer.elem_size;
+		}
+		if(m_memories[mid].allocated_buffer_bytes + planned_bytes > m_system.memories[mid].capacity) {
+			box_vector<3> retained_boxes = required_contiguous_boxes;
+			retained_boxes.append(planned_boxes.begin(), planned_boxes.end());
+			eviction_frees = evict_allocations(current_batch, bid, mid, retained_boxes, planned_bytes);
+		}
+	}
+
 	// We currently only ever *grow* the allocation of buffers on each memory, which means that we must merge (re-size) existing allocations that overlap with
 	// but do not fully contain one of the required contiguous boxes. *Overlapping* here strictly means having a non-empty intersection; two allocations whose
 	// boxes merely touch can continue to co-exist
@@ -920,6 +1120,10 @@ void generator_impl::allocate_contiguously(batch& current_batch, const buffer_id
 	for(auto& alloc : memory.allocations) {
 		contiguous_boxes_after_realloc.push_back(alloc.box);
 	}
+	// Since we need to (re-)allocate anyway, also include everything that commands in the lookahead window will require. This avoids a chain of growing
+	// allocations and resize-copies when subsequent commands access a larger part of the buffer.
+	contiguous_boxes_after_realloc.append(std::move(memory.anticipated_contiguous_boxes));
+	memory.anticipated_contiguous_boxes.clear();
 	merge_overlapping_bounding_boxes(contiguous_boxes_after_realloc);
 
 	// Allocations that are now fully contained in (but not equal to) one of the newly contiguous bounding boxes will be freed at the end of the reallocation
@@ -954,6 +1158,10 @@ void generator_impl::allocate_contiguously(batch& current_batch, const buffer_id
 			    record_debug_info(alloc_instruction_record::alloc_origin::buffer, buffer_allocation_record{bid, buffer.debug_name, new_box}, std::nullopt);
 		    });
 		add_dependency(alloc_instr, m_last_epoch, instruction_dependency_origin::last_epoch);
+		for(const auto free_instr : eviction_frees) {
+			add_dependency(alloc_instr, free_instr, instruction_dependency_origin::allocation_lifetime);
+		}
+		m_memories[mid].allocated_buffer_bytes += new_box.get_area() * buffer.elem_size;
 
 		auto& new_alloc = new_allocations.emplace_back(aid, alloc_instr, new_box, buffer.range);
 
@@ -996,6 +1204,7 @@ void generator_impl::allocate_contiguously(batch& current_batch, const buffer_id
 			record_debug_info(old_alloc.box.get_area() * buffer.elem_size, buffer_allocation_record{bid, buffer.debug_name, old_alloc.box});
 		});
 		add_dependencies_on_last_concurrent_accesses(free_instr, old_alloc, old_alloc.box, instruction_dependency_origin::allocation_lifetime);
+		m_memories[mid].allocated_buffer_bytes -= old_alloc.box.get_area() * buffer.elem_size;
 	}
 
 	// TODO garbage-collect allocations that are not up-to-date and not written to in this task
@@ -1004,30 +1213,215 @@ void generator_impl::allocate_contiguously(batch& current_batch, const buffer_id
 	memory.allocations.insert(memory.allocations.end(), std::make_move_iterator(new_allocations.begin()), std::make_move_iterator(new_allocations.end()));
 }
 
-void generator_impl::commit_pending_region_receive_to_host_memory(
-    batch& current_batch, const buffer_id bid, const buffer_state::region_receive& receive, const std::vector<region<3>>& concurrent_reads) //
+std::vector<instruction*> generator_impl::evict_allocations(
+    batch& current_batch, const buffer_id bid, const memory_id mid, const box_vector<3>& retained_boxes, const size_t required_bytes) //
 {
-	const auto trid = transfer_id(receive.consumer_tid, bid, no_reduction_id);
+	assert(mid >= first_device_memory_id && "only device memories can be spilled to host memory");
 
-	// For simplicity of the initial IDAG implementation, we choose to receive directly into host-buffer allocations. This saves us from juggling
-	// staging-buffers, but comes at a price in performance since the communicator needs to linearize and de-linearize transfers from and to regions that have
-	// non-zero strides within their host allocation.
-	//
-	// TODO 1) maintain staging allocations and move (de-)linearization to the device in order to profit from higher memory bandwidths
-	//      2) explicitly support communicators that can send and receive directly to and from device memory (NVIDIA GPUDirect RDMA)
+	struct eviction_candidate {
+		instruction_id last_access;
+		buffer_id bid;
+		allocation_id aid;
+	};
+	std::vector<eviction_candidate> candidates;
+	for(const auto& [candidate_bid, buffer] : m_buffers) {
+		const bool is_accessed = m_buffers_accessed_by_current_command.count(candidate_bid) != 0;
+		if(is_accessed && candidate_bid != bid) continue;
+		for(const auto& alloc : buffer.memories[mid].allocations) {
+			if(candidate_bid == bid
+			    && std::any_of(retained_boxes.begin(), retained_boxes.end(), [&](const box<3>& box) { return !box_intersection(box, alloc.box).empty(); })) {
+				continue;
+			}
+			candidates.push_back({alloc.last_access, candidate_bid, alloc.aid});
+		}
+	}
+	// m_buffers is unordered, so we break ties between allocations accessed by the same instruction on their ids to keep the generated graph deterministic
+	std::sort(candidates.begin(), candidates.end(), [](const eviction_candidate& lhs, const eviction_candidate& rhs) {
+		return std::tuple(lhs.last_access, lhs.bid, lhs.aid.get_raw_allocation_id()) < std::tuple(rhs.last_access, rhs.bid, rhs.aid.get_raw_allocation_id());
+	});
 
+	std::vector<instruction*> free_instrs;
+	const auto capacity = m_system.memories[mid].capacity;
+	for(const auto& victim : candidates) {
+		if(m_memories[mid].allocated_buffer_bytes + required_bytes <= capacity) break;
+		free_instrs.push_back(spill_and_free_allocation(current_batch, victim.bid, mid, victim.aid));
+	}
+	// If we still exceed capacity, the allocation will fail at runtime just as it would have without a capacity limit.
+	return free_instrs;
+}
+
+instruction* generator_impl::spill_and_free_allocation(batch& current_batch, const buffer_id bid, const memory_id mid, const allocation_id aid) {
 	auto& buffer = m_buffers.at(bid);
-	auto& host_memory = buffer.memories[host_memory_id];
+	const auto victim_box = buffer.memories[mid].get_allocation(aid).box;
+
+	// Data that is also up-to-date in any other memory does not need to be preserved
+	box_vector<3> spill_boxes;
+	for(const auto& [box, location] : buffer.up_to_date_memories.get_region_values(victim_box)) {
+		if(location.test(mid) && location.count() == 1) { spill_boxes.push_back(box); }
+	}
+	if(!spill_boxes.empty()) {
+		region<3> spill_region(std::move(spill_boxes));
+		allocate_contiguously(current_batch, bid, host_memory_id, box_vector<3>(spill_region.get_boxes()));
+		establish_coherence_between_buffer_memories(current_batch, bid, host_memory_id, {std::move(spill_region)});
+	}
+
+	// The spill copies have been added to the access front of the victim, so the free will wait for them.
+	auto& memory = buffer.memories[mid];
+	auto& victim = memory.get_allocation(aid);
+	const auto free_instr = create<free_instruction>(current_batch, victim.aid, [&](const auto& record_debug_info) {
+		record_debug_info(victim.box.get_area() * buffer.elem_size, buffer_allocation_record{bid, buffer.debug_name, victim.box});
+	});
+	add_dependencies_on_last_concurrent_accesses(free_instr, victim, victim.box, instruction_dependency_origin::allocation_lifetime);
+	m_memories[mid].allocated_buffer_bytes -= victim.box.get_area() * buffer.elem_size;
+	memory.allocations.erase(memory.allocations.begin() + (&victim - memory.allocations.data()));
+
+	// Future coherence copies must find the data elsewhere. Prefer host memory as the source, which holds everything that was just spilled.
+	for(const auto& [box, location] : buffer.up_to_date_memories.get_region_values(victim_box)) {
+		if(location.test(mid)) { buffer.up_to_date_memories.update_box(box, memory_mask(location).reset(mid)); }
+	}
+	for(const auto& [box, original_write_mid] : buffer.original_write_memories.get_region_values(victim_box)) {
+		if(original_write_mid != mid) continue;
+		for(const auto& [location_box, location] : buffer.up_to_date_memories.get_region_values(box)) {
+			if(location.none()) continue; // original_write_memories is meaningless where the buffer is not up-to-date locally
+			memory_id new_original_mid = host_memory_id;
+			if(!location.test(host_memory_id)) {
+				new_original_mid = 0;
+				while(!location.test(new_original_mid)) {
+					++new_original_mid;
+				}
+			}
+			buffer.original_write_memories.update_box(location_box, new_original_mid);
+		}
+	}
+
+	return free_instr;
+}
 
-	std::vector<buffer_allocation_state*> allocations;
-	for(const auto& min_contiguous_box : receive.required_contiguous_allocations) {
-		// The caller (aka satisfy_task_buffer_requirements) must ensure that all received boxes are allocated contiguously
-		auto& alloc = host_memory.get_contiguous_allocation(min_contiguous_box);
-		if(std::find(allocations.begin(), allocations.end(), &alloc) == allocations.end()) { allocations.push_back(&alloc); }
+void generator_impl::compact_allocations(batch& current_batch) {
+	// m_buffers is unordered, so we visit buffers by id to keep the generated graph deterministic
+	std::vector<buffer_id> bids;
+	bids.reserve(m_buffers.size());
+	for(const auto& [bid, buffer] : m_buffers) {
+		bids.push_back(bid);
 	}
+	std::sort(bids.begin(), bids.end());
+
+	for(const auto bid : bids) {
+		auto& buffer = m_buffers.at(bid);
+		// Pending receives have already determined the contiguous allocations they will be received into
+		const bool has_pending_receives = !buffer.pending_receives.empty() || !buffer.pending_gathers.empty();
+
+		for(memory_id mid = host_memory_id; mid < buffer.memories.size(); ++mid) {
+			auto& memory = buffer.memories[mid];
+			std::vector<buffer_allocation_state> compacted_allocations;
+			std::vector<allocation_id> freed_aids;
+
+			for(auto& alloc : memory.allocations) {
+				if(has_pending_receives || alloc.box.get_area() * buffer.elem_size < min_compacted_allocation_bytes) continue;
+
+				// Data that is not up-to-date on this memory will be overwritten or coherence-copied before it is read again, so only the live region needs to
+				// survive. Also retain everything accessed since the last horizon: Commands in a loop tend to repeat their access pattern between horizons,
+				// and an allocation that was just accessed in full would otherwise be shrunk and immediately re-grown.
+				box_vector<3> live_boxes;
+				for(const auto& [box, location] : buffer.up_to_date_memories.get_region_values(alloc.box)) {
+					if(location.test(mid)) { live_boxes.push_back(box); }
+				}
+				region<3> live_region(std::move(live_boxes));
+				auto tight_boxes = connected_subregion_bounding_boxes(region_union(live_region, region<3>(alloc.accessed_since_horizon)));
+				// Bounding boxes of disconnected, interleaved subregions can still overlap, but allocations on the same memory must not
+				merge_overlapping_bounding_boxes(tight_boxes);
+				size_t tight_area = 0;
+				for(const auto& box : tight_boxes) {
+					tight_area += box.get_area();
+				}
+				if(tight_area * compaction_area_ratio > alloc.box.get_area()) continue;
+
+				for(const auto& tight_box : tight_boxes) {
+					const auto aid = new_allocation_id(mid);
+					const auto tight_bytes = tight_box.get_area() * buffer.elem_size;
+					const auto alloc_instr = create<alloc_instruction>(current_batch, aid, tight_bytes, buffer.elem_align, [&](const auto& record_debug_info) {
+						record_debug_info(
+						    alloc_instruction_record::alloc_origin::buffer, buffer_allocation_record{bid, buffer.debug_name, tight_box}, std::nullopt);
+					});
+					add_dependency(alloc_instr, m_last_epoch, instruction_dependency_origin::last_epoch);
+					m_memories[mid].allocated_buffer_bytes += tight_bytes;
+
+					auto& tight_alloc = compacted_allocations.emplace_back(aid, alloc_instr, tight_box, buffer.range);
+					const auto copy_region = region_intersection(live_region, region<3>(tight_box));
+					if(copy_region.empty()) continue;
+
+					const auto copy_instr = create<copy_instruction>(current_batch, alloc.aid, tight_alloc.aid, alloc.box, tight_alloc.box, copy_region,
+					    buffer.elem_size,
+					    [&](const auto& record_debug_info) { record_debug_info(copy_instruction_record::copy_origin::resize, bid, buffer.debug_name); });
+					perform_concurrent_read_from_allocation(copy_instr, alloc, copy_region);
+					perform_atomic_write_to_allocation(copy_instr, tight_alloc, copy_region);
+				}
 
-	for(const auto alloc : allocations) {
-		const auto region_received_into_alloc = region_intersection(alloc->box, receive.received_region);
+				const auto free_instr = create<free_instruction>(current_batch, alloc.aid, [&](const auto& record_debug_info) {
+					record_debug_info(alloc.box.get_area() * buffer.elem_size, buffer_allocation_record{bid, buffer.debug_name, alloc.box});
+				});
+				add_dependencies_on_last_concurrent_accesses(free_instr, alloc, alloc.box, instruction_dependency_origin::allocation_lifetime);
+				m_memories[mid].allocated_buffer_bytes -= alloc.box.get_area() * buffer.elem_size;
+				freed_aids.push_back(alloc.aid);
+			}
+
+			const auto last_retained = std::remove_if(memory.allocations.begin(), memory.allocations.end(),
+			    [&](const buffer_allocation_state& alloc) { return std::find(freed_aids.begin(), freed_aids.end(), alloc.aid) != freed_aids.end(); });
+			memory.allocations.erase(last_retained, memory.allocations.end());
+			memory.allocations.insert(
+			    memory.allocations.end(), std::make_move_iterator(compacted_allocations.begin()), std::make_move_iterator(compacted_allocations.end()));
+
+			// The next horizon only considers accesses made after this one
+			for(auto& alloc : memory.allocations) {
+				alloc.accessed_since_horizon = box<3>();
+			}
+		}
+	}
+}
+
+memory_id generator_impl::select_receive_target_memory(const buffer_id bid, const task& tsk, const buffer_state::region_receive& receive,
+    const std::vector<localized_chunk>& concurrent_chunks) const //
+{
+	// Reductions that include the current buffer value read it from host memory
+	const auto& reductions = tsk.get_reductions();
+	if(std::any_of(reductions.begin(), reductions.end(), [=](const reduction_info& r) { return r.bid == bid; })) return host_memory_id;
+
+	const auto& bam = tsk.get_buffer_access_map();
+	std::optional<memory_id> reader_mid;
+	for(const auto& chunk : concurrent_chunks) {
+		box_vector<3> chunk_read_boxes;
+		for(const auto mode : access::consumer_modes) {
+			const auto req = bam.get_mode_requirements(bid, mode, tsk.get_dimensions(), chunk.execution_range.get_subrange(), tsk.get_global_size());
+			chunk_read_boxes.append(req.get_boxes());
+		}
+		if(region_intersection(region(std::move(chunk_read_boxes)), receive.received_region).empty()) continue;
+		if(reader_mid.has_value() && *reader_mid != chunk.memory_id) return host_memory_id;
+		reader_mid = chunk.memory_id;
+	}
+	if(!reader_mid.has_value() || *reader_mid < first_device_memory_id || !m_system.memories[*reader_mid].copy_peers.test(host_memory_id)) {
+		return host_memory_id;
+	}
+	return *reader_mid;
+}
+
+void generator_impl::commit_pending_region_receive(batch& current_batch, const buffer_id bid, const buffer_state::region_receive& receive,
+    const memory_id dest_mid, const std::vector<region<3>>& concurrent_reads) //
+{
+	const auto trid = transfer_id(receive.consumer_tid, bid, no_reduction_id);
+
+	// The communicator (de-)linearizes strided transfers from and to host allocations on the CPU. Data received for host memory lands in the host-buffer
+	// allocation directly, since it would need to be de-linearized on the CPU either way. Data received for a device is instead received densely into a
+	// staging allocation of each contiguous box and scattered into the device allocation by a copy, which moves de-linearization onto the device and turns
+	// strided receives (e.g. of the halo columns of a 2D stencil) into contiguous ones.
+	//
+	// TODO explicitly support communicators that can send and receive directly to and from device memory (NVIDIA GPUDirect RDMA)
+
+	auto& buffer = m_buffers.at(bid);
+	auto& dest_memory = buffer.memories[dest_mid];
+
+	// Emits the receive instruction(s) that write `region_received_into_alloc` to `recv_alloc`, and returns the instructions that complete the receive
+	// along with the region each of them makes available.
+	const auto receive_into = [&](buffer_allocation_state& recv_alloc, const region<3>& region_received_into_alloc) {
 		std::vector<region<3>> independent_await_regions;
 		for(const auto& read_region : concurrent_reads) {
 			const auto await_region = region_intersection(read_region, region_received_into_alloc);
@@ -1038,42 +1432,94 @@ void generator_impl::commit_pending_region_receive_to_host_memory(
 		// Ensure that receive-instructions inserted for concurrent readers are themselves concurrent.
 		symmetrically_split_overlapping_regions(independent_await_regions);
 
+		std::vector<std::pair<instruction*, region<3>>> received;
 		if(independent_await_regions.size() > 1) {
 			// If there are multiple concurrent readers requiring different parts of the received region, we emit independent await_receive_instructions so as
 			// to not introduce artificial synchronization points (and facilitate computation-communication overlap). Since the (remote) sender might still
 			// choose to perform the entire transfer en-bloc, we must inform the receive_arbiter of the target allocation and the full transfer region via a
 			// split_receive_instruction.
-			const auto split_recv_instr = create<split_receive_instruction>(current_batch, trid, region_received_into_alloc, alloc->aid, alloc->box,
+			const auto split_recv_instr = create<split_receive_instruction>(current_batch, trid, region_received_into_alloc, recv_alloc.aid, recv_alloc.box,
 			    buffer.elem_size, [&](const auto& record_debug_info) { record_debug_info(buffer.debug_name); });
 
 			// We add dependencies to the split_receive_instruction as if it were a writer, but update the last_writers only at the await_receive_instruction.
 			// The actual write happens somewhere in-between these instructions as orchestrated by the receive_arbiter, so no other access must depend on
 			// split_receive_instruction directly.
 			add_dependencies_on_last_concurrent_accesses(
-			    split_recv_instr, *alloc, region_received_into_alloc, instruction_dependency_origin::write_to_allocation);
+			    split_recv_instr, recv_alloc, region_received_into_alloc, instruction_dependency_origin::write_to_allocation);
 
-			for(const auto& await_region : independent_await_regions) {
+			for(auto& await_region : independent_await_regions) {
 				const auto await_instr = create<await_receive_instruction>(
 				    current_batch, trid, await_region, [&](const auto& record_debug_info) { record_debug_info(buffer.debug_name); });
 
 				add_dependency(await_instr, split_recv_instr, instruction_dependency_origin::split_receive);
 
-				alloc->track_atomic_write(await_region, await_instr);
-				buffer.original_writers.update_region(await_region, await_instr);
+				recv_alloc.track_atomic_write(await_region, await_instr);
+				received.emplace_back(await_instr, std::move(await_region));
 			}
 		} else {
 			// A receive_instruction is equivalent to a spit_receive_instruction followed by a single await_receive_instruction, but (as the common case) has
 			// less tracking overhead in the instruction graph.
-			const auto recv_instr = create<receive_instruction>(current_batch, trid, region_received_into_alloc, alloc->aid, alloc->box, buffer.elem_size,
-			    [&](const auto& record_debug_info) { record_debug_info(buffer.debug_name); });
+			const auto recv_instr = create<receive_instruction>(current_batch, trid, region_received_into_alloc, recv_alloc.aid, recv_alloc.box,
+			    buffer.elem_size, [&](const auto& record_debug_info) { record_debug_info(buffer.debug_name); });
+
+			perform_atomic_write_to_allocation(recv_instr, recv_alloc, region_received_into_alloc);
+			received.emplace_back(recv_instr, region_received_into_alloc);
+		}
+		return received;
+	};
+
+	if(dest_mid == host_memory_id) {
+		std::vector<buffer_allocation_state*> allocations;
+		for(const auto& min_contiguous_box : receive.required_contiguous_allocations) {
+			// The caller (aka satisfy_task_buffer_requirements) must ensure that all received boxes are allocated contiguously
+			auto& alloc = dest_memory.get_contiguous_allocation(min_contiguous_box);
+			if(std::find(allocations.begin(), allocations.end(), &alloc) == allocations.end()) { allocations.push_back(&alloc); }
+		}
+
+		for(const auto alloc : allocations) {
+			for(const auto& [recv_instr, recv_region] : receive_into(*alloc, region_intersection(alloc->box, receive.received_region))) {
+				buffer.original_writers.update_region(recv_region, recv_instr);
+			}
+		}
+	} else {
+		// Pilots never describe fragments that cross the boundaries of the required contiguous boxes, so each box can be staged independently.
+		for(const auto& staging_box : receive.required_contiguous_allocations) {
+			const auto region_received_into_staging = region_intersection(staging_box, receive.received_region);
+			if(region_received_into_staging.empty()) continue;
+
+			// The caller (aka satisfy_task_buffer_requirements) must ensure that all received boxes are allocated contiguously
+			auto& dest_alloc = dest_memory.get_contiguous_allocation(staging_box);
+
+			const auto staging_aid = new_allocation_id(host_memory_id);
+			// Like the destinations of linearize_instructions on the sender side, staging allocations are served from the executor's staging pool, so
+			// receiving the same halo in every iteration of a stencil does not allocate and free host memory each time.
+			const auto staging_alloc_instr = create<alloc_instruction>(current_batch, staging_aid, staging_box.get_area() * buffer.elem_size, buffer.elem_align,
+			    true /* is_staging */, [&](const auto& record_debug_info) {
+				    record_debug_info(
+				        alloc_instruction_record::alloc_origin::staging, buffer_allocation_record{bid, buffer.debug_name, staging_box}, std::nullopt);
+			    });
+			add_dependency(staging_alloc_instr, m_last_epoch, instruction_dependency_origin::last_epoch);
+
+			// The staging allocation is not tracked in buffer.memories, since nothing but the scatter copies below will ever access it.
+			buffer_allocation_state staging_alloc(staging_aid, staging_alloc_instr, staging_box, buffer.range);
+			for(const auto& [recv_instr, recv_region] : receive_into(staging_alloc, region_received_into_staging)) {
+				const auto scatter_instr = create<copy_instruction>(current_batch, staging_alloc.aid, dest_alloc.aid, staging_alloc.box, dest_alloc.box,
+				    recv_region, buffer.elem_size,
+				    [&](const auto& record_debug_info) { record_debug_info(copy_instruction_record::copy_origin::staging, bid, buffer.debug_name); });
+				perform_concurrent_read_from_allocation(scatter_instr, staging_alloc, recv_region);
+				perform_atomic_write_to_allocation(scatter_instr, dest_alloc, recv_region);
+				buffer.original_writers.update_region(recv_region, recv_instr);
+			}
 
-			perform_atomic_write_to_allocation(recv_instr, *alloc, region_received_into_alloc);
-			buffer.original_writers.update_region(region_received_into_alloc, recv_instr);
+			const auto free_instr = create<free_instruction>(current_batch, staging_alloc.aid, [&](const auto& record_debug_info) {
+				record_debug_info(staging_box.get_area() * buffer.elem_size, buffer_allocation_record{bid, buffer.debug_name, staging_box});
+			});
+			add_dependencies_on_last_concurrent_accesses(free_instr, staging_alloc, staging_box, instruction_dependency_origin::allocation_lifetime);
 		}
 	}
 
-	buffer.original_write_memories.update_region(receive.received_region, host_memory_id);
-	buffer.up_to_date_memories.update_region(receive.received_region, memory_mask().set(host_memory_id));
+	buffer.original_write_memories.update_region(receive.received_region, dest_mid);
+	buffer.up_to_date_memories.update_region(receive.received_region, memory_mask().set(dest_mid));
 }
 
 void generator_impl::establish_coherence_between_buffer_memories(
@@ -1301,8 +1747,9 @@ void generator_impl::satisfy_task_buffer_requirements(batch& current_batch, cons
 	// We maintain a box_vector here because we also add all received boxes, as these are overwritten by a recv_instruction before being read from the kernel.
 	box_vector<3> discarded_boxes = region_difference(accessed_region, consumed_region).into_boxes();
 
-	// Collect all pending receives (await-push commands) that we must apply before executing this task.
+	// Collect all pending receives (await-push commands) that we must apply before executing this task, along with the memory we receive them into.
 	std::vector<buffer_state::region_receive> applied_receives;
+	std::vector<memory_id> applied_receive_target_memories;
 	{
 		const auto first_applied_receive = std::partition(buffer.pending_receives.begin(), buffer.pending_receives.end(),
 		    [&](const buffer_state::region_receive& r) { return region_intersection(consumed_region, r.received_region).empty(); });
@@ -1310,9 +1757,12 @@ void generator_impl::satisfy_task_buffer_requirements(batch& current_batch, cons
 		for(auto it = first_applied_receive; it != last_applied_receive; ++it) {
 			// we (re) allocate before receiving, but there's no need to preserve previous data at the receive location
 			discarded_boxes.append(it->received_region.get_boxes());
-			// split_receive_instruction needs contiguous allocations for the bounding boxes of potentially received fragments
-			required_contiguous_allocations[host_memory_id].insert(
-			    required_contiguous_allocations[host_memory_id].end(), it->required_contiguous_allocations.begin(), it->required_contiguous_allocations.end());
+			// split_receive_instruction (or the scatter-copy from a staging allocation) needs contiguous allocations for the bounding boxes of potentially
+			// received fragments
+			const auto target_mid = select_receive_target_memory(bid, tsk, *it, concurrent_chunks_after_split);
+			required_contiguous_allocations[target_mid].insert(
+			    required_contiguous_allocations[target_mid].end(), it->required_contiguous_allocations.begin(), it->required_contiguous_allocations.end());
+			applied_receive_target_memories.push_back(target_mid);
 		}
 
 		if(first_applied_receive != last_applied_receive) {
@@ -1390,13 +1840,13 @@ void generator_impl::satisfy_task_buffer_requirements(batch& current_batch, cons
 		allocate_contiguously(current_batch, bid, mid, std::move(required_contiguous_allocations[mid]));
 	}
 
-	// Receive all remote data (which overlaps with the accessed region) into host memory
+	// Receive all remote data (which overlaps with the accessed region) into host memory, or into the memory of the only device reading it
 	std::vector<region<3>> all_concurrent_reads;
 	for(const auto& reads : concurrent_reads_from_memory) {
 		all_concurrent_reads.insert(all_concurrent_reads.end(), reads.begin(), reads.end());
 	}
-	for(const auto& receive : applied_receives) {
-		commit_pending_region_receive_to_host_memory(current_batch, bid, receive, all_concurrent_reads);
+	for(size_t i = 0; i < applied_receives.size(); ++i) {
+		commit_pending_region_receive(current_batch, bid, applied_receives[i], applied_receive_target_memories[i], all_concurrent_reads);
 	}
 
 	// Create the necessary coherence copy instructions to satisfy all remaining requirements locally. The iterations of this loop are independent with the
@@ -1679,8 +2129,14 @@ void generator_impl::compile_execution_command(batch& command_batch, const execu
 	// 1. If this is a collective host task, we might need to insert a `clone_collective_group_instruction` which the task instruction is later serialized on.
 	create_task_collective_groups(command_batch, tsk);
 
-	// 2. Split the task into local chunks and (in case of a device kernel) assign it to devices
-	const auto concurrent_chunks = split_task_execution_range(ecmd, tsk);
+	// 2. Split the task into local chunks and (in case of a device kernel) assign it to devices, unless this has already happened in anticipate()
+	std::vector<localized_chunk> concurrent_chunks;
+	if(const auto anticipated = m_anticipated_chunks.find(ecmd.get_cid()); anticipated != m_anticipated_chunks.end()) {
+		concurrent_chunks = std::move(anticipated->second);
+		m_anticipated_chunks.erase(anticipated);
+	} else {
+		concurrent_chunks = split_task_execution_range(ecmd, tsk);
+	}
 
 	// 3. Detect and report overlapping writes - is not a fatal error to discover one, we always generate an executable (albeit racy) instruction graph
 	if(m_policy.overlapping_write_error != error_policy::ignore) { report_task_overlapping_writes(tsk, concurrent_chunks); }
@@ -1691,9 +2147,11 @@ void generator_impl::compile_execution_command(batch& command_batch, const execu
 	for(const auto& rinfo : tsk.get_reductions()) {
 		accessed_bids.insert(rinfo.bid);
 	}
+	m_buffers_accessed_by_current_command = accessed_bids;
 	for(const auto bid : accessed_bids) {
 		satisfy_task_buffer_requirements(command_batch, bid, tsk, ecmd.get_execution_range(), ecmd.is_reduction_initializer(), concurrent_chunks);
 	}
+	m_buffers_accessed_by_current_command.clear();
 
 	// 5. If the task contains reductions with more than one local input, create the appropriate gather allocations and (if the local node is the designated
 	// reduction initializer) copies the current buffer value into the new gather space.
@@ -1768,16 +2226,40 @@ void generator_impl::compile_push_command(batch& command_batch, const push_comma
 			// Splitting must happen on buffer range instead of host allocation range to ensure boxes are also suitable for the receiver, which might have
 			// a differently-shaped backing allocation
 			for(const auto& compatible_send_box : split_into_communicator_compatible_boxes(buffer.range, full_send_box)) {
-				const message_id msgid = create_outbound_pilot(command_batch, pcmd.get_target(), trid, compatible_send_box);
+				const message_id msgid = create_outbound_pilot_for_send(command_batch, pcmd.get_target(), trid, compatible_send_box);
 
 				auto& allocation = host_memory.get_contiguous_allocation(compatible_send_box); // we allocate_contiguously above
 
 				const auto offset_in_allocation = compatible_send_box.get_offset() - allocation.box.get_offset();
-				const auto send_instr = create<send_instruction>(command_batch, pcmd.get_target(), msgid, allocation.aid, allocation.box.get_range(),
-				    offset_in_allocation, compatible_send_box.get_range(), buffer.elem_size,
+				if(is_contiguous_in_allocation(compatible_send_box, allocation.box)) {
+					const auto send_instr = create<send_instruction>(command_batch, pcmd.get_target(), msgid, allocation.aid, allocation.box.get_range(),
+					    offset_in_allocation, compatible_send_box.get_range(), buffer.elem_size,
+					    [&](const auto& record_debug_info) { record_debug_info(pcmd.get_cid(), trid, buffer.debug_name, compatible_send_box.get_offset()); });
+
+					perform_concurrent_read_from_allocation(send_instr, allocation, compatible_send_box);
+					order_recurring_send(send_instr, trid, compatible_send_box);
+					continue;
+				}
+
+				// Strided boxes are packed into a pooled staging allocation first, so that the communicator only ever sees a dense message. The staging
+				// allocation is not tracked in host_memory, since only the send below will ever read it.
+				const auto staging_aid = new_allocation_id(host_memory_id);
+				const auto linearize_instr = create<linearize_instruction>(command_batch, allocation.aid, allocation.box.get_range(), offset_in_allocation,
+				    compatible_send_box.get_range(), buffer.elem_size, staging_aid,
+				    [&](const auto& record_debug_info) { record_debug_info(trid, buffer.debug_name, compatible_send_box.get_offset()); });
+				perform_concurrent_read_from_allocation(linearize_instr, allocation, compatible_send_box);
+
+				const auto send_instr = create<send_instruction>(command_batch, pcmd.get_target(), msgid, staging_aid, compatible_send_box.get_range(),
+				    zeros, compatible_send_box.get_range(), buffer.elem_size,
 				    [&](const auto& record_debug_info) { record_debug_info(pcmd.get_cid(), trid, buffer.debug_name, compatible_send_box.get_offset()); });
+				add_dependency(send_instr, linearize_instr, instruction_dependency_origin::read_from_allocation);
+				order_recurring_send(send_instr, trid, compatible_send_box);
 
-				perform_concurrent_read_from_allocation(send_instr, allocation, compatible_send_box);
+				const auto free_instr = create<free_instruction>(command_batch, staging_aid, [&](const auto& record_debug_info) {
+					record_debug_info(
+					    compatible_send_box.get_area() * buffer.elem_size, buffer_allocation_record{trid.bid, buffer.debug_name, compatible_send_box});
+				});
+				add_dependency(free_instr, send_instr, instruction_dependency_origin::allocation_lifetime);
 			}
 		}
 	}
@@ -1966,6 +2448,8 @@ void generator_impl::compile_fence_command(batch& command_batch, const fence_com
 }
 
 void generator_impl::compile_horizon_command(batch& command_batch, const horizon_command& hcmd) {
+	discard_anticipations();
+	compact_allocations(command_batch);
 	m_idag->begin_epoch(hcmd.get_tid());
 	instruction_garbage garbage{hcmd.get_completed_reductions(), std::move(m_unreferenced_user_allocations)};
 	const auto horizon = create<horizon_instruction>(
@@ -1977,6 +2461,7 @@ void generator_impl::compile_horizon_command(batch& command_batch, const horizon
 }
 
 void generator_impl::compile_epoch_command(batch& command_batch, const epoch_command& ecmd) {
+	discard_anticipations();
 	m_idag->begin_epoch(ecmd.get_tid());
 	instruction_garbage garbage{ecmd.get_completed_reductions(), std::move(m_unreferenced_user_allocations)};
 	const auto epoch = create<epoch_instruction>(
@@ -1987,6 +2472,56 @@ void generator_impl::compile_epoch_command(batch& command_batch, const epoch_com
 	m_last_horizon = nullptr;
 }
 
+void generator_impl::anticipate_execution_command(const execution_command& ecmd) {
+	const auto& tsk = *m_tm->get_task(ecmd.get_tid());
+	const auto& concurrent_chunks = m_anticipated_chunks.emplace(ecmd.get_cid(), split_task_execution_range(ecmd, tsk)).first->second;
+
+	// Reduction outputs are scalar and always fit the first allocation, so we only need to look at regular accesses here
+	const auto& bam = tsk.get_buffer_access_map();
+	for(const auto bid : bam.get_accessed_buffers()) {
+		auto& buffer = m_buffers.at(bid);
+		for(const auto& chunk : concurrent_chunks) {
+			for(const auto& box : bam.get_required_contiguous_boxes(bid, tsk.get_dimensions(), chunk.execution_range.get_subrange(), tsk.get_global_size())) {
+				if(!box.empty()) { buffer.memories[chunk.memory_id].anticipated_contiguous_boxes.push_back(box); }
+			}
+		}
+	}
+}
+
+void generator_impl::discard_anticipations() {
+	for(auto& [bid, buffer] : m_buffers) {
+		for(auto& memory : buffer.memories) {
+			memory.anticipated_contiguous_boxes.clear();
+		}
+	}
+	m_anticipated_chunks.clear();
+}
+
+void generator_impl::prioritize_critical_paths(batch& batch) {
+	const auto& instrs = batch.generated_instructions;
+	if(instrs.empty()) return;
+
+	// Instructions are generated in topological order and receive consecutive ids within a batch, so a single reverse sweep propagates the cost of each
+	// path back to its first instruction. Dependencies on instructions from earlier batches are ignored, since those have already been flushed.
+	const auto first_iid = instrs.front()->get_id();
+	std::vector<std::chrono::nanoseconds> path_duration(instrs.size()); // the longest path among successors until the instruction itself is visited
+	for(size_t i = instrs.size(); i > 0; --i) {
+		const auto instr = instrs[i - 1];
+		path_duration[i - 1] += instr->get_estimated_duration();
+		for(const auto dep_iid : instr->get_dependencies()) {
+			if(dep_iid < first_iid) continue;
+			const auto dep_idx = static_cast<size_t>(dep_iid - first_iid);
+			assert(dep_idx < i - 1 && instrs[dep_idx]->get_id() == dep_iid);
+			path_duration[dep_idx] = std::max(path_duration[dep_idx], path_duration[i - 1]);
+		}
+	}
+
+	for(size_t i = 0; i < instrs.size(); ++i) {
+		instrs[i]->set_priority(instrs[i]->get_priority() + critical_path_priority(path_duration[i]));
+		if(is_recording()) { m_recorder->record_instruction_priority(instrs[i]->get_id(), instrs[i]->get_priority()); }
+	}
+}
+
 void generator_impl::flush_batch(batch&& batch) { // NOLINT(cppcoreguidelines-rvalue-reference-param-not-moved) we do move the members of `batch`
 	// sanity check: every instruction except the initial epoch must be temporally anchored through at least one dependency
 	assert(std::all_of(batch.generated_instructions.begin(), batch.generated_instructions.end(),
@@ -2000,8 +2535,12 @@ void generator_impl::flush_batch(batch&& batch) { // NOLINT(cppcoreguidelines-rv
 		}) != m_recorder->get_instructions().end();
 	}));
 
+	prioritize_critical_paths(batch);
+
 	if(m_delegate != nullptr) {
-		if(!batch.generated_instructions.empty()) { m_delegate->flush_instructions(std::move(batch.generated_instructions)); }
+		if(!batch.generated_instructions.empty()) {
+			m_delegate->flush_instructions(std::vector<const instruction*>(batch.generated_instructions.begin(), batch.generated_instructions.end()));
+		}
 		if(!batch.generated_pilots.empty()) { m_delegate->flush_outbound_pilots(std::move(batch.generated_pilots)); }
 	}
 
@@ -2026,6 +2565,41 @@ void generator_impl::compile(const abstract_command& cmd) {
 	flush_batch(std::move(command_batch));
 }
 
+void generator_impl::anticipate(const abstract_command& cmd) {
+	// Only execution commands benefit from anticipation: pushes send from existing allocations and all other commands do not allocate buffer memory.
+	if(utils::isa<execution_command>(&cmd)) { anticipate_execution_command(*utils::as<execution_command>(&cmd)); }
+}
+
+instruction_graph_generator::state_statistics generator_impl::get_state_statistics() const {
+	instruction_graph_generator::state_statistics stats;
+	const auto count_entries = [&](const auto& map, const size_t value_size) {
+		const auto num_entries = map.get_num_entries();
+		stats.num_region_map_entries += num_entries;
+		stats.approximate_bytes += num_entries * (sizeof(box<3>) + value_size);
+	};
+	const auto count_access_fronts = [&](const region_map<access_front>& fronts, const box<3>& allocated_box) {
+		count_entries(fronts, sizeof(access_front));
+		for(const auto& [box, front] : fronts.get_region_values(allocated_box)) {
+			stats.num_access_front_instructions += front.get_instructions().size();
+		}
+	};
+
+	for(const auto& [bid, buffer] : m_buffers) {
+		++stats.num_buffers;
+		count_entries(buffer.up_to_date_memories, sizeof(memory_mask));
+		count_entries(buffer.original_writers, sizeof(instruction*));
+		count_entries(buffer.original_write_memories, sizeof(memory_id));
+		for(const auto& memory : buffer.memories) {
+			for(const auto& alloc : memory.allocations) {
+				++stats.num_allocations;
+				count_access_fronts(alloc.last_writers, alloc.box);
+				count_access_fronts(alloc.last_concurrent_accesses, alloc.box);
+			}
+		}
+	}
+	return stats;
+}
+
 std::string generator_impl::print_buffer_debug_label(const buffer_id bid) const { return utils::make_buffer_debug_label(bid, m_buffers.at(bid).debug_name); }
 
 } // namespace celerity::detail::instruction_graph_generator_detail
@@ -2033,8 +2607,8 @@ std::string generator_impl::print_buffer_debug_label(const buffer_id bid) const
 namespace celerity::detail {
 
 instruction_graph_generator::instruction_graph_generator(const task_manager& tm, const size_t num_nodes, const node_id local_nid, const system_info& system,
-    instruction_graph& idag, delegate* dlg, instruction_recorder* const recorder, const policy_set& policy)
-    : m_impl(new instruction_graph_generator_detail::generator_impl(tm, num_nodes, local_nid, system, idag, dlg, recorder, policy)) {}
+    instruction_graph& idag, delegate* dlg, instruction_recorder* const recorder, const policy_set& policy, const cost_model* const costs)
+    : m_impl(new instruction_graph_generator_detail::generator_impl(tm, num_nodes, local_nid, system, idag, dlg, recorder, policy, costs)) {}
 
 instruction_graph_generator::~instruction_graph_generator() = default;
 
@@ -2055,6 +2629,10 @@ void instruction_graph_generator::notify_host_object_created(const host_object_i
 
 void instruction_graph_generator::notify_host_object_destroyed(const host_object_id hoid) { m_impl->notify_host_object_destroyed(hoid); }
 
+void instruction_graph_generator::anticipate(const abstract_command& cmd) { m_impl->anticipate(cmd); }
+
 void instruction_graph_generator::compile(const abstract_command& cmd) { m_impl->compile(cmd); }
 
+instruction_graph_generator::state_statistics instruction_graph_generator::get_state_statistics() const { return m_impl->get_state_statistics(); }
+
 } // namespace celerity::detail
@@ -0,0 +1,679 @@
+#include "live_executor.h"
+
+#include "affinity.h"
+#include "closure_hydrator.h"
+#include "communicator.h"
+#include "cost_model.h"
+#include "instruction_graph.h"
+#include "log.h"
+#include "mpi_communicator.h"
+#include "mpsc_queue.h"
+#include "named_threads.h"
+#include "out_of_order_engine.h"
+#include "pilot.h"
+#include "print_utils.h"
+#include "receive_arbiter.h"
+#include "reduction_manager.h"
+#include "staging_pool.h"
+#include "system_info.h"
+#include "utils.h"
+
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <thread>
+#include <unordered_map>
+#include <variant>
+
+#include <matchbox.hh>
+
+namespace celerity::detail::live_executor_detail {
+
+/// Completion of an operation in a `thread_queue`. Any exception thrown by the operation is re-thrown from `is_complete` on the polling thread.
+class future_event final : public async_event_impl {
+  public:
+	explicit future_event(std::future<void> future) : m_future(std::move(future)) {}
+	bool is_complete() const override {
+		if(!m_future.valid()) return true; // result has already been retrieved
+		if(m_future.wait_for(std::chrono::seconds(0)) != std::future_status::ready) return false;
+		m_future.get();
+		return true;
+	}
+
+  private:
+	mutable std::future<void> m_future;
+};
+
+/// Completion of an operation in a SYCL queue.
+class sycl_event final : public async_event_impl {
+  public:
+	explicit sycl_event(sycl::event event) : m_event(std::move(event)) {}
+	bool is_complete() const override {
+		return m_event.get_info<sycl::info::event::command_execution_status>() == sycl::info::event_command_status::complete;
+	}
+
+  private:
+	mutable sycl::event m_event;
+};
+
+/// A single worker thread executing jobs in submission order. Host lanes of `out_of_order_engine` map 1:1 to thread queues, which makes eager assignment of
+/// host tasks and host copies to a lane safe.
+class thread_queue {
+  public:
+	explicit thread_queue(const std::string& name, const std::vector<uint32_t>& core_ids) : m_thread(&thread_queue::loop, this) {
+		set_thread_name(m_thread.native_handle(), name);
+#ifndef __APPLE__
+		if(!core_ids.empty() && !set_thread_affinity(m_thread.native_handle(), core_ids)) { CELERITY_WARN("Failed to set the affinity of thread {}", name); }
+#endif
+	}
+
+	thread_queue(const thread_queue&) = delete;
+	thread_queue(thread_queue&&) = delete;
+	thread_queue& operator=(const thread_queue&) = delete;
+	thread_queue& operator=(thread_queue&&) = delete;
+
+	~thread_queue() {
+		m_jobs.push(std::packaged_task<void()>{}); // an empty job signals shutdown
+		m_thread.join();
+	}
+
+	/// Exceptions thrown by `fn` are captured in the returned event, so that the executor can report them in the context of the instruction that failed.
+	async_event submit(std::function<void()> fn) {
+		std::packaged_task<void()> job(std::move(fn));
+		auto future = job.get_future();
+		m_jobs.push(std::move(job));
+		return make_async_event<future_event>(std::move(future));
+	}
+
+  private:
+	constexpr static size_t queue_capacity = 1024;
+
+	mpsc_queue<std::packaged_task<void()>> m_jobs{queue_capacity};
+	std::thread m_thread;
+
+	void loop() {
+		closure_hydrator::make_available();
+		for(;;) {
+			auto job = m_jobs.pop();
+			if(!job.valid()) break;
+			job();
+		}
+		closure_hydrator::teardown();
+	}
+};
+
+/// Calls `fn(source_offset_bytes, dest_offset_bytes, size_bytes)` for each contiguous chunk of a strided copy between two 3D allocations, merging rows
+/// wherever both allocations are contiguous across them.
+template <typename Fn>
+void for_each_contiguous_chunk(const range<3>& source_range, const id<3>& source_offset, const range<3>& dest_range, const id<3>& dest_offset,
+    const range<3>& copy_range, const size_t elem_size, Fn&& fn) {
+	if(copy_range.size() == 0) return;
+	const auto full_rows = copy_range[2] == source_range[2] && copy_range[2] == dest_range[2];
+	const auto full_slices = full_rows && copy_range[1] == source_range[1] && copy_range[1] == dest_range[1];
+	const auto chunk = [&](const size_t i0, const size_t i1, const size_t num_elems) {
+		const auto source_index = get_linear_index(source_range, source_offset + id<3>(i0, i1, 0));
+		const auto dest_index = get_linear_index(dest_range, dest_offset + id<3>(i0, i1, 0));
+		fn(source_index * elem_size, dest_index * elem_size, num_elems * elem_size);
+	};
+	if(full_slices) {
+		chunk(0, 0, copy_range.size());
+	} else if(full_rows) {
+		for(size_t i0 = 0; i0 < copy_range[0]; ++i0) {
+			chunk(i0, 0, copy_range[1] * copy_range[2]);
+		}
+	} else {
+		for(size_t i0 = 0; i0 < copy_range[0]; ++i0) {
+			for(size_t i1 = 0; i1 < copy_range[1]; ++i1) {
+				chunk(i0, i1, copy_range[2]);
+			}
+		}
+	}
+}
+
+struct user_allocation_announcement {
+	allocation_id aid;
+	void* ptr;
+};
+
+using submission = std::variant<std::vector<const instruction*>, std::vector<outbound_pilot>, user_allocation_announcement>;
+
+#if CELERITY_ACCESSOR_BOUNDARY_CHECK
+/// Out-of-bounds indices reported by the accessors of a single kernel or host task. Index [0] holds the lower bound, index [1] the upper bound.
+struct boundary_check_info {
+	std::string task_name;
+	bool is_kernel;
+	std::vector<id<3>*> oob_indices; ///< one pair of indices per accessor
+	std::vector<buffer_access_allocation> accesses;
+	sycl::queue* queue; ///< queue the indices were allocated on
+};
+#endif
+
+struct in_flight_instruction {
+	const instruction* instr;
+	async_event event;
+	std::chrono::steady_clock::time_point dispatch_time; ///< for cost model observations
+#if CELERITY_ACCESSOR_BOUNDARY_CHECK
+	std::unique_ptr<boundary_check_info> oob_info;
+#endif
+};
+
+struct device_state {
+	sycl::device device;
+	sycl::context context;
+	std::vector<sycl::queue> queues; ///< one in-order queue per engine lane, all in `context`
+};
+
+struct executor_impl {
+	constexpr static size_t submission_queue_capacity = 4096;
+
+	system_info system;
+	std::vector<device_state> devices;
+	std::unique_ptr<communicator> root_communicator;
+	reduction_manager* reduction_mngr;
+	live_executor::delegate* dlg;
+	cost_model* costs;
+	std::vector<uint32_t> host_core_ids;
+
+	mpsc_queue<submission> submissions{submission_queue_capacity};
+	std::thread thread;
+
+	// The following members are only accessed from the executor thread
+	out_of_order_engine engine;
+	receive_arbiter recv_arbiter;
+	std::unordered_map<collective_group_id, std::unique_ptr<communicator>> collective_groups;
+	std::unordered_map<allocation_id, void*> allocations;
+	std::unordered_map<allocation_id, size_t> host_alignments; ///< of host allocations from aligned operator new, which must be passed to operator delete
+	staging_pool staging_buffers; ///< destinations of linearize_instructions and staging alloc_instructions, released by their free_instruction
+	std::vector<std::unique_ptr<thread_queue>> host_lanes;
+	std::vector<in_flight_instruction> in_flight;
+	bool shutdown_reached = false;
+
+	executor_impl(const system_info& system, std::vector<sycl::device> sycl_devices, std::unique_ptr<communicator> root_comm,
+	    reduction_manager& reduction_mngr, live_executor::delegate* dlg, cost_model* costs, std::vector<uint32_t> host_core_ids);
+
+	void loop();
+	void poll_in_flight();
+	void dispatch(const out_of_order_engine::assignment& assignment);
+
+	void* get_pointer(const allocation_with_offset& awo) const;
+	sycl::queue& get_device_queue(device_id did, out_of_order_engine::lane_id lane);
+	thread_queue& get_host_lane(out_of_order_engine::lane_id lane);
+	MPI_Comm get_native_comm(collective_group_id cgid) const;
+
+	void* allocate(const alloc_instruction& ainstr);
+	void deallocate(const free_instruction& finstr);
+	async_event copy(const copy_instruction& cinstr, const out_of_order_engine::assignment& assignment);
+	async_event linearize(const linearize_instruction& linstr, const out_of_order_engine::assignment& assignment);
+	async_event launch_device_kernel(const device_kernel_instruction& dkinstr, const out_of_order_engine::assignment& assignment, in_flight_instruction& entry);
+	async_event launch_host_task(const host_task_instruction& htinstr, const out_of_order_engine::assignment& assignment, in_flight_instruction& entry);
+	void collect_garbage(const instruction_garbage& garbage);
+
+	std::vector<closure_hydrator::accessor_info> make_accessor_infos(
+	    const buffer_access_allocation_map& amap, const std::string& task_name, bool is_kernel, sycl::queue* oob_queue, in_flight_instruction& entry) const;
+#if CELERITY_ACCESSOR_BOUNDARY_CHECK
+	static void report_boundary_check(const boundary_check_info& info);
+#endif
+};
+
+executor_impl::executor_impl(const system_info& system, std::vector<sycl::device> sycl_devices, std::unique_ptr<communicator> root_comm,
+    reduction_manager& reduction_mngr, live_executor::delegate* const dlg, cost_model* const costs, std::vector<uint32_t> host_core_ids)
+    : system(system), root_communicator(std::move(root_comm)), reduction_mngr(&reduction_mngr), dlg(dlg), costs(costs),
+      host_core_ids(std::move(host_core_ids)), engine(system),
+      recv_arbiter(*root_communicator),
+      staging_buffers(
+          [this](const size_t size, const size_t alignment) -> void* {
+	          if(devices.empty()) return ::operator new(size, std::align_val_t(alignment));
+	          // Pinned like all other host allocations, so that the communicator can DMA from staging buffers
+	          return sycl::aligned_alloc_host(alignment, size, devices.front().context);
+          },
+          [this](void* const ptr) {
+	          if(devices.empty()) {
+		          ::operator delete(ptr, std::align_val_t(staging_pool::buffer_alignment));
+	          } else {
+		          sycl::free(ptr, devices.front().context);
+	          }
+          }) {
+	assert(sycl_devices.size() == system.devices.size());
+	for(auto& device : sycl_devices) {
+		// Manually create context as workaround for https://github.com/intel/llvm/issues/10982 (see device_queue)
+		sycl::context context{device};
+		devices.push_back(device_state{std::move(device), std::move(context), {}});
+	}
+
+	// Collective host tasks must not share a communicator with the p2p traffic of the executor. This is a collective operation, so it has to happen in the
+	// constructor, which is called on all nodes in the same order.
+	collective_groups.emplace(root_collective_group_id, root_communicator->collective_clone());
+
+	allocations.emplace(null_allocation_id, nullptr);
+}
+
+void* executor_impl::get_pointer(const allocation_with_offset& awo) const {
+	if(awo.id == null_allocation_id) return nullptr;
+	return static_cast<std::byte*>(allocations.at(awo.id)) + awo.offset_bytes;
+}
+
+sycl::queue& executor_impl::get_device_queue(const device_id did, const out_of_order_engine::lane_id lane) {
+	auto& dev = devices.at(did);
+	while(dev.queues.size() <= lane) {
+		const auto handle_exceptions = sycl::async_handler{[](sycl::exception_list el) {
+			for(auto& e : el) {
+				try {
+					std::rethrow_exception(e);
+				} catch(sycl::exception& e) {
+					CELERITY_ERROR("SYCL asynchronous exception: {}. Terminating.", e.what());
+					std::terminate();
+				}
+			}
+		}};
+		dev.queues.emplace_back(dev.context, dev.device, handle_exceptions, sycl::property::queue::in_order{});
+	}
+	return dev.queues[lane];
+}
+
+thread_queue& executor_impl::get_host_lane(const out_of_order_engine::lane_id lane) {
+	while(host_lanes.size() <= lane) {
+		host_lanes.push_back(std::make_unique<thread_queue>(fmt::format("cy-host-{}", host_lanes.size()), host_core_ids));
+	}
+	return *host_lanes[lane];
+}
+
+MPI_Comm executor_impl::get_native_comm(const collective_group_id cgid) const {
+	if(cgid == non_collective_group_id) return MPI_COMM_NULL;
+	return utils::as<mpi_communicator>(collective_groups.at(cgid).get())->get_native();
+}
+
+void* executor_impl::allocate(const alloc_instruction& ainstr) {
+	const auto mid = ainstr.get_allocation_id().get_memory_id();
+	assert(mid != user_memory_id);
+	if(ainstr.is_staging()) {
+		assert(mid == host_memory_id);
+		assert(ainstr.get_alignment_bytes() <= staging_pool::buffer_alignment);
+		return staging_buffers.acquire(ainstr.get_size_bytes());
+	}
+	if(mid == host_memory_id) {
+		if(devices.empty()) {
+			host_alignments.emplace(ainstr.get_allocation_id(), ainstr.get_alignment_bytes());
+			return ::operator new(ainstr.get_size_bytes(), std::align_val_t(ainstr.get_alignment_bytes()));
+		}
+		// Pinned host memory in the context of the first device, so that copies from and to it can be DMA'd
+		return sycl::aligned_alloc_host(ainstr.get_alignment_bytes(), ainstr.get_size_bytes(), devices.front().context);
+	}
+	for(device_id did = 0; did < system.devices.size(); ++did) {
+		if(system.devices[did].native_memory == mid) {
+			return sycl::aligned_alloc_device(ainstr.get_alignment_bytes(), ainstr.get_size_bytes(), devices[did].device, devices[did].context);
+		}
+	}
+	utils::panic("no device has native memory M{}", mid);
+}
+
+void executor_impl::deallocate(const free_instruction& finstr) {
+	const auto aid = finstr.get_allocation_id();
+	const auto it = allocations.find(aid);
+	assert(it != allocations.end());
+	if(staging_buffers.is_acquired(it->second)) {
+		staging_buffers.release(it->second);
+		allocations.erase(it);
+		return;
+	}
+	const auto mid = aid.get_memory_id();
+	if(mid == host_memory_id) {
+		if(devices.empty()) {
+			const auto alignment = host_alignments.find(aid);
+			assert(alignment != host_alignments.end());
+			::operator delete(it->second, std::align_val_t(alignment->second));
+			host_alignments.erase(alignment);
+		} else {
+			sycl::free(it->second, devices.front().context);
+		}
+	} else {
+		for(device_id did = 0; did < system.devices.size(); ++did) {
+			if(system.devices[did].native_memory == mid) {
+				sycl::free(it->second, devices[did].context);
+				break;
+			}
+		}
+	}
+	allocations.erase(it);
+}
+
+async_event executor_impl::copy(const copy_instruction& cinstr, const out_of_order_engine::assignment& assignment) {
+	const auto* const source_base = static_cast<const std::byte*>(get_pointer(cinstr.get_source_allocation()));
+	auto* const dest_base = static_cast<std::byte*>(get_pointer(cinstr.get_dest_allocation()));
+	const auto& source_box = cinstr.get_source_box();
+	const auto& dest_box = cinstr.get_dest_box();
+	const auto elem_size = cinstr.get_element_size();
+
+	if(assignment.target == out_of_order_engine::target::device_queue) {
+		auto& queue = get_device_queue(*assignment.device, *assignment.lane);
+		std::optional<sycl::event> last;
+		for(const auto& box : cinstr.get_copy_region().get_boxes()) {
+			for_each_contiguous_chunk(source_box.get_range(), box.get_offset() - source_box.get_offset(), dest_box.get_range(),
+			    box.get_offset() - dest_box.get_offset(), box.get_range(), elem_size,
+			    [&](const size_t source_offset, const size_t dest_offset, const size_t bytes) {
+				    last = queue.memcpy(dest_base + dest_offset, source_base + source_offset, bytes);
+			    });
+		}
+		// The queue is in-order, so the last copy completing implies that all previous ones have
+		if(!last.has_value()) return make_complete_event();
+		return make_async_event<sycl_event>(std::move(*last));
+	}
+
+	assert(assignment.target == out_of_order_engine::target::host_queue);
+	return get_host_lane(*assignment.lane).submit([&cinstr, source_base, dest_base, source_box, dest_box, elem_size] {
+		for(const auto& box : cinstr.get_copy_region().get_boxes()) {
+			for_each_contiguous_chunk(source_box.get_range(), box.get_offset() - source_box.get_offset(), dest_box.get_range(),
+			    box.get_offset() - dest_box.get_offset(), box.get_range(), elem_size,
+			    [&](const size_t source_offset, const size_t dest_offset, const size_t bytes) {
+				    std::memcpy(dest_base + dest_offset, source_base + source_offset, bytes);
+			    });
+		}
+	});
+}
+
+async_event executor_impl::linearize(const linearize_instruction& linstr, const out_of_order_engine::assignment& assignment) {
+	assert(assignment.target == out_of_order_engine::target::host_queue);
+	auto* const staging = static_cast<std::byte*>(staging_buffers.acquire(linstr.get_staging_size_bytes()));
+	CELERITY_TRACE("[executor] I{}: linearize {} -> {}, {} bytes", linstr.get_id(), linstr.get_source_allocation_id(), linstr.get_staging_allocation_id(),
+	    linstr.get_staging_size_bytes());
+	allocations.emplace(linstr.get_staging_allocation_id(), staging);
+
+	const auto* const source_base = static_cast<const std::byte*>(get_pointer(linstr.get_source_allocation_id()));
+	return get_host_lane(*assignment.lane).submit([&linstr, source_base, staging] {
+		for_each_contiguous_chunk(linstr.get_source_allocation_range(), linstr.get_offset_in_source_allocation(), linstr.get_linearize_range(), zeros,
+		    linstr.get_linearize_range(), linstr.get_element_size(), [&](const size_t source_offset, const size_t dest_offset, const size_t bytes) {
+			    std::memcpy(staging + dest_offset, source_base + source_offset, bytes);
+		    });
+	});
+}
+
+std::vector<closure_hydrator::accessor_info> executor_impl::make_accessor_infos(const buffer_access_allocation_map& amap,
+    [[maybe_unused]] const std::string& task_name, [[maybe_unused]] const bool is_kernel, [[maybe_unused]] sycl::queue* const oob_queue,
+    [[maybe_unused]] in_flight_instruction& entry) const {
+	std::vector<closure_hydrator::accessor_info> accessor_infos;
+	accessor_infos.reserve(amap.size());
+#if CELERITY_ACCESSOR_BOUNDARY_CHECK
+	auto oob_info = std::make_unique<boundary_check_info>(boundary_check_info{task_name, is_kernel, {}, amap, oob_queue});
+#endif
+	for(const auto& baa : amap) {
+		const auto ptr = get_pointer(baa.allocation_id);
+		const auto& allocated = baa.allocated_box_in_buffer;
+#if CELERITY_ACCESSOR_BOUNDARY_CHECK
+		auto* const oob_indices = oob_queue != nullptr ? sycl::malloc_host<id<3>>(2, *oob_queue) : new id<3>[2];
+		assert(oob_indices != nullptr);
+		constexpr size_t size_t_max = std::numeric_limits<size_t>::max();
+		oob_indices[0] = id<3>{size_t_max, size_t_max, size_t_max};
+		oob_indices[1] = id<3>{0, 0, 0};
+		oob_info->oob_indices.push_back(oob_indices);
+		accessor_infos.push_back(
+		    closure_hydrator::accessor_info{ptr, allocated.get_range(), allocated.get_offset(), baa.accessed_box_in_buffer.get_subrange(), oob_indices});
+#else
+		accessor_infos.push_back(
+		    closure_hydrator::accessor_info{ptr, allocated.get_range(), allocated.get_offset(), baa.accessed_box_in_buffer.get_subrange()});
+#endif
+	}
+#if CELERITY_ACCESSOR_BOUNDARY_CHECK
+	entry.oob_info = std::move(oob_info);
+#endif
+	return accessor_infos;
+}
+
+#if CELERITY_ACCESSOR_BOUNDARY_CHECK
+void executor_impl::report_boundary_check(const boundary_check_info& info) {
+	for(size_t i = 0; i < info.oob_indices.size(); ++i) {
+		id<3> oob_min = info.oob_indices[i][0];
+		const id<3>& oob_max = info.oob_indices[i][1];
+		if(oob_max != id<3>{0, 0, 0}) {
+			// Accessors of lower dimensionality never touch the lower bound of unused dimensions
+			for(int d = 0; d < 3; ++d) {
+				if(oob_min[d] == std::numeric_limits<size_t>::max()) { oob_min[d] = 0; }
+			}
+			const auto& access = info.accesses[i];
+			const auto oob_sr = subrange<3>(oob_min, range_cast<3>(oob_max - oob_min));
+			const auto buffer_label = !access.oob_buffer_name.empty() ? fmt::format("B{} \"{}\"", access.oob_buffer_id, access.oob_buffer_name)
+			                                                          : fmt::format("B{}", access.oob_buffer_id);
+			const auto where = info.is_kernel ? fmt::format("kernel '{}'", info.task_name) : std::string("host task");
+			CELERITY_ERROR("Out-of-bounds access in {} detected: Accessor {} for buffer {} attempted to access indices between {} which are outside of mapped "
+			               "subrange {}",
+			    where, i, buffer_label, oob_sr, access.accessed_box_in_buffer.get_subrange());
+		}
+		if(info.queue != nullptr) {
+			sycl::free(info.oob_indices[i], *info.queue);
+		} else {
+			delete[] info.oob_indices[i];
+		}
+	}
+}
+#endif
+
+async_event executor_impl::launch_device_kernel(
+    const device_kernel_instruction& dkinstr, const out_of_order_engine::assignment& assignment, in_flight_instruction& entry) {
+	assert(assignment.target == out_of_order_engine::target::device_queue);
+	auto& queue = get_device_queue(*assignment.device, *assignment.lane);
+
+#if CELERITY_ACCESSOR_BOUNDARY_CHECK
+	const auto& task_name = dkinstr.get_oob_task_name();
+#else
+	const std::string task_name;
+#endif
+	auto accessor_infos = make_accessor_infos(dkinstr.get_access_allocations(), task_name, true /* is_kernel */, &queue, entry);
+
+	std::vector<void*> reduction_ptrs;
+	reduction_ptrs.reserve(dkinstr.get_reduction_allocations().size());
+	for(const auto& rinfo : dkinstr.get_reduction_allocations()) {
+		assert(rinfo.allocated_box_in_buffer == rinfo.accessed_box_in_buffer);
+		reduction_ptrs.push_back(get_pointer(rinfo.allocation_id));
+	}
+
+	closure_hydrator::get_instance().arm(target::device, std::move(accessor_infos));
+	auto event = queue.submit([&](sycl::handler& cgh) { dkinstr.get_launcher()(cgh, dkinstr.get_execution_range(), reduction_ptrs); });
+	return make_async_event<sycl_event>(std::move(event));
+}
+
+async_event executor_impl::launch_host_task(
+    const host_task_instruction& htinstr, const out_of_order_engine::assignment& assignment, in_flight_instruction& entry) {
+	assert(assignment.target == out_of_order_engine::target::host_queue);
+
+#if CELERITY_ACCESSOR_BOUNDARY_CHECK
+	const auto& task_name = htinstr.get_oob_task_name();
+#else
+	const std::string task_name;
+#endif
+	auto accessor_infos = make_accessor_infos(htinstr.get_access_allocations(), task_name, false /* is_kernel */, nullptr, entry);
+	const auto comm = get_native_comm(htinstr.get_collective_group_id());
+
+	// The closure hydrator is thread-local, so it must be armed on the thread that invokes the launcher
+	return get_host_lane(*assignment.lane).submit([&htinstr, accessor_infos = std::move(accessor_infos), comm]() mutable {
+		closure_hydrator::get_instance().arm(target::host_task, std::move(accessor_infos));
+		htinstr.get_launcher()(htinstr.get_execution_range(), comm);
+	});
+}
+
+void executor_impl::collect_garbage(const instruction_garbage& garbage) {
+	for(const auto rid : garbage.reductions) {
+		reduction_mngr->erase_reduction(rid);
+	}
+	for(const auto aid : garbage.user_allocations) {
+		assert(aid.get_memory_id() == user_memory_id);
+		allocations.erase(aid);
+	}
+}
+
+void executor_impl::dispatch(const out_of_order_engine::assignment& assignment) {
+	in_flight_instruction entry{assignment.instruction, {}, std::chrono::steady_clock::now()};
+
+	// Instructions that are executed synchronously on the executor thread return a complete event
+	entry.event = matchbox::match(
+	    *assignment.instruction,
+	    [&](const clone_collective_group_instruction& ccginstr) {
+		    const auto& original = collective_groups.at(ccginstr.get_original_collective_group_id());
+		    collective_groups.emplace(ccginstr.get_new_collective_group_id(), original->collective_clone());
+		    return make_complete_event();
+	    },
+	    [&](const alloc_instruction& ainstr) {
+		    const auto ptr = allocate(ainstr);
+		    CELERITY_TRACE("[executor] I{}: alloc {}, {} bytes -> {}", ainstr.get_id(), ainstr.get_allocation_id(), ainstr.get_size_bytes(), ptr);
+		    allocations.emplace(ainstr.get_allocation_id(), ptr);
+		    return make_complete_event();
+	    },
+	    [&](const free_instruction& finstr) {
+		    deallocate(finstr);
+		    return make_complete_event();
+	    },
+	    [&](const copy_instruction& cinstr) { return copy(cinstr, assignment); },
+	    [&](const device_kernel_instruction& dkinstr) { return launch_device_kernel(dkinstr, assignment, entry); },
+	    [&](const host_task_instruction& htinstr) { return launch_host_task(htinstr, assignment, entry); },
+	    [&](const linearize_instruction& linstr) { return linearize(linstr, assignment); },
+	    [&](const send_instruction& sinstr) {
+		    const auto stride = communicator::stride{sinstr.get_source_allocation_range(),
+		        subrange<3>(sinstr.get_offset_in_source_allocation(), sinstr.get_send_range()), sinstr.get_element_size()};
+		    return root_communicator->send_payload(sinstr.get_dest_node_id(), sinstr.get_message_id(), get_pointer(sinstr.get_source_allocation_id()), stride);
+	    },
+	    [&](const receive_instruction& rinstr) {
+		    return recv_arbiter.receive(rinstr.get_transfer_id(), rinstr.get_requested_region(), get_pointer(rinstr.get_dest_allocation_id()),
+		        rinstr.get_allocated_box(), rinstr.get_element_size());
+	    },
+	    [&](const split_receive_instruction& srinstr) {
+		    recv_arbiter.begin_split_receive(srinstr.get_transfer_id(), srinstr.get_requested_region(), get_pointer(srinstr.get_dest_allocation_id()),
+		        srinstr.get_allocated_box(), srinstr.get_element_size());
+		    return make_complete_event();
+	    },
+	    [&](const await_receive_instruction& arinstr) {
+		    return recv_arbiter.await_split_receive_subregion(arinstr.get_transfer_id(), arinstr.get_received_region());
+	    },
+	    [&](const gather_receive_instruction& grinstr) {
+		    return recv_arbiter.gather_receive(grinstr.get_transfer_id(), get_pointer(grinstr.get_dest_allocation_id()), grinstr.get_node_chunk_size());
+	    },
+	    [&](const fill_identity_instruction& fiinstr) {
+		    reduction_mngr->fill_identity(fiinstr.get_reduction_id(), get_pointer(fiinstr.get_allocation_id()), fiinstr.get_num_values());
+		    return make_complete_event();
+	    },
+	    [&](const reduce_instruction& rinstr) {
+		    reduction_mngr->reduce(rinstr.get_reduction_id(), get_pointer(rinstr.get_dest_allocation_id()), get_pointer(rinstr.get_source_allocation_id()),
+		        rinstr.get_num_source_values());
+		    return make_complete_event();
+	    },
+	    [&](const fence_instruction& finstr) {
+		    finstr.get_promise()->fulfill();
+		    return make_complete_event();
+	    },
+	    [&](const destroy_host_object_instruction& /* dhoinstr */) {
+		    // Host object instances are owned by host_object_manager, so the runtime never asks the instruction graph generator to destroy them
+		    return make_complete_event();
+	    },
+	    [&](const horizon_instruction& hinstr) {
+		    if(dlg != nullptr) { dlg->horizon_reached(hinstr.get_horizon_task_id()); }
+		    recv_arbiter.notify_epoch_reached();
+		    collect_garbage(hinstr.get_garbage());
+		    return make_complete_event();
+	    },
+	    [&](const epoch_instruction& einstr) {
+		    if(einstr.get_epoch_action() == epoch_action::barrier) { collective_groups.at(root_collective_group_id)->collective_barrier(); }
+		    if(einstr.get_epoch_action() == epoch_action::shutdown) { shutdown_reached = true; }
+		    collect_garbage(einstr.get_garbage());
+		    recv_arbiter.notify_epoch_reached();
+		    if(dlg != nullptr) { dlg->epoch_reached(einstr.get_epoch_task_id()); }
+		    return make_complete_event();
+	    });
+
+	in_flight.push_back(std::move(entry));
+}
+
+void executor_impl::poll_in_flight() {
+	const auto now = costs != nullptr ? std::chrono::steady_clock::now() : std::chrono::steady_clock::time_point();
+	for(auto it = in_flight.begin(); it != in_flight.end();) {
+		// Like the legacy executor, we report exceptions from host tasks and treat the instruction as complete so that execution can proceed
+		bool is_complete = false;
+		try {
+			is_complete = it->event.is_complete();
+		} catch(std::exception& e) {
+			CELERITY_ERROR("exception in instruction I{}: {}", it->instr->get_id(), e.what());
+			is_complete = true;
+		} catch(...) {
+			CELERITY_ERROR("unknown exception in instruction I{}", it->instr->get_id());
+			is_complete = true;
+		}
+		if(is_complete) {
+			if(costs != nullptr) { costs->observe(*it->instr, now - it->dispatch_time); }
+#if CELERITY_ACCESSOR_BOUNDARY_CHECK
+			if(it->oob_info != nullptr) { report_boundary_check(*it->oob_info); }
+#endif
+			engine.complete_assigned(it->instr);
+			it = in_flight.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+void executor_impl::loop() {
+	closure_hydrator::make_available();
+
+	while(!(shutdown_reached && engine.is_idle())) {
+		// Only park the thread when there is nothing to poll for
+		std::optional<submission> next;
+		if(engine.is_idle() && in_flight.empty()) {
+			next = submissions.pop();
+		} else {
+			next = submissions.try_pop();
+		}
+		while(next.has_value()) {
+			matchbox::match(
+			    *next,
+			    [&](const std::vector<const instruction*>& instrs) {
+				    for(const auto instr : instrs) {
+					    engine.submit(instr);
+				    }
+			    },
+			    [&](const std::vector<outbound_pilot>& pilots) { root_communicator->send_outbound_pilots(pilots); },
+			    [&](const user_allocation_announcement& ann) { allocations.emplace(ann.aid, ann.ptr); });
+			next = submissions.try_pop();
+		}
+
+		recv_arbiter.poll_communicator();
+		poll_in_flight();
+
+		while(const auto assignment = engine.assign_one()) {
+			dispatch(*assignment);
+		}
+	}
+
+	assert(in_flight.empty());
+	host_lanes.clear();
+	for(auto& dev : devices) {
+		for(auto& queue : dev.queues) {
+			queue.wait_and_throw();
+		}
+	}
+	closure_hydrator::teardown();
+}
+
+} // namespace celerity::detail::live_executor_detail
+
+namespace celerity::detail {
+
+using namespace live_executor_detail;
+
+live_executor::live_executor(const system_info& system, std::vector<sycl::device> devices, std::unique_ptr<communicator> root_comm,
+    reduction_manager& reduction_mngr, delegate* const dlg, cost_model* const costs, std::vector<uint32_t> host_core_ids)
+    : m_impl(std::make_unique<executor_impl>(system, std::move(devices), std::move(root_comm), reduction_mngr, dlg, costs, std::move(host_core_ids))) {}
+
+live_executor::~live_executor() { assert(!m_impl->thread.joinable()); }
+
+void live_executor::startup() {
+	m_impl->thread = std::thread(&executor_impl::loop, m_impl.get());
+	set_thread_name(m_impl->thread.native_handle(), "cy-executor");
+}
+
+std::thread::native_handle_type live_executor::get_thread_handle() { return m_impl->thread.native_handle(); }
+
+void live_executor::announce_user_allocation(const allocation_id aid, void* const ptr) { m_impl->submissions.push(user_allocation_announcement{aid, ptr}); }
+
+void live_executor::flush_instructions(std::vector<const instruction*> instrs) { m_impl->submissions.push(std::move(instrs)); }
+
+void live_executor::flush_outbound_pilots(std::vector<outbound_pilot> pilots) { m_impl->submissions.push(std::move(pilots)); }
+
+void live_executor::shutdown() {
+	if(m_impl->thread.joinable()) { m_impl->thread.join(); }
+}
+
+} // namespace celerity::detail
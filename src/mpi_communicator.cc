@@ -3,8 +3,10 @@
 #include "mpi_support.h"
 #include "ranges.h"
 
+#include <algorithm>
 #include <climits>
 #include <cstddef>
+#include <memory>
 
 #include <mpi.h>
 
@@ -36,13 +38,114 @@ class mpi_event final : public async_event_impl {
 	mutable MPI_Request m_req;
 };
 
+/// A persistent send or receive request, bound to a peer, tag, base pointer and datatype. The datatype is duplicated so that the request remains valid after
+/// the original has been evicted from the datatype cache.
+class persistent_request {
+  public:
+	persistent_request(const bool is_send, const void* const base, const communicator::stride& stride, const MPI_Datatype type, const int rank, const int tag,
+	    const MPI_Comm comm)
+	    : m_base(base), m_stride(stride) {
+		MPI_Type_dup(type, &m_type);
+		if(is_send) {
+			MPI_Send_init(base, 1, m_type, rank, tag, comm, &m_req);
+		} else {
+			MPI_Recv_init(const_cast<void*>(base), 1, m_type, rank, tag, comm, &m_req); // NOLINT(cppcoreguidelines-pro-type-const-cast)
+		}
+	}
+
+	persistent_request(const persistent_request&) = delete;
+	persistent_request(persistent_request&&) = delete;
+	persistent_request& operator=(const persistent_request&) = delete;
+	persistent_request& operator=(persistent_request&&) = delete;
+
+	~persistent_request() {
+		// recurring_operation keeps the request alive while it is active, so it is always inactive here
+		MPI_Request_free(&m_req);
+		MPI_Type_free(&m_type);
+	}
+
+	bool is_bound_to(const void* const base, const communicator::stride& stride) const { return m_base == base && m_stride == stride; }
+
+	void start() { MPI_Start(&m_req); }
+
+	bool test() {
+		int flag = -1;
+		MPI_Test(&m_req, &flag, MPI_STATUS_IGNORE);
+		return flag != 0;
+	}
+
+  private:
+	const void* m_base;
+	communicator::stride m_stride;
+	MPI_Datatype m_type = MPI_DATATYPE_NULL;
+	MPI_Request m_req = MPI_REQUEST_NULL;
+};
+
+/// A single transfer on a persistent request. The transfer is only started once the previous operation on the same channel has completed, because an active
+/// persistent request cannot be re-started, and receives on the same tag are matched in the order they are posted.
+class recurring_operation {
+  public:
+	recurring_operation(std::shared_ptr<persistent_request> req, std::shared_ptr<recurring_operation> predecessor)
+	    : m_req(std::move(req)), m_predecessor(std::move(predecessor)) {
+		poll(); // start right away if the channel is idle
+	}
+
+	/// Starts the transfer if its predecessor has completed and returns whether the transfer itself has completed.
+	bool poll() {
+		if(m_complete) return true;
+		if(m_predecessor != nullptr) {
+			if(!m_predecessor->poll()) return false;
+			m_predecessor = nullptr; // do not let completed operations pile up in a chain
+		}
+		if(!m_started) {
+			m_req->start();
+			m_started = true;
+		}
+		m_complete = m_req->test();
+		return m_complete;
+	}
+
+  private:
+	std::shared_ptr<persistent_request> m_req;
+	std::shared_ptr<recurring_operation> m_predecessor;
+	bool m_started = false;
+	bool m_complete = false;
+};
+
+/// async_event wrapper around a recurring_operation.
+class recurring_event final : public async_event_impl {
+  public:
+	explicit recurring_event(std::shared_ptr<recurring_operation> operation) : m_operation(std::move(operation)) {}
+
+	recurring_event(const recurring_event&) = delete;
+	recurring_event(recurring_event&&) = delete;
+	recurring_event& operator=(const recurring_event&) = delete;
+	recurring_event& operator=(recurring_event&&) = delete;
+
+	~recurring_event() override {
+		// Like mpi_event, we must not return before the user-provided buffer is released by MPI
+		while(!m_operation->poll()) {}
+	}
+
+	bool is_complete() const override { return m_operation->poll(); }
+
+  private:
+	std::shared_ptr<recurring_operation> m_operation;
+};
+
 constexpr int pilot_exchange_tag = mpi_support::TAG_COMMUNICATOR;
 constexpr int first_message_tag = pilot_exchange_tag + 1;
+constexpr int first_recurring_message_tag = first_message_tag + (INT_MAX - first_message_tag) / 2;
 
 constexpr int message_id_to_mpi_tag(message_id msgid) {
-	// If the resulting tag would overflow INT_MAX in a long-running program with many nodes, we wrap around to `first_message_tag` instead, assuming that
-	// there will never be a way to cause temporal ambiguity between transfers that are 2^31 message ids apart.
-	msgid %= static_cast<message_id>(INT_MAX - first_message_tag);
+	// One-off and recurring message ids are mapped to disjoint tag ranges. If the resulting tag would overflow its range in a long-running program with many
+	// nodes, we wrap around to the beginning of the range instead, assuming that there will never be a way to cause temporal ambiguity between transfers
+	// that are 2^30 message ids apart.
+	if(msgid >= first_recurring_message_id) {
+		msgid = (msgid - first_recurring_message_id) % static_cast<message_id>(INT_MAX - first_recurring_message_tag);
+		return first_recurring_message_tag + static_cast<int>(msgid);
+	}
+	msgid %= static_cast<message_id>(first_recurring_message_tag - first_message_tag);
 	return first_message_tag + static_cast<int>(msgid);
 }
 
@@ -90,22 +193,40 @@ constexpr std::tuple<Void*, communicator::stride> normalize_strided_pointer(Void
 
 namespace celerity::detail {
 
-mpi_communicator::mpi_communicator(const collective_clone_from_tag /* tag */, const MPI_Comm mpi_comm) : m_mpi_comm(MPI_COMM_NULL) {
-	assert(mpi_comm != MPI_COMM_NULL);
+/// Duplicates `comm` with our implementation hints. Coalesced pilot messages are received into buffers of the maximum message size, so the communicator they
+/// are exchanged on cannot promise `mpi_assert_exact_length`. Recurring payloads re-use the same tag for consecutive messages and depend on them being
+/// matched in send order, so the payload communicator must not promise `mpi_assert_allow_overtaking`.
+MPI_Comm mpi_detail::duplicate_with_hints(const MPI_Comm comm, const bool exact_length, const bool allow_overtaking) {
+	MPI_Comm dup = MPI_COMM_NULL;
 #if MPI_VERSION < 3
 	// MPI 2 only has Comm_dup - we assume that the user has not done any obscure things to MPI_COMM_WORLD
-	MPI_Comm_dup(mpi_comm, &m_mpi_comm);
+	(void)exact_length, (void)allow_overtaking;
+	MPI_Comm_dup(comm, &dup);
 #else
 	// MPI >= 3.0 provides MPI_Comm_dup_with_info, which allows us to reset all implementation hints on the communicator to our liking
 	MPI_Info info;
 	MPI_Info_create(&info);
 	// See the OpenMPI manpage for MPI_Comm_set_info for keys and values
-	MPI_Info_set(info, "mpi_assert_no_any_tag", "true");       // promise never to use MPI_ANY_TAG (we _do_ use MPI_ANY_SOURCE for pilots)
-	MPI_Info_set(info, "mpi_assert_exact_length", "true");     // promise to exactly match sizes between corresponding MPI_Send and MPI_Recv calls
-	MPI_Info_set(info, "mpi_assert_allow_overtaking", "true"); // we do not care about message ordering since we disambiguate by tag
-	MPI_Comm_dup_with_info(mpi_comm, info, &m_mpi_comm);
+	MPI_Info_set(info, "mpi_assert_no_any_tag", "true"); // promise never to use MPI_ANY_TAG (we _do_ use MPI_ANY_SOURCE for pilots)
+	if(exact_length) {
+		MPI_Info_set(info, "mpi_assert_exact_length", "true"); // promise to exactly match sizes between corresponding MPI_Send and MPI_Recv calls
+	}
+	if(allow_overtaking) {
+		MPI_Info_set(info, "mpi_assert_allow_overtaking", "true"); // we do not care about message ordering since we disambiguate by tag
+	}
+	MPI_Comm_dup_with_info(comm, info, &dup);
 	MPI_Info_free(&info);
 #endif
+	return dup;
+}
+
+mpi_communicator::mpi_communicator(const collective_clone_from_tag /* tag */, const MPI_Comm mpi_comm, const size_t max_cached_array_types)
+    : m_max_cached_array_types(max_cached_array_types) {
+	assert(mpi_comm != MPI_COMM_NULL);
+	assert(max_cached_array_types > 0);
+	// Both duplications are collective, so they happen in the same order on all ranks
+	m_mpi_comm = mpi_detail::duplicate_with_hints(mpi_comm, true /* exact_length */, false /* allow_overtaking */);
+	m_pilot_comm = mpi_detail::duplicate_with_hints(mpi_comm, false /* exact_length */, true /* allow_overtaking */);
 }
 
 mpi_communicator::~mpi_communicator() {
@@ -118,14 +239,22 @@ mpi_communicator::~mpi_communicator() {
 		MPI_Wait(&outbound.request, MPI_STATUS_IGNORE);
 	}
 
-	// We always re-start the pilot Irecv immediately, so we need to MPI_Cancel the last such request (and then free it using MPI_Wait).
-	if(m_inbound_pilot.request != MPI_REQUEST_NULL) {
-		MPI_Cancel(&m_inbound_pilot.request);
-		MPI_Wait(&m_inbound_pilot.request, MPI_STATUS_IGNORE);
+	// We always re-start pilot Irecvs immediately, so we need to MPI_Cancel the pre-posted requests (and then free them using MPI_Wait).
+	for(auto& inbound : m_inbound_pilots) {
+		MPI_Cancel(&inbound.request);
+		MPI_Wait(&inbound.request, MPI_STATUS_IGNORE);
 	}
 
+	// Free all retained persistent requests while the communicator is still alive
+	m_recurring_channels.clear();
+	m_recurring_channel_lru.clear();
+
+	const auto& metrics = m_array_type_metrics;
+	CELERITY_DEBUG("[mpi] datatype cache: {} hits, {} misses, {} evictions", metrics.hits, metrics.misses, metrics.evictions);
+
 	// MPI_Comm_free is itself a collective, but since this call happens from a destructor we implicitly guarantee that it cant' be re-ordered against any
 	// other collective operation on this communicator.
+	MPI_Comm_free(&m_pilot_comm);
 	MPI_Comm_free(&m_mpi_comm);
 }
 
@@ -142,62 +271,90 @@ node_id mpi_communicator::get_local_node_id() const {
 	return mpi_detail::mpi_rank_to_node_id(rank);
 }
 
-void mpi_communicator::send_outbound_pilot(const outbound_pilot& pilot) {
-	CELERITY_DEBUG("[mpi] pilot -> N{} (MSG{}, {}, {})", pilot.to, pilot.message.id, pilot.message.transfer_id, pilot.message.box);
+void mpi_communicator::send_outbound_pilot(const outbound_pilot& pilot) { send_outbound_pilots({pilot}); }
 
-	assert(pilot.to < get_num_nodes());
-	assert(pilot.to != get_local_node_id());
+void mpi_communicator::send_outbound_pilots(const std::vector<outbound_pilot>& pilots) {
+	// Group pilots by peer, keeping the order in which they were generated within each group
+	std::vector<const outbound_pilot*> by_peer;
+	by_peer.reserve(pilots.size());
+	for(const auto& pilot : pilots) {
+		by_peer.push_back(&pilot);
+	}
+	std::stable_sort(by_peer.begin(), by_peer.end(), [](const outbound_pilot* lhs, const outbound_pilot* rhs) { return lhs->to < rhs->to; });
+
+	for(auto it = by_peer.begin(); it != by_peer.end();) {
+		const auto to = (*it)->to;
+		assert(to < get_num_nodes());
+		assert(to != get_local_node_id());
+
+		in_flight_pilots newly_in_flight;
+		for(; it != by_peer.end() && (*it)->to == to && newly_in_flight.messages.size() < max_pilots_per_message; ++it) {
+			const auto& pilot = **it;
+			CELERITY_DEBUG("[mpi] pilot -> N{} (MSG{}, {}, {})", pilot.to, pilot.message.id, pilot.message.transfer_id, pilot.message.box);
+			newly_in_flight.messages.push_back(pilot.message);
+		}
 
-	// Initiate Isend as early as possible to hide latency.
-	in_flight_pilot newly_in_flight;
-	newly_in_flight.message = std::make_unique<pilot_message>(pilot.message);
-	MPI_Isend(newly_in_flight.message.get(), sizeof *newly_in_flight.message, MPI_BYTE, mpi_detail::node_id_to_mpi_rank(pilot.to),
-	    mpi_detail::pilot_exchange_tag, m_mpi_comm, &newly_in_flight.request);
+		// Initiate Isend as early as possible to hide latency.
+		const auto num_bytes = newly_in_flight.messages.size() * sizeof(pilot_message);
+		assert(num_bytes <= static_cast<size_t>(INT_MAX));
+		MPI_Isend(newly_in_flight.messages.data(), static_cast<int>(num_bytes), MPI_BYTE, mpi_detail::node_id_to_mpi_rank(to), mpi_detail::pilot_exchange_tag,
+		    m_pilot_comm, &newly_in_flight.request);
+
+		// Keep allocation until Isend has completed
+		m_outbound_pilots.push_back(std::move(newly_in_flight));
+	}
 
 	// Collect finished sends (TODO consider rate-limiting this to avoid quadratic behavior)
-	constexpr auto pilot_send_finished = [](in_flight_pilot& already_in_flight) {
+	constexpr auto pilot_send_finished = [](in_flight_pilots& already_in_flight) {
 		int flag = -1;
 		MPI_Test(&already_in_flight.request, &flag, MPI_STATUS_IGNORE);
 		return already_in_flight.request == MPI_REQUEST_NULL;
 	};
 	m_outbound_pilots.erase(std::remove_if(m_outbound_pilots.begin(), m_outbound_pilots.end(), pilot_send_finished), m_outbound_pilots.end());
-
-	// Keep allocation until Isend has completed
-	m_outbound_pilots.push_back(std::move(newly_in_flight));
 }
 
 std::vector<inbound_pilot> mpi_communicator::poll_inbound_pilots() {
-	// Irecv needs to be called initially, and after receiving each pilot to enqueue the next operation.
-	const auto begin_receiving_next_pilot = [this] {
-		assert(m_inbound_pilot.message != nullptr);
-		assert(m_inbound_pilot.request == MPI_REQUEST_NULL);
-		MPI_Irecv(m_inbound_pilot.message.get(), sizeof *m_inbound_pilot.message, MPI_BYTE, MPI_ANY_SOURCE, mpi_detail::pilot_exchange_tag, m_mpi_comm,
-		    &m_inbound_pilot.request);
+	// Irecv needs to be called initially, and after receiving each message to enqueue the next operation.
+	const auto begin_receiving_next_pilots = [this](in_flight_pilots& inbound) {
+		assert(inbound.messages.size() == max_pilots_per_message);
+		assert(inbound.request == MPI_REQUEST_NULL);
+		MPI_Irecv(inbound.messages.data(), static_cast<int>(max_pilots_per_message * sizeof(pilot_message)), MPI_BYTE, MPI_ANY_SOURCE,
+		    mpi_detail::pilot_exchange_tag, m_pilot_comm, &inbound.request);
 	};
 
-	if(m_inbound_pilot.request == MPI_REQUEST_NULL) {
+	if(m_inbound_pilots.empty()) {
 		// This is the first call to poll_inbound_pilots, spin up the pilot-receiving machinery - we don't do this unconditionally in the constructor
 		// because communicators for collective groups do not deal with pilots
-		m_inbound_pilot.message = std::make_unique<pilot_message>();
-		begin_receiving_next_pilot();
+		m_inbound_pilots.resize(num_pre_posted_pilot_receives);
+		for(auto& inbound : m_inbound_pilots) {
+			inbound.messages.resize(max_pilots_per_message);
+			begin_receiving_next_pilots(inbound);
+		}
 	}
 
-	// MPI might have received and buffered multiple inbound pilots, collect all of them in a loop
+	// MPI might have received and buffered multiple inbound messages for each pre-posted receive, collect all of them in a loop
 	std::vector<inbound_pilot> received_pilots;
-	for(;;) {
-		int flag = -1;
-		MPI_Status status;
-		MPI_Test(&m_inbound_pilot.request, &flag, &status);
-		if(flag == 0 /* incomplete */) {
-			return received_pilots; // no more pilots in queue, we're done collecting
+	for(auto& inbound : m_inbound_pilots) {
+		for(;;) {
+			int flag = -1;
+			MPI_Status status;
+			MPI_Test(&inbound.request, &flag, &status);
+			if(flag == 0 /* incomplete */) break;
+
+			int num_bytes = -1;
+			MPI_Get_count(&status, MPI_BYTE, &num_bytes);
+			assert(num_bytes > 0 && static_cast<size_t>(num_bytes) % sizeof(pilot_message) == 0);
+			const auto from = mpi_detail::mpi_rank_to_node_id(status.MPI_SOURCE);
+			const auto num_pilots = static_cast<size_t>(num_bytes) / sizeof(pilot_message);
+			for(size_t i = 0; i < num_pilots; ++i) {
+				const inbound_pilot pilot{from, inbound.messages[i]};
+				CELERITY_DEBUG("[mpi] pilot <- N{} (MSG{}, {} {})", pilot.from, pilot.message.id, pilot.message.transfer_id, pilot.message.box);
+				received_pilots.push_back(pilot);
+			}
+			begin_receiving_next_pilots(inbound); // the buffer has been copied out, re-post the receive asap
 		}
-
-		const inbound_pilot pilot{mpi_detail::mpi_rank_to_node_id(status.MPI_SOURCE), *m_inbound_pilot.message};
-		begin_receiving_next_pilot(); // initiate the next receive asap
-
-		CELERITY_DEBUG("[mpi] pilot <- N{} (MSG{}, {} {})", pilot.from, pilot.message.id, pilot.message.transfer_id, pilot.message.box);
-		received_pilots.push_back(pilot);
 	}
+	return received_pilots;
 }
 
 async_event mpi_communicator::send_payload(const node_id to, const message_id msgid, const void* const base, const stride& stride) {
@@ -206,6 +363,8 @@ async_event mpi_communicator::send_payload(const node_id to, const message_id ms
 	assert(to < get_num_nodes());
 	assert(to != get_local_node_id());
 
+	if(is_recurring_message_id(msgid)) { return start_recurring_transfer(true /* is_send */, to, msgid, base, stride); }
+
 	MPI_Request req = MPI_REQUEST_NULL;
 	const auto [adjusted_base, normalized_stride] = mpi_detail::normalize_strided_pointer(base, stride);
 	MPI_Isend(
@@ -219,6 +378,8 @@ async_event mpi_communicator::receive_payload(const node_id from, const message_
 	assert(from < get_num_nodes());
 	assert(from != get_local_node_id());
 
+	if(is_recurring_message_id(msgid)) { return start_recurring_transfer(false /* is_send */, from, msgid, base, stride); }
+
 	MPI_Request req = MPI_REQUEST_NULL;
 	const auto [adjusted_base, normalized_stride] = mpi_detail::normalize_strided_pointer(base, stride);
 	MPI_Irecv(
@@ -226,7 +387,46 @@ async_event mpi_communicator::receive_payload(const node_id from, const message_
 	return make_async_event<mpi_detail::mpi_event>(req);
 }
 
-std::unique_ptr<communicator> mpi_communicator::collective_clone() { return std::make_unique<mpi_communicator>(collective_clone_from, m_mpi_comm); }
+async_event mpi_communicator::start_recurring_transfer(
+    const bool is_send, const node_id peer, const message_id msgid, const void* const base, const stride& stride) {
+	const auto [adjusted_base, normalized_stride] = mpi_detail::normalize_strided_pointer(base, stride);
+
+	const recurring_channel_key key{is_send, peer, msgid};
+	if(const auto it = m_recurring_channels.find(key); it != m_recurring_channels.end()) {
+		m_recurring_channel_lru.splice(m_recurring_channel_lru.begin(), m_recurring_channel_lru, it->second);
+	} else {
+		m_recurring_channel_lru.emplace_front(key, recurring_channel{});
+		m_recurring_channels.emplace(key, m_recurring_channel_lru.begin());
+		// Evicting a channel with an incomplete operation would allow a later transfer on the same channel to overtake it, so we only evict idle ones.
+		// Operations that are still referenced by an async_event keep their persistent request alive.
+		if(m_recurring_channel_lru.size() > max_recurring_channels && m_recurring_channel_lru.back().second.last_operation->poll()) {
+			m_recurring_channels.erase(m_recurring_channel_lru.back().first);
+			m_recurring_channel_lru.pop_back();
+		}
+	}
+	auto& channel = m_recurring_channel_lru.front().second;
+
+	// All operations on a channel are serialized, so every bound request is inactive by the time the new operation starts
+	auto& bound = channel.bound_requests;
+	const auto bound_it = std::find_if(bound.begin(), bound.end(), [&](const auto& req) { return req->is_bound_to(adjusted_base, normalized_stride); });
+	if(bound_it != bound.end()) {
+		std::rotate(bound.begin(), bound_it, std::next(bound_it));
+		++m_persistent_request_metrics.num_restarted;
+	} else {
+		auto req = std::make_shared<mpi_detail::persistent_request>(is_send, adjusted_base, normalized_stride, get_array_type(normalized_stride),
+		    mpi_detail::node_id_to_mpi_rank(peer), mpi_detail::message_id_to_mpi_tag(msgid), m_mpi_comm);
+		if(bound.size() == max_bound_requests_per_channel) { bound.pop_back(); } // a pending operation still holds on to the request if needed
+		bound.insert(bound.begin(), std::move(req));
+		++m_persistent_request_metrics.num_created;
+	}
+
+	channel.last_operation = std::make_shared<mpi_detail::recurring_operation>(bound.front(), std::move(channel.last_operation));
+	return make_async_event<mpi_detail::recurring_event>(channel.last_operation);
+}
+
+std::unique_ptr<communicator> mpi_communicator::collective_clone() {
+	return std::make_unique<mpi_communicator>(collective_clone_from, m_mpi_comm, m_max_cached_array_types);
+}
 
 void mpi_communicator::collective_barrier() { MPI_Barrier(m_mpi_comm); }
 
@@ -243,15 +443,19 @@ MPI_Datatype mpi_communicator::get_scalar_type(const size_t bytes) {
 }
 
 MPI_Datatype mpi_communicator::get_array_type(const stride& stride) {
-	if(const auto it = m_array_type_cache.find(stride); it != m_array_type_cache.end()) { return it->second.get(); }
-
 	const int dims = detail::get_effective_dims(stride.allocation_range);
 	assert(detail::get_effective_dims(stride.transfer) <= dims);
 
 	// MPI (understandably) does not recognize a 0-dimensional subarray as a scalar
 	if(dims == 0) { return get_scalar_type(stride.element_size); }
 
-	// TODO - can we get runaway behavior from constructing too many MPI data types, especially with Spectrum MPI?
+	if(const auto it = m_array_type_cache.find(stride); it != m_array_type_cache.end()) {
+		++m_array_type_metrics.hits;
+		m_array_type_lru.splice(m_array_type_lru.begin(), m_array_type_lru, it->second);
+		return it->second->second.get();
+	}
+	++m_array_type_metrics.misses;
+
 	// TODO - eagerly create MPI types ahead-of-time whenever we send or receive a pilot to reduce latency?
 
 	int size_array[3];
@@ -271,10 +475,31 @@ MPI_Datatype mpi_communicator::get_array_type(const stride& stride) {
 	MPI_Type_create_subarray(dims, size_array, subsize_array, start_array, MPI_ORDER_C, get_scalar_type(stride.element_size), &type);
 	MPI_Type_commit(&type);
 
-	m_array_type_cache.emplace(stride, unique_datatype(type));
+	m_array_type_lru.emplace_front(stride, unique_datatype(type));
+	m_array_type_cache.emplace(stride, m_array_type_lru.begin());
+
+	if(m_array_type_lru.size() > m_max_cached_array_types) {
+		// Pending sends and receives keep using the evicted type, MPI_Type_free only marks it for deallocation
+		m_array_type_cache.erase(m_array_type_lru.back().first);
+		m_array_type_lru.pop_back();
+		++m_array_type_metrics.evictions;
+	}
 	return type;
 }
 
+mpi_communicator::datatype_cache_metrics mpi_communicator::get_datatype_cache_metrics() const {
+	auto metrics = m_array_type_metrics;
+	metrics.num_cached_types = m_array_type_cache.size();
+	return metrics;
+}
+
+size_t mpi_communicator::recurring_channel_key_hash::operator()(const recurring_channel_key& key) const {
+	size_t h = std::hash<bool>{}(key.is_send);
+	utils::hash_combine(h, std::hash<node_id>{}(key.peer));
+	utils::hash_combine(h, std::hash<message_id>{}(key.msgid));
+	return h;
+}
+
 void mpi_communicator::datatype_deleter::operator()(MPI_Datatype dtype) const { //
 	MPI_Type_free(&dtype);
 }
@@ -17,9 +17,13 @@ using target = out_of_order_engine::target;
 using lane_id = out_of_order_engine::lane_id;
 using assignment = out_of_order_engine::assignment;
 
-/// Comparison operator to make priority_queue<instruction*> return concurrent instructions in decreasing priority.
+/// Comparison operator to make priority_queue<instruction*> return concurrent instructions in decreasing priority. Among instructions of equal priority, the
+/// one with the longest estimated duration comes first, so that short instructions can fill the gaps it leaves on other queues.
 struct instruction_priority_less {
-	bool operator()(const instruction* lhs, const instruction* rhs) const { return lhs->get_priority() < rhs->get_priority(); }
+	bool operator()(const instruction* lhs, const instruction* rhs) const {
+		if(lhs->get_priority() != rhs->get_priority()) return lhs->get_priority() < rhs->get_priority();
+		return lhs->get_estimated_duration() < rhs->get_estimated_duration();
+	}
 };
 
 /// Instruction is not eligible for assignment yet. Implies `num_incomplete_predecessors > 0`.
@@ -93,7 +97,8 @@ struct engine_impl {
 	/// is assumed to have completed earlier (triggering its removal from the map).
 	std::unordered_map<instruction_id, incomplete_instruction_state> incomplete_instructions;
 
-	/// Queue of all instructions in `conditional_eagerly_assignable_state` and `unconditional_assignable_state`, in decreasing order of instruction priority.
+	/// Queue of all instructions in `conditional_eagerly_assignable_state` and `unconditional_assignable_state`, in decreasing order of instruction priority
+	/// and estimated duration.
 	std::priority_queue<const instruction*, std::vector<const instruction*>, instruction_priority_less> assignment_queue;
 
 	explicit engine_impl(const system_info& system);
@@ -272,6 +277,11 @@ void engine_impl::submit(const instruction* const instr) {
 	    [&](const host_task_instruction& htinstr) { //
 		    node.target = target::host_queue;
 	    },
+	    [&]([[maybe_unused]] const linearize_instruction& linstr) {
+		    // Sends always read from host memory, so linearization is a host-side copy
+		    assert(linstr.get_source_allocation_id().get_memory_id() == host_memory_id);
+		    node.target = target::host_queue;
+	    },
 	    [&](const clone_collective_group_instruction& /* other */) { node.target = target::immediate; },
 	    [&](const send_instruction& /* other */) { node.target = target::immediate; },
 	    [&](const receive_instruction& /* other */) { node.target = target::immediate; },
@@ -16,5 +16,34 @@ namespace detail {
 		return CPU_COUNT(&available_cores);
 	}
 
+	std::vector<uint32_t> affinity_core_ids() {
+		cpu_set_t available_cores;
+		[[maybe_unused]] const auto ret = pthread_getaffinity_np(pthread_self(), sizeof(cpu_set_t), &available_cores);
+		assert(ret == 0 && "Error retrieving affinity mask.");
+		std::vector<uint32_t> core_ids;
+		for(uint32_t core = 0; core < CPU_SETSIZE; ++core) {
+			if(CPU_ISSET(core, &available_cores)) { core_ids.push_back(core); }
+		}
+		return core_ids;
+	}
+
+	bool set_thread_affinity(const std::thread::native_handle_type thread_handle, const uint32_t core_id) {
+		if(core_id >= CPU_SETSIZE) return false;
+		cpu_set_t cores;
+		CPU_ZERO(&cores);
+		CPU_SET(core_id, &cores);
+		return pthread_setaffinity_np(thread_handle, sizeof(cpu_set_t), &cores) == 0;
+	}
+
+	bool set_thread_affinity(const std::thread::native_handle_type thread_handle, const std::vector<uint32_t>& core_ids) {
+		cpu_set_t cores;
+		CPU_ZERO(&cores);
+		for(const auto core_id : core_ids) {
+			if(core_id >= CPU_SETSIZE) return false;
+			CPU_SET(core_id, &cores);
+		}
+		return pthread_setaffinity_np(thread_handle, sizeof(cpu_set_t), &cores) == 0;
+	}
+
 } // namespace detail
 } // namespace celerity
@@ -18,5 +18,37 @@ namespace detail {
 		return utils::popcount(available_cores);
 	}
 
+	std::vector<uint32_t> affinity_core_ids() {
+		using native_cpu_set = DWORD_PTR;
+
+		native_cpu_set available_cores;
+		[[maybe_unused]] native_cpu_set sys_affinity_mask;
+		[[maybe_unused]] const auto ret = GetProcessAffinityMask(GetCurrentProcess(), &available_cores, &sys_affinity_mask);
+		assert(ret != FALSE && "Error retrieving affinity mask.");
+		std::vector<uint32_t> core_ids;
+		for(uint32_t core = 0; core < sizeof(native_cpu_set) * 8; ++core) {
+			if((available_cores >> core) & 1) { core_ids.push_back(core); }
+		}
+		return core_ids;
+	}
+
+	bool set_thread_affinity(const std::thread::native_handle_type thread_handle, const uint32_t core_id) {
+		using native_cpu_set = DWORD_PTR;
+
+		if(core_id >= sizeof(native_cpu_set) * 8) return false;
+		return SetThreadAffinityMask(thread_handle, native_cpu_set{1} << core_id) != 0;
+	}
+
+	bool set_thread_affinity(const std::thread::native_handle_type thread_handle, const std::vector<uint32_t>& core_ids) {
+		using native_cpu_set = DWORD_PTR;
+
+		native_cpu_set cores = 0;
+		for(const auto core_id : core_ids) {
+			if(core_id >= sizeof(native_cpu_set) * 8) return false;
+			cores |= native_cpu_set{1} << core_id;
+		}
+		return SetThreadAffinityMask(thread_handle, cores) != 0;
+	}
+
 } // namespace detail
 } // namespace celerity
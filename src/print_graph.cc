@@ -11,6 +11,8 @@
 #include "task.h"
 #include "task_manager.h"
 
+#include <cassert>
+#include <chrono>
 #include <map>
 #include <set>
 #include <unordered_map>
@@ -43,6 +45,15 @@ const char* task_type_string(const task_type tt) {
 	}
 }
 
+const char* horizon_step_adjustment_string(const horizon_step_adjustment adj) {
+	switch(adj) {
+	case horizon_step_adjustment::keep: return "keep";
+	case horizon_step_adjustment::grow: return "grow";
+	case horizon_step_adjustment::shrink: return "shrink";
+	default: return "unknown";
+	}
+}
+
 void format_requirements(std::string& label, const reduction_list& reductions, const access_list& accesses, const side_effect_map& side_effects,
     const access_mode reduction_init_mode) {
 	for(const auto& [rid, bid, buffer_name, init_from_buffer] : reductions) {
@@ -74,6 +85,11 @@ std::string get_task_label(const task_record& tsk) {
 	} else if(tsk.type == task_type::collective) {
 		fmt::format_to(std::back_inserter(label), " in CG{}", tsk.cgid);
 	}
+	if(tsk.horizon_decision.has_value()) {
+		const auto& d = *tsk.horizon_decision;
+		fmt::format_to(std::back_inserter(label), "<br/>step {} &rarr; {} <i>({}, {} in flight, {} tasks, {} region map entries)</i>", d.previous_step,
+		    d.step, horizon_step_adjustment_string(d.adjustment), d.feedback.horizons_in_flight, d.feedback.live_tasks, d.feedback.region_map_entries);
+	}
 
 	format_requirements(label, tsk.reductions, tsk.accesses, tsk.side_effect_map, access_mode::read_write);
 
@@ -250,6 +266,7 @@ std::string instruction_dependency_style(const instruction_dependency_origin ori
 	case instruction_dependency_origin::last_epoch: return "color=orchid";
 	case instruction_dependency_origin::execution_front: return "color=orange";
 	case instruction_dependency_origin::split_receive: return "color=gray";
+	case instruction_dependency_origin::recurring_send: return "color=deeppink2";
 	default: abort();
 	}
 }
@@ -258,11 +275,21 @@ std::string print_instruction_graph(const instruction_recorder& irec, const comm
 	std::string dot = make_graph_preamble(title);
 	const auto back = std::back_inserter(dot);
 
+	const instruction_record* open_node = nullptr;
 	const auto begin_node = [&](const instruction_record& instr, const std::string_view& shape, const std::string_view& color) {
 		fmt::format_to(back, "I{}[color={},shape={},label=<", instr.id, color, shape);
+		open_node = &instr;
 	};
 
-	const auto end_node = [&] { fmt::format_to(back, ">];"); };
+	const auto end_node = [&] {
+		assert(open_node != nullptr);
+		// cost models may estimate zero for instructions that take negligible time, which we do not clutter the label with
+		if(open_node->estimated_duration.count() > 0) {
+			fmt::format_to(back, "<br/><i>est. {:.1f} us</i>", std::chrono::duration<double, std::micro>(open_node->estimated_duration).count());
+		}
+		fmt::format_to(back, ">];");
+		open_node = nullptr;
+	};
 
 	const auto print_instruction_graph_garbage = [&](const instruction_garbage& garbage) {
 		for(const auto rid : garbage.reductions) {
@@ -289,6 +316,7 @@ std::string print_instruction_graph(const instruction_recorder& irec, const comm
 			    switch(ainstr.origin) {
 			    case alloc_instruction_record::alloc_origin::buffer: dot += "buffer "; break;
 			    case alloc_instruction_record::alloc_origin::gather: dot += "gather "; break;
+			    case alloc_instruction_record::alloc_origin::staging: dot += "staging "; break;
 			    }
 			    fmt::format_to(back, "<b>alloc</b> {}", ainstr.allocation_id);
 			    if(ainstr.buffer_allocation.has_value()) {
@@ -318,6 +346,7 @@ std::string print_instruction_graph(const instruction_recorder& irec, const comm
 			    case copy_instruction_record::copy_origin::coherence: dot += "coherence "; break;
 			    case copy_instruction_record::copy_origin::gather: dot += "gather "; break;
 			    case copy_instruction_record::copy_origin::fence: dot += "fence "; break;
+			    case copy_instruction_record::copy_origin::staging: dot += "staging "; break;
 			    }
 			    fmt::format_to(back, "<b>copy</b><br/>from {} ({})<br/>to {} ({})<br/>{} {} x{} bytes", cinstr.source_allocation, cinstr.source_box,
 			        cinstr.dest_allocation, cinstr.dest_box, print_buffer_label(cinstr.buffer_id, cinstr.buffer_name), cinstr.copy_region, cinstr.element_size);
@@ -367,6 +396,16 @@ std::string print_instruction_graph(const instruction_recorder& irec, const comm
 			    }
 			    end_node();
 		    },
+		    [&](const linearize_instruction_record& linstr) {
+			    begin_node(linstr, "ellipse", "green3");
+			    fmt::format_to(back, "I{}<br/><b>linearize</b> {}", linstr.id, linstr.transfer_id);
+			    fmt::format_to(back, "<br/>{} {}", print_buffer_label(linstr.transfer_id.bid, linstr.buffer_name),
+			        box(subrange(linstr.offset_in_buffer, linstr.linearize_range)));
+			    fmt::format_to(back, "<br/>from {} {}", linstr.source_allocation_id, box(subrange(linstr.offset_in_source_allocation, linstr.linearize_range)));
+			    fmt::format_to(back, "<br/>to {}", linstr.staging_allocation_id);
+			    fmt::format_to(back, "<br/>{}x{} bytes", linstr.linearize_range, linstr.element_size);
+			    end_node();
+		    },
 		    [&](const send_instruction_record& sinstr) {
 			    begin_node(sinstr, "box,margin=0.2,style=rounded", "deeppink2");
 			    fmt::format_to(back, "I{} (push C{})", sinstr.id, sinstr.push_cid);
@@ -50,6 +50,17 @@ class gather_receive_event final : public async_event_impl {
 	weak_gather_request m_request;
 };
 
+/// Event for a payload-receive that was deferred by `receive_arbiter::begin_payload_receive`. Remains incomplete until the receive is issued to the communicator.
+class deferred_receive_event final : public async_event_impl {
+  public:
+	explicit deferred_receive_event(std::shared_ptr<const deferred_receive> receive) : m_receive(std::move(receive)) {}
+
+	bool is_complete() const override { return m_receive->communication.has_value() && m_receive->communication->is_complete(); }
+
+  private:
+	std::shared_ptr<const deferred_receive> m_receive;
+};
+
 bool region_request::do_complete() {
 	const auto complete_fragment = [&](const incoming_region_fragment& fragment) {
 		if(!fragment.communication.is_complete()) return false;
@@ -226,6 +237,45 @@ void receive_arbiter::poll_communicator() {
 	}
 }
 
+void receive_arbiter::notify_epoch_reached() {
+	++m_num_reached_epochs;
+	for(auto it = m_recurring_receive_channels.begin(); it != m_recurring_receive_channels.end();) {
+		const auto& channel = it->second;
+		if(channel.deferred_receives.empty() && m_num_reached_epochs - channel.last_active_epoch > recurring_channel_retention_epochs) {
+			it = m_recurring_receive_channels.erase(it);
+		} else {
+			++it;
+		}
+	}
+}
+
+async_event receive_arbiter::begin_payload_receive(const inbound_pilot& pilot, void* const base, const communicator::stride& stride) {
+	if(!is_recurring_message_id(pilot.message.id)) { return m_comm->receive_payload(pilot.from, pilot.message.id, base, stride); }
+
+	auto& channel = m_recurring_receive_channels[{pilot.from, pilot.message.id}];
+	assert(pilot.message.sequence >= channel.next_sequence);
+	channel.last_active_epoch = m_num_reached_epochs;
+	if(pilot.message.sequence != channel.next_sequence) {
+		// An earlier send on this channel has not been matched with its receive instruction yet
+		const auto [it, inserted] = channel.deferred_receives.emplace(
+		    pilot.message.sequence, std::make_shared<deferred_receive>(deferred_receive{pilot.from, pilot.message.id, base, stride, std::nullopt}));
+		assert(inserted);
+		return make_async_event<deferred_receive_event>(it->second);
+	}
+
+	auto event = m_comm->receive_payload(pilot.from, pilot.message.id, base, stride);
+	++channel.next_sequence;
+
+	// Issuing this receive may have unblocked receives that were matched out of order before
+	while(!channel.deferred_receives.empty() && channel.deferred_receives.begin()->first == channel.next_sequence) {
+		auto& receive = *channel.deferred_receives.begin()->second;
+		receive.communication = m_comm->receive_payload(receive.from, receive.msgid, receive.base, receive.stride);
+		channel.deferred_receives.erase(channel.deferred_receives.begin());
+		++channel.next_sequence;
+	}
+	return event;
+}
+
 void receive_arbiter::handle_region_request_pilot(region_request& rr, const inbound_pilot& pilot, const size_t elem_size) {
 	assert(region_intersection(rr.incomplete_region, pilot.message.box) == pilot.message.box);
 	assert(rr.allocated_box.covers(pilot.message.box));
@@ -237,7 +287,7 @@ void receive_arbiter::handle_region_request_pilot(region_request& rr, const inbo
 	    subrange<3>{offset_in_allocation, pilot.message.box.get_range()},
 	    elem_size,
 	};
-	auto event = m_comm->receive_payload(pilot.from, pilot.message.id, rr.allocation, stride);
+	auto event = begin_payload_receive(pilot, rr.allocation, stride);
 	rr.incoming_fragments.push_back({pilot.message.box, std::move(event)});
 }
 
@@ -249,7 +299,7 @@ void receive_arbiter::handle_gather_request_pilot(gather_request& gr, const inbo
 	} else {
 		// Initiate a region-receive with a simple stride to address the chunk id in the allocation
 		const communicator::stride stride{range_cast<3>(range(m_num_nodes)), subrange(id_cast<3>(id(pilot.from)), range_cast<3>(range(1))), gr.chunk_size};
-		auto event = m_comm->receive_payload(pilot.from, pilot.message.id, gr.allocation, stride);
+		auto event = begin_payload_receive(pilot, gr.allocation, stride);
 		gr.incoming_chunks.push_back(incoming_gather_chunk{std::move(event)});
 	}
 }
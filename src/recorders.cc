@@ -143,7 +143,8 @@ command_record::command_record(const abstract_command& cmd, const task& tsk, con
 
 // Instructions
 
-instruction_record::instruction_record(const instruction& instr) : id(instr.get_id()), priority(instr.get_priority()) {}
+instruction_record::instruction_record(const instruction& instr)
+    : id(instr.get_id()), priority(instr.get_priority()), estimated_duration(instr.get_estimated_duration()) {}
 
 clone_collective_group_instruction_record::clone_collective_group_instruction_record(const clone_collective_group_instruction& ccginstr)
     : acceptor_base(ccginstr), original_collective_group_id(ccginstr.get_original_collective_group_id()),
@@ -152,7 +153,7 @@ clone_collective_group_instruction_record::clone_collective_group_instruction_re
 alloc_instruction_record::alloc_instruction_record(
     const alloc_instruction& ainstr, const alloc_origin origin, std::optional<buffer_allocation_record> buffer_allocation, std::optional<size_t> num_chunks)
     : acceptor_base(ainstr), allocation_id(ainstr.get_allocation_id()), size_bytes(ainstr.get_size_bytes()), alignment_bytes(ainstr.get_alignment_bytes()),
-      origin(origin), buffer_allocation(std::move(buffer_allocation)), num_chunks(num_chunks) {}
+      origin(origin), is_staging(ainstr.is_staging()), buffer_allocation(std::move(buffer_allocation)), num_chunks(num_chunks) {}
 
 free_instruction_record::free_instruction_record(const free_instruction& finstr, const size_t size, std::optional<buffer_allocation_record> buffer_allocation)
     : acceptor_base(finstr), allocation_id(finstr.get_allocation_id()), size(size), buffer_allocation(std::move(buffer_allocation)) {}
@@ -194,6 +195,13 @@ host_task_instruction_record::host_task_instruction_record(const host_task_instr
 	}
 }
 
+linearize_instruction_record::linearize_instruction_record(
+    const linearize_instruction& linstr, const detail::transfer_id& trid, std::string buffer_name, const celerity::id<3>& offset_in_buffer)
+    : acceptor_base(linstr), source_allocation_id(linstr.get_source_allocation_id()), source_allocation_range(linstr.get_source_allocation_range()),
+      offset_in_source_allocation(linstr.get_offset_in_source_allocation()), linearize_range(linstr.get_linearize_range()),
+      element_size(linstr.get_element_size()), staging_allocation_id(linstr.get_staging_allocation_id()), transfer_id(trid),
+      buffer_name(std::move(buffer_name)), offset_in_buffer(offset_in_buffer) {}
+
 send_instruction_record::send_instruction_record(const send_instruction& sinstr, const command_id push_cid, const detail::transfer_id& trid,
     std::string buffer_name, const celerity::id<3>& offset_in_buffer)
     : acceptor_base(sinstr), dest_node_id(sinstr.get_dest_node_id()), message_id(sinstr.get_message_id()),
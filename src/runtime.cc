@@ -1,5 +1,6 @@
 #include "runtime.h"
 
+#include <cstring>
 #include <queue>
 #include <string>
 #include <unordered_map>
@@ -22,14 +23,20 @@
 #include "buffer_manager.h"
 #include "cgf_diagnostics.h"
 #include "command_graph.h"
+#include "cost_model.h"
 #include "distributed_graph_generator.h"
 #include "executor.h"
 #include "host_object.h"
+#include "instruction_graph.h"
+#include "instruction_graph_generator.h"
+#include "live_executor.h"
 #include "log.h"
+#include "mpi_communicator.h"
 #include "mpi_support.h"
 #include "named_threads.h"
 #include "print_graph.h"
 #include "scheduler.h"
+#include "system_info.h"
 #include "task_manager.h"
 #include "user_bench.h"
 #include "utils.h"
@@ -139,7 +146,8 @@ namespace detail {
 
 		cgf_diagnostics::make_available();
 
-		m_h_queue = std::make_unique<host_queue>();
+		const auto host_cfg = m_cfg->get_host_config();
+		m_h_queue = std::make_unique<host_queue>(host_cfg.node_count, host_cfg.local_rank);
 		m_d_queue = std::make_unique<device_queue>();
 
 		// Initialize worker classes (but don't start them up yet)
@@ -159,8 +167,14 @@ namespace detail {
 		m_task_mngr = std::make_unique<task_manager>(m_num_nodes, m_h_queue.get(), m_task_recorder.get(), task_mngr_policy);
 		if(m_cfg->get_horizon_step()) m_task_mngr->set_horizon_step(m_cfg->get_horizon_step().value());
 		if(m_cfg->get_horizon_max_parallelism()) m_task_mngr->set_horizon_max_parallelism(m_cfg->get_horizon_max_parallelism().value());
+		if(m_cfg->should_use_adaptive_horizons()) m_task_mngr->enable_adaptive_horizons();
+		if(m_cfg->get_task_window_memory_limit()) m_task_mngr->set_task_window_memory_limit(m_cfg->get_task_window_memory_limit().value());
 
-		m_exec = std::make_unique<executor>(m_num_nodes, m_local_nid, *m_h_queue, *m_d_queue, *m_task_mngr, *m_buffer_mngr, *m_reduction_mngr);
+		// Dry runs never execute instructions, so they always use the (mostly idle) legacy executor
+		const bool use_live_executor = m_cfg->should_use_live_executor() && !is_dry_run();
+		if(!use_live_executor) {
+			m_exec = std::make_unique<executor>(m_num_nodes, m_local_nid, *m_h_queue, *m_d_queue, *m_task_mngr, *m_buffer_mngr, *m_reduction_mngr);
+		}
 
 		m_cdag = std::make_unique<command_graph>();
 		if(m_cfg->should_record()) m_command_recorder = std::make_unique<command_recorder>();
@@ -171,19 +185,71 @@ namespace detail {
 		dggen_policy.overlapping_write_error = CELERITY_ACCESS_PATTERN_DIAGNOSTICS ? error_policy::log_error : error_policy::ignore;
 
 		auto dggen = std::make_unique<distributed_graph_generator>(m_num_nodes, m_local_nid, *m_cdag, *m_task_mngr, m_command_recorder.get(), dggen_policy);
+		if(m_cfg->get_graph_generation_threads().value_or(0) > 0) dggen->enable_parallel_generation(*m_cfg->get_graph_generation_threads());
 
-		m_schdlr = std::make_unique<scheduler>(is_dry_run(), std::move(dggen), *m_exec);
-		m_task_mngr->register_task_callback([this](const task* tsk) { m_schdlr->notify_task_created(tsk); });
+		if(!use_live_executor) { m_schdlr = std::make_unique<scheduler>(is_dry_run(), std::move(dggen), *m_exec); }
 
 		CELERITY_INFO("Celerity runtime version {} running on {}. PID = {}, build type = {}, {}", get_version_string(), get_sycl_version(), get_pid(),
 		    get_build_type(), get_mimalloc_string());
 		m_d_queue->init(*m_cfg, user_device_or_selector);
+
+		if(use_live_executor) {
+			// The device selected by device_queue always comes first, followed by any further devices this rank can use exclusively
+			auto sycl_devices = std::visit(
+			    [&](const auto& value) { return pick_devices(*m_cfg, value, m_d_queue->get_sycl_queue().get_device()); }, user_device_or_selector);
+
+			system_info system;
+			system.devices.resize(sycl_devices.size());
+			system.memories.resize(first_device_memory_id + sycl_devices.size());
+			for(device_id did = 0; did < sycl_devices.size(); ++did) {
+				const memory_id native_memory = first_device_memory_id + did;
+				system.devices[did].native_memory = native_memory;
+				// Once device memory is full, the instruction graph generator spills and frees the least-recently used buffer allocations
+				system.memories[native_memory].capacity = sycl_devices[did].get_info<sycl::info::device::global_mem_size>();
+			}
+			// Every device has its own SYCL context, so device-to-device copies are staged through host memory
+			for(memory_id mid = 0; mid < system.memories.size(); ++mid) {
+				system.memories[mid].copy_peers.set(mid);
+				system.memories[mid].copy_peers.set(host_memory_id);
+				system.memories[host_memory_id].copy_peers.set(mid);
+			}
+
+			auto root_comm = std::make_unique<mpi_communicator>(collective_clone_from, MPI_COMM_WORLD);
+			m_cost_model = std::make_unique<calibrated_cost_model>();
+			m_live_exec = std::make_unique<live_executor>(system, std::move(sycl_devices), std::move(root_comm), *m_reduction_mngr, this, m_cost_model.get(),
+			    m_h_queue->get_core_assignment().worker_cores);
+
+			instruction_graph_generator::policy_set iggen_policy;
+			// Errors in the user's access pattern have already been reported on task and command generation.
+			iggen_policy.uninitialized_read_error = error_policy::ignore;
+			iggen_policy.overlapping_write_error = error_policy::ignore;
+			iggen_policy.unsafe_oversubscription_error = error_policy::log_warning;
+
+			m_idag = std::make_unique<instruction_graph>();
+			auto iggen = std::make_unique<instruction_graph_generator>(
+			    *m_task_mngr, m_num_nodes, m_local_nid, system, *m_idag, m_live_exec.get(), nullptr /* recorder */, iggen_policy,
+			    m_cost_model.get());
+			m_schdlr = std::make_unique<scheduler>(false /* is_dry_run */, std::move(dggen), *m_idag, std::move(iggen));
+		}
+
+		if(const auto lookahead = m_cfg->get_scheduler_lookahead(); lookahead.has_value() && *lookahead > 0) {
+			if(use_live_executor) {
+				m_schdlr->set_lookahead(static_cast<size_t>(*lookahead));
+			} else {
+				CELERITY_WARN("CELERITY_SCHEDULER_LOOKAHEAD has no effect without CELERITY_LIVE_EXECUTOR and is ignored.");
+			}
+		}
+		m_task_mngr->register_task_callback([this](const task* tsk) { m_schdlr->notify_task_created(tsk); });
 	}
 
 	runtime::~runtime() {
 		m_schdlr.reset();
 		m_cdag.reset();
 		m_exec.reset();
+		m_live_exec.reset();
+		m_cost_model.reset();
+		m_idag.reset();
+		m_host_init_allocations.clear();
 		m_task_mngr.reset();
 		m_reduction_mngr.reset();
 		m_host_object_mngr.reset();
@@ -206,7 +272,21 @@ namespace detail {
 		if(m_is_active) { throw runtime_already_started_error(); }
 		m_is_active = true;
 		m_schdlr->startup();
-		m_exec->startup();
+		if(m_exec != nullptr) { m_exec->startup(); }
+		if(m_live_exec != nullptr) { m_live_exec->startup(); }
+
+#ifndef __APPLE__
+		// Keep the scheduler and executor threads off the cores that host task workers are pinned to. They share the runtime cores instead of getting one
+		// each, since the executor also drives backend work. The application's main thread and everything it spawns keep their affinity.
+		if(const auto& runtime_cores = m_h_queue->get_core_assignment().runtime_cores; !runtime_cores.empty()) {
+			const auto exec_thread = m_exec != nullptr ? m_exec->get_thread_handle() : m_live_exec->get_thread_handle();
+			const std::pair<std::thread::native_handle_type, const char*> runtime_threads[] = {
+			    {m_schdlr->get_thread_handle(), "scheduler"}, {exec_thread, "executor"}};
+			for(const auto& [handle, name] : runtime_threads) {
+				if(!set_thread_affinity(handle, runtime_cores)) { CELERITY_WARN("Failed to pin {} thread to its {} runtime cores", name, runtime_cores.size()); }
+			}
+		}
+#endif
 	}
 
 	void runtime::shutdown() {
@@ -219,7 +299,8 @@ namespace detail {
 
 		m_task_mngr->await_epoch(shutdown_epoch);
 
-		m_exec->shutdown();
+		if(m_exec != nullptr) { m_exec->shutdown(); }
+		if(m_live_exec != nullptr) { m_live_exec->shutdown(); }
 		m_d_queue->wait();
 		m_h_queue->wait();
 
@@ -285,9 +366,41 @@ namespace detail {
 		return combine_command_graphs(graphs);
 	}
 
-	void runtime::register_buffer(buffer_id bid, const range<3>& range, bool host_initialized) {
-		m_task_mngr->notify_buffer_created(bid, range, host_initialized);
-		m_schdlr->notify_buffer_created(bid, range, host_initialized);
+	void runtime::register_buffer(
+	    const buffer_id bid, const range<3>& range, const size_t elem_size, const size_t elem_align, const void* const host_init_ptr) {
+		m_task_mngr->notify_buffer_created(bid, range, host_init_ptr != nullptr);
+		if(m_live_exec == nullptr) {
+			m_schdlr->notify_buffer_created(bid, range, host_init_ptr != nullptr);
+			return;
+		}
+
+		auto user_aid = null_allocation_id;
+		if(host_init_ptr != nullptr) {
+			// Buffers take a copy of their host-initialization data on construction, so the user is free to modify or release it afterwards
+			const auto size_bytes = range.size() * elem_size;
+			std::unique_ptr<void, aligned_deleter> copy(::operator new(size_bytes, std::align_val_t(elem_align)), aligned_deleter{elem_align});
+			std::memcpy(copy.get(), host_init_ptr, size_bytes);
+			user_aid = create_user_allocation(copy.get());
+			m_host_init_allocations.emplace(bid, std::move(copy));
+		}
+		m_schdlr->notify_buffer_created(bid, range, elem_size, elem_align, user_aid);
+	}
+
+	allocation_id runtime::create_user_allocation(void* const ptr) {
+		assert(m_live_exec != nullptr);
+		const allocation_id aid(user_memory_id, raw_allocation_id(m_next_user_allocation_id++));
+		m_live_exec->announce_user_allocation(aid, ptr);
+		return aid;
+	}
+
+	void runtime::horizon_reached(const task_id tid) {
+		m_task_mngr->notify_horizon_reached(tid);
+		m_schdlr->notify_horizon_reached(tid);
+	}
+
+	void runtime::epoch_reached(const task_id tid) {
+		m_task_mngr->notify_epoch_reached(tid);
+		m_schdlr->notify_epoch_reached(tid);
 	}
 
 	void runtime::set_buffer_debug_name(const buffer_id bid, const std::string& debug_name) {
@@ -300,6 +413,8 @@ namespace detail {
 		m_schdlr->notify_buffer_destroyed(bid);
 		m_task_mngr->notify_buffer_destroyed(bid);
 		m_buffer_mngr->unregister_buffer(bid);
+		// All tasks reading the host-initialization data have completed, since they kept the buffer alive
+		m_host_init_allocations.erase(bid);
 		maybe_destroy_runtime();
 	}
 
@@ -4,7 +4,10 @@
 #include "executor.h"
 #include "frame.h"
 #include "graph_serializer.h"
+#include "instruction_graph.h"
+#include "instruction_graph_generator.h"
 #include "named_threads.h"
+#include "task.h"
 
 #include <matchbox.hh>
 
@@ -16,10 +19,26 @@ namespace detail {
 		assert(m_dggen != nullptr);
 	}
 
+	abstract_scheduler::abstract_scheduler(
+	    const bool is_dry_run, std::unique_ptr<distributed_graph_generator> dggen, instruction_graph& idag, std::unique_ptr<instruction_graph_generator> iggen)
+	    : m_is_dry_run(is_dry_run), m_dggen(std::move(dggen)), m_exec(nullptr), m_idag(&idag), m_iggen(std::move(iggen)) {
+		assert(m_dggen != nullptr);
+		assert(m_iggen != nullptr);
+		assert(!m_is_dry_run && "dry runs do not compile instructions");
+	}
+
+	abstract_scheduler::abstract_scheduler(const bool is_dry_run, std::unique_ptr<distributed_graph_generator> dggen)
+	    : m_is_dry_run(is_dry_run), m_dggen(std::move(dggen)), m_exec(nullptr) {}
+
+	abstract_scheduler::~abstract_scheduler() = default;
+
 	void abstract_scheduler::shutdown() { notify(event_shutdown{}); }
 
 	void abstract_scheduler::schedule() {
-		graph_serializer serializer([this](command_pkg&& pkg) {
+		// Commands generated from all events that were pending at the same time are forwarded to the executor as a single batch, so that locking and
+		// wakeup costs in the executor scale with the number of batches rather than the number of commands.
+		std::vector<command_pkg> batch;
+		graph_serializer serializer([this, &batch](command_pkg&& pkg) {
 			if(m_is_dry_run && pkg.get_command_type() != command_type::epoch && pkg.get_command_type() != command_type::horizon
 			    && pkg.get_command_type() != command_type::fence) {
 				// in dry runs, skip everything except epochs, horizons and fences
@@ -29,67 +48,126 @@ namespace detail {
 				CELERITY_WARN("Encountered a \"fence\" command while \"CELERITY_DRY_RUN_NODES\" is set. "
 				              "The result of this operation will not match the expected output of an actual run.");
 			}
-			// Executor may not be set during tests / benchmarks
-			if(m_exec != nullptr) { m_exec->enqueue(std::move(pkg)); }
+			batch.push_back(std::move(pkg));
 		});
 
-		std::queue<event> in_flight_events;
-		bool shutdown = false;
-		while(!shutdown) {
-			{
-				std::unique_lock lk(m_events_mutex);
-				m_events_cv.wait(lk, [this] { return !m_available_events.empty(); });
-				std::swap(m_available_events, in_flight_events);
+		// Commands of up to m_lookahead tasks are held back before serialization. The window is always flushed on horizons, epochs and fences, so that
+		// commands are never pruned from the CDAG while they are still in the window and synchronization points are not delayed. Only the instruction graph
+		// generator can take advantage of the window, so without one, commands are passed on immediately.
+		const size_t lookahead = m_iggen != nullptr ? m_lookahead : 0;
+		std::vector<command_set> lookahead_window;
+		const auto flush_lookahead_window = [&] {
+			for(const auto& cmds : lookahead_window) {
+				if(m_iggen != nullptr) {
+					for(const auto cmd : sort_topologically(cmds)) {
+						m_iggen->compile(*cmd);
+					}
+				} else {
+					serializer.flush(cmds);
+				}
+			}
+			lookahead_window.clear();
+		};
+
+		// Instructions are owned by the IDAG until the executor has reached the horizon that follows them. Their generator may still refer to instructions
+		// between the previous and the most recent horizon, so we only prune up to the horizon reached before the most recent one.
+		std::optional<task_id> last_horizon_reached;
+		task_id last_epoch_reached = 0;
+		const auto apply_executor_progress = [&] {
+			// Several horizons reached in quick succession are only observed as the latest one, which merely delays pruning
+			if(const task_id epoch = m_latest_epoch_reached.load(std::memory_order_acquire); epoch > last_epoch_reached) {
+				assert(m_idag != nullptr);
+				m_idag->prune_before_epoch(epoch);
+				last_horizon_reached = epoch;
+				last_epoch_reached = epoch;
 			}
+			if(const task_id horizon = m_latest_horizon_reached.load(std::memory_order_acquire);
+			    horizon > 0 && (!last_horizon_reached.has_value() || horizon > *last_horizon_reached)) {
+				assert(m_idag != nullptr);
+				if(last_horizon_reached.has_value()) { m_idag->prune_before_epoch(*last_horizon_reached); }
+				last_horizon_reached = horizon;
+			}
+		};
 
-			while(!in_flight_events.empty()) {
-				const auto event = std::move(in_flight_events.front()); // NOLINT(performance-move-const-arg)
-				in_flight_events.pop();
+		bool shutdown = false;
+		while(!shutdown) {
+			// Spins briefly, then parks the scheduler thread until the next event arrives
+			std::optional<event> next_event = m_available_events.pop();
 
+			// Drain all events that are available right now (up to a limit so the executor is not starved), preserving their order
+			size_t num_tasks_in_batch = 0;
+			while(next_event.has_value()) {
+				apply_executor_progress();
 				matchbox::match(
-				    event,
+				    *next_event,
 				    [&](const event_task_available& e) {
 					    assert(!shutdown);
 					    assert(e.tsk != nullptr);
-					    const auto cmds = m_dggen->build_task(*e.tsk);
-					    serializer.flush(cmds);
+					    auto cmds = m_dggen->build_task(*e.tsk);
+					    if(lookahead > 0) {
+						    for(const auto cmd : cmds) {
+							    m_iggen->anticipate(*cmd);
+						    }
+					    }
+					    lookahead_window.push_back(std::move(cmds));
+					    const auto type = e.tsk->get_type();
+					    if(type == task_type::horizon || type == task_type::epoch || type == task_type::fence || lookahead_window.size() > lookahead) {
+						    flush_lookahead_window();
+					    }
+					    ++num_tasks_in_batch;
 				    },
 				    [&](const event_buffer_created& e) {
 					    assert(!shutdown);
 					    m_dggen->notify_buffer_created(e.bid, e.range, e.host_initialized);
+					    if(m_iggen != nullptr) { m_iggen->notify_buffer_created(e.bid, e.range, e.elem_size, e.elem_align, e.user_allocation_id); }
 				    },
 				    [&](const event_buffer_debug_name_changed& e) {
 					    assert(!shutdown);
 					    m_dggen->notify_buffer_debug_name_changed(e.bid, e.debug_name);
+					    if(m_iggen != nullptr) { m_iggen->notify_buffer_debug_name_changed(e.bid, e.debug_name); }
 				    },
 				    [&](const event_buffer_destroyed& e) {
 					    assert(!shutdown);
+					    flush_lookahead_window();
 					    m_dggen->notify_buffer_destroyed(e.bid);
+					    if(m_iggen != nullptr) { m_iggen->notify_buffer_destroyed(e.bid); }
 				    },
 				    [&](const event_host_object_created& e) {
 					    assert(!shutdown);
 					    m_dggen->notify_host_object_created(e.hoid);
+					    // Instances are owned by host_object_manager, so the executor must not destroy them
+					    if(m_iggen != nullptr) { m_iggen->notify_host_object_created(e.hoid, false /* owns_instance */); }
 				    },
 				    [&](const event_host_object_destroyed& e) {
 					    assert(!shutdown);
+					    flush_lookahead_window();
 					    m_dggen->notify_host_object_destroyed(e.hoid);
+					    if(m_iggen != nullptr) { m_iggen->notify_host_object_destroyed(e.hoid); }
+				    },
+				    [&](const event_executor_progress&) {
+					    // already applied above
 				    },
 				    [&](const event_shutdown&) {
-					    assert(in_flight_events.empty());
+					    // The executor may still report reached horizons and epochs, but no other events can follow a shutdown
+					    assert(m_iggen != nullptr || m_available_events.empty());
+					    flush_lookahead_window();
 					    shutdown = true;
 				    });
+
+				next_event.reset();
+				if(!shutdown && num_tasks_in_batch < max_tasks_per_batch) { next_event = m_available_events.try_pop(); }
 			}
-		}
-	}
 
-	void abstract_scheduler::notify(const event& evt) {
-		{
-			std::lock_guard lk(m_events_mutex);
-			m_available_events.push(evt);
+			if(!batch.empty()) {
+				// Executor may not be set during tests / benchmarks
+				if(m_exec != nullptr) { m_exec->enqueue(std::move(batch)); }
+				batch.clear();
+			}
 		}
-		m_events_cv.notify_one();
 	}
 
+	void abstract_scheduler::notify(const event& evt) { m_available_events.push(evt); }
+
 	void scheduler::startup() {
 		m_worker_thread = std::thread(&scheduler::schedule, this);
 		set_thread_name(m_worker_thread.native_handle(), "cy-scheduler");
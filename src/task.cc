@@ -72,7 +72,7 @@ namespace detail {
 
 	void side_effect_map::add_side_effect(const host_object_id hoid, const experimental::side_effect_order order) {
 		// TODO for multiple side effects on the same hoid, find the weakest order satisfying all of them
-		emplace(hoid, order);
+		if(find(hoid) == end()) { m_entries.emplace_back(hoid, order); }
 	}
 
 	std::string print_task_debug_label(const task& tsk, bool title_case) {
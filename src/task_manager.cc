@@ -11,9 +11,8 @@ namespace detail {
 	    : m_num_collective_nodes(num_collective_nodes), m_queue(queue), m_policy(error_policy), m_task_recorder(recorder) {
 		// We manually generate the initial epoch task, which we treat as if it has been reached immediately.
 		auto reserve = m_task_buffer.reserve_task_entry(await_free_task_slot_callback());
-		auto initial_epoch = task::make_epoch(initial_epoch_task, epoch_action::none);
-		if(m_task_recorder != nullptr) { m_task_recorder->record(task_record(*initial_epoch, {})); }
-		m_task_buffer.put(std::move(reserve), std::move(initial_epoch));
+		const auto& initial_epoch = m_task_buffer.put(std::move(reserve), task::make_epoch(initial_epoch_task, epoch_action::none));
+		if(m_task_recorder != nullptr) { m_task_recorder->record(task_record(initial_epoch, {})); }
 	}
 
 	void task_manager::notify_buffer_created(const buffer_id bid, const range<3>& range, const bool host_initialized) {
@@ -54,6 +53,7 @@ namespace detail {
 		if(m_latest_horizon_reached) { m_latest_epoch_reached.set(*m_latest_horizon_reached); }
 
 		m_latest_horizon_reached = horizon_tid;
+		m_num_horizons_reached.fetch_add(1, std::memory_order_relaxed);
 	}
 
 	void task_manager::notify_epoch_reached(task_id epoch_tid) {
@@ -199,27 +199,30 @@ namespace detail {
 		}
 	}
 
-	task& task_manager::register_task_internal(task_ring_buffer::reservation&& reserve, std::unique_ptr<task> task) {
-		auto& task_ref = *task;
-		assert(task != nullptr);
-		m_task_buffer.put(std::move(reserve), std::move(task));
-		m_execution_front.insert(&task_ref);
+	task& task_manager::register_task_internal(task_ring_buffer::reservation&& reserve, task&& tsk) {
+		auto& task_ref = m_task_buffer.put(std::move(reserve), std::move(tsk));
+		m_execution_front.push_back(&task_ref);
 		return task_ref;
 	}
 
-	void task_manager::invoke_callbacks(const task* tsk) const {
+	void task_manager::invoke_callbacks(const task* tsk, const std::optional<horizon_decision>& decision) const {
 		for(const auto& cb : m_task_callbacks) {
 			cb(tsk);
 		}
 		if(m_task_recorder != nullptr) {
-			m_task_recorder->record(task_record(*tsk, [this](const buffer_id bid) { return m_buffers.at(bid).debug_name; }));
+			task_record rec(*tsk, [this](const buffer_id bid) { return m_buffers.at(bid).debug_name; });
+			rec.horizon_decision = decision;
+			m_task_recorder->record(std::move(rec));
 		}
 	}
 
 	void task_manager::add_dependency(task& depender, task& dependee, dependency_kind kind, dependency_origin origin) {
 		assert(&depender != &dependee);
 		depender.add_dependency({&dependee, kind, origin});
-		m_execution_front.erase(&dependee);
+		if(const auto it = std::find(m_execution_front.begin(), m_execution_front.end(), &dependee); it != m_execution_front.end()) {
+			*it = m_execution_front.back();
+			m_execution_front.pop_back();
+		}
 		m_max_pseudo_critical_path_length = std::max(m_max_pseudo_critical_path_length, depender.get_pseudo_critical_path_length());
 	}
 
@@ -232,14 +235,21 @@ namespace detail {
 		return need_horizon;
 	}
 
-	task& task_manager::reduce_execution_front(task_ring_buffer::reservation&& reserve, std::unique_ptr<task> new_front) {
-		// add dependencies from a copy of the front to this task
-		const auto current_front = m_execution_front;
+	task& task_manager::reduce_execution_front(task_ring_buffer::reservation&& reserve, task&& new_front) {
+		// tasks cannot be moved once they have dependencies, so place the new task in its slot first, but only publish it to other threads once its
+		// dependencies on the current execution front are complete
+		auto& new_front_ref = m_task_buffer.emplace(reserve, std::move(new_front));
+		// add dependencies from the current front to this task, then re-use its vector (with the capacity it has grown to) as the new front
+		auto current_front = std::exchange(m_execution_front, {});
 		for(task* front_task : current_front) {
-			add_dependency(*new_front, *front_task, dependency_kind::true_dep, dependency_origin::execution_front);
+			add_dependency(new_front_ref, *front_task, dependency_kind::true_dep, dependency_origin::execution_front);
 		}
 		assert(m_execution_front.empty());
-		return register_task_internal(std::move(reserve), std::move(new_front));
+		m_execution_front = std::move(current_front);
+		m_execution_front.clear();
+		m_task_buffer.publish(std::move(reserve));
+		m_execution_front.push_back(&new_front_ref);
+		return new_front_ref;
 	}
 
 	void task_manager::set_epoch_for_new_tasks(const task_id epoch) {
@@ -270,11 +280,32 @@ namespace detail {
 
 		task& new_horizon = reduce_execution_front(std::move(reserve), task::make_horizon(*m_current_horizon));
 		if(previous_horizon) { set_epoch_for_new_tasks(*previous_horizon); }
+		++m_num_horizons_generated;
+
+		std::optional<horizon_decision> decision;
+		if(m_horizon_policy.has_value()) {
+			decision = m_horizon_policy->evaluate(sample_horizon_feedback());
+			m_task_horizon_step_size = decision->step;
+			CELERITY_TRACE("Adaptive horizon step after T{}: {} -> {} ({} horizons in flight, {} live tasks, {} region map entries)", tid,
+			    decision->previous_step, decision->step, decision->feedback.horizons_in_flight, decision->feedback.live_tasks,
+			    decision->feedback.region_map_entries);
+		}
 
-		invoke_callbacks(&new_horizon);
+		invoke_callbacks(&new_horizon, decision);
 		return tid;
 	}
 
+	horizon_feedback task_manager::sample_horizon_feedback() const {
+		horizon_feedback fb;
+		const auto num_reached = m_num_horizons_reached.load(std::memory_order_relaxed);
+		fb.horizons_in_flight = m_num_horizons_generated > num_reached ? m_num_horizons_generated - num_reached : 0;
+		fb.live_tasks = m_task_buffer.get_current_task_count();
+		for(const auto& [_, buffer] : m_buffers) {
+			fb.region_map_entries += buffer.last_writers.get_num_entries();
+		}
+		return fb;
+	}
+
 	task_id task_manager::generate_epoch_task(epoch_action action) {
 		auto reserve = m_task_buffer.reserve_task_entry(await_free_task_slot_callback());
 		const auto tid = reserve.get_tid();
@@ -321,8 +352,9 @@ namespace detail {
 			if(get_first_in_flight_epoch() == m_latest_epoch_reached.get()) {
 				// verify that the epoch didn't get reached between the invocation of the callback and the in flight check
 				if(m_latest_epoch_reached.get() < previous_free_tid + 1) {
-					throw std::runtime_error("Exhausted task slots with no horizons or epochs in flight."
-					                         "\nLikely due to generating a very large number of tasks with no dependencies.");
+					throw std::runtime_error(fmt::format("Exhausted task slots with no horizons or epochs in flight ({} bytes held by {} live tasks)."
+					                                     "\nLikely due to generating a very large number of tasks with no dependencies.",
+					    m_task_buffer.get_live_task_bytes(), m_task_buffer.get_current_task_count()));
 				}
 			}
 			task_id reached_epoch = m_latest_epoch_reached.await(previous_free_tid + 1);
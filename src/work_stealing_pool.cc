@@ -0,0 +1,99 @@
+#include "work_stealing_pool.h"
+
+#include "affinity.h"
+#include "log.h"
+#include "named_threads.h"
+
+#include <cassert>
+
+#include <fmt/format.h>
+
+namespace celerity::detail {
+
+work_stealing_pool::work_stealing_pool(const size_t num_workers, const std::string& thread_name_prefix, const std::vector<uint32_t>& core_ids) {
+	assert(num_workers > 0);
+	m_workers.reserve(num_workers);
+	for(size_t i = 0; i < num_workers; ++i) {
+		m_workers.push_back(std::make_unique<worker>());
+	}
+	// Only spawn threads once all deques exist, since workers start stealing right away
+	for(size_t i = 0; i < num_workers; ++i) {
+		auto& thread = m_workers[i]->thread;
+		thread = std::thread(&work_stealing_pool::work, this, i);
+		set_thread_name(thread.native_handle(), fmt::format("{}.{}", thread_name_prefix, i));
+#ifndef __APPLE__
+		if(!core_ids.empty()) {
+			const auto core_id = core_ids[i % core_ids.size()];
+			if(!set_thread_affinity(thread.native_handle(), core_id)) { CELERITY_WARN("Failed to pin worker thread {}.{} to core {}", thread_name_prefix, i, core_id); }
+		}
+#endif
+	}
+}
+
+work_stealing_pool::~work_stealing_pool() { stop(); }
+
+void work_stealing_pool::submit(job j) {
+	const auto worker_idx = m_next_worker.fetch_add(1, std::memory_order_relaxed) % m_workers.size();
+	m_num_queued.fetch_add(1, std::memory_order_seq_cst);
+	{
+		auto& w = *m_workers[worker_idx];
+		std::lock_guard lock(w.mutex);
+		w.jobs.push_back(std::move(j));
+	}
+	// Acquire the sleep mutex so that a worker that is about to wait cannot miss the notification
+	{ std::lock_guard lock(m_sleep_mutex); }
+	m_sleep_cv.notify_one();
+}
+
+void work_stealing_pool::stop() {
+	{
+		std::lock_guard lock(m_sleep_mutex);
+		if(m_stop_requested) return;
+		m_stop_requested = true;
+	}
+	m_sleep_cv.notify_all();
+	for(auto& w : m_workers) {
+		if(w->thread.joinable()) { w->thread.join(); }
+	}
+}
+
+std::optional<work_stealing_pool::job> work_stealing_pool::try_acquire(const size_t worker_idx) {
+	// Own jobs are taken from the front, in submission order
+	{
+		auto& own = *m_workers[worker_idx];
+		std::lock_guard lock(own.mutex);
+		if(!own.jobs.empty()) {
+			auto j = std::move(own.jobs.front());
+			own.jobs.pop_front();
+			m_num_queued.fetch_sub(1, std::memory_order_relaxed);
+			return j;
+		}
+	}
+	// Steal from the back of other workers' deques, starting with the next neighbor to spread contention
+	for(size_t i = 1; i < m_workers.size(); ++i) {
+		auto& victim = *m_workers[(worker_idx + i) % m_workers.size()];
+		std::lock_guard lock(victim.mutex);
+		if(!victim.jobs.empty()) {
+			auto j = std::move(victim.jobs.back());
+			victim.jobs.pop_back();
+			m_num_queued.fetch_sub(1, std::memory_order_relaxed);
+			return j;
+		}
+	}
+	return std::nullopt;
+}
+
+void work_stealing_pool::work(const size_t worker_idx) {
+	for(;;) {
+		if(auto j = try_acquire(worker_idx)) {
+			(*j)();
+			continue;
+		}
+		std::unique_lock lock(m_sleep_mutex);
+		m_sleep_cv.wait(lock, [this] { return m_num_queued.load(std::memory_order_seq_cst) > 0 || m_stop_requested; });
+		// Drain all remaining jobs before honoring a stop request
+		if(m_stop_requested && m_num_queued.load(std::memory_order_seq_cst) == 0) return;
+	}
+}
+
+} // namespace celerity::detail
@@ -3,10 +3,20 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/generators/catch_generators.hpp>
 
+#include <chrono>
+#include <cstdlib>
+#include <deque>
+#include <new>
+#include <string_view>
+
 #include "command_graph.h"
 #include "distributed_graph_generator.h"
+#include "executor.h"
+#include "host_queue.h"
 #include "instruction_graph_generator.h"
 #include "intrusive_graph.h"
+#include "mpsc_queue.h"
+#include "pilot.h"
 #include "task_manager.h"
 #include "test_utils.h"
 
@@ -14,6 +24,18 @@ using namespace celerity;
 using namespace celerity::detail;
 using namespace std::chrono_literals;
 
+// Counts heap allocations on the calling thread, so that benchmarks can verify that a code path does not allocate in steady state
+static thread_local size_t num_thread_allocations = 0;
+
+void* operator new(const size_t size) {
+	++num_thread_allocations;
+	if(void* const ptr = std::malloc(size > 0 ? size : 1)) return ptr;
+	throw std::bad_alloc();
+}
+
+void operator delete(void* const ptr) noexcept { std::free(ptr); }
+void operator delete(void* const ptr, size_t /* size */) noexcept { std::free(ptr); }
+
 struct bench_graph_node : intrusive_graph_node<bench_graph_node> {};
 
 // try to cover the dependency counts we'll see in practice
@@ -91,6 +113,15 @@ TEST_CASE("benchmark task handling", "[benchmark][group:task-graph]") {
 		}
 	};
 
+	SECTION("without allocations in steady state") {
+		initialization_lambda();
+		// warm up until the task_ring_buffer segments that are re-used from here on and the storage of all their slots have been allocated
+		task_creation_lambda();
+		const auto num_allocations_before = num_thread_allocations;
+		task_creation_lambda();
+		CHECK(num_thread_allocations - num_allocations_before == 0);
+	}
+
 	SECTION("without access thread") {
 		highest_tid_to_delete = N * 2; // set sufficiently high to just run through
 		BENCHMARK("generating and deleting tasks") {
@@ -185,7 +216,8 @@ struct command_graph_generator_benchmark_context {
 	    num_nodes, 0 /* local_nid */, cdag, tm, test_utils::print_graphs ? &crec : nullptr, benchmark_command_graph_generator_policy};
 	test_utils::mock_buffer_factory mbf{tm, dggen};
 
-	explicit command_graph_generator_benchmark_context(const size_t num_nodes) : num_nodes(num_nodes) {
+	explicit command_graph_generator_benchmark_context(const size_t num_nodes, const size_t num_generation_workers = 0) : num_nodes(num_nodes) {
+		if(num_generation_workers > 0) { dggen.enable_parallel_generation(num_generation_workers); }
 		tm.register_task_callback([this](const task* tsk) {
 			const auto cmds = dggen.build_task(*tsk);
 
@@ -213,6 +245,7 @@ struct command_graph_generator_benchmark_context {
 struct instruction_graph_generator_benchmark_context {
 	const size_t num_nodes;
 	const size_t num_devices;
+	instruction_graph_generator::delegate* const dlg;
 	command_graph cdag;
 	task_recorder trec;
 	task_manager tm{num_nodes, nullptr /* host_queue */, test_utils::print_graphs ? &trec : nullptr, benchmark_task_manager_policy};
@@ -222,10 +255,12 @@ struct instruction_graph_generator_benchmark_context {
 	instruction_recorder irec;
 	instruction_graph idag;
 	instruction_graph_generator iggen{tm, num_nodes, 0 /* local nid */, test_utils::make_system_info(num_devices, true /* allow d2d copies */), idag,
-	    nullptr /* delegate */, test_utils::print_graphs ? &irec : nullptr, benchmark_instruction_graph_generator_policy};
+	    dlg, test_utils::print_graphs ? &irec : nullptr, benchmark_instruction_graph_generator_policy};
 	test_utils::mock_buffer_factory mbf{tm, dggen, iggen};
 
-	explicit instruction_graph_generator_benchmark_context(const size_t num_nodes, const size_t num_devices) : num_nodes(num_nodes), num_devices(num_devices) {
+	explicit instruction_graph_generator_benchmark_context(
+	    const size_t num_nodes, const size_t num_devices, instruction_graph_generator::delegate* const dlg = nullptr)
+	    : num_nodes(num_nodes), num_devices(num_devices), dlg(dlg) {
 		tm.register_task_callback([this](const task* tsk) {
 			for(const auto cmd : sort_topologically(dggen.build_task(*tsk))) {
 				iggen.compile(*cmd);
@@ -353,6 +388,209 @@ struct scheduler_benchmark_context {
 	}
 };
 
+// Reference: The mutex + condition variable queue with consumer-side swapping that abstract_scheduler used before switching to mpsc_queue
+template <typename T>
+class mutex_swap_queue {
+  public:
+	void push(T v) {
+		{
+			std::lock_guard lk(m_mutex);
+			m_available.push(std::move(v));
+		}
+		m_cv.notify_one();
+	}
+
+	T pop() {
+		if(m_in_flight.empty()) {
+			std::unique_lock lk(m_mutex);
+			m_cv.wait(lk, [this] { return !m_available.empty(); });
+			std::swap(m_available, m_in_flight);
+		}
+		auto v = std::move(m_in_flight.front());
+		m_in_flight.pop();
+		return v;
+	}
+
+  private:
+	std::mutex m_mutex;
+	std::condition_variable m_cv;
+	std::queue<T> m_available;
+	std::queue<T> m_in_flight;
+};
+
+template <typename Queue>
+void run_event_queue_benchmark(restartable_thread& consumer, Queue& queue, const size_t num_events) {
+	// Mimic the scheduler, which receives one event_task_available per submitted task and terminates on a shutdown event (nullptr)
+	size_t num_received = 0;
+	consumer.start([&] {
+		while(queue.pop() != nullptr) {
+			++num_received;
+		}
+	});
+	const int dummy_task = 0;
+	for(size_t i = 0; i < num_events; ++i) {
+		queue.push(&dummy_task);
+	}
+	queue.push(nullptr);
+	consumer.join();
+	assert(num_received == num_events);
+}
+
+TEMPLATE_TEST_CASE_SIG(
+    "benchmark task submission throughput to the scheduler thread for N tasks", "[benchmark][group:scheduler]", ((size_t N), N), 100, 10000) {
+	restartable_thread consumer;
+
+	BENCHMARK("reference: mutex and std::queue swap") {
+		mutex_swap_queue<const int*> queue;
+		run_event_queue_benchmark(consumer, queue, N);
+	};
+
+	BENCHMARK("lock-free mpsc_queue") {
+		mpsc_queue<const int*> queue(1024);
+		run_event_queue_benchmark(consumer, queue, N);
+	};
+}
+
+// Mimics the in-flight job set of the executor: `num_chains` independent chains of commands where every 8th command is a (prioritized) push. Each job is
+// asynchronous and completes on the first poll after it has been started.
+struct executor_job_workload {
+	constexpr static size_t num_chains = 16;
+
+	std::vector<std::vector<command_id>> dependencies;
+
+	explicit executor_job_workload(const size_t num_jobs) : dependencies(num_jobs) {
+		for(size_t i = num_chains; i < num_jobs; ++i) {
+			dependencies[i].push_back(command_id(i - num_chains));
+		}
+	}
+
+	size_t size() const { return dependencies.size(); }
+	static bool is_push(const command_id cid) { return cid % 8 == 0; }
+};
+
+// The executor loop before dependency counting: scan all in-flight jobs in every iteration to find ready, running and completed ones.
+size_t run_linear_scan_executor_loop(const executor_job_workload& workload) {
+	struct job_handle {
+		bool running = false;
+		std::vector<command_id> dependents;
+		size_t unsatisfied_dependencies = 0;
+	};
+	std::unordered_map<command_id, job_handle> jobs;
+	for(command_id cid = 0; cid < workload.size(); ++cid) {
+		jobs[cid];
+		for(const auto dcid : workload.dependencies[cid]) {
+			if(const auto it = jobs.find(dcid); it != jobs.end()) {
+				it->second.dependents.push_back(cid);
+				jobs[cid].unsatisfied_dependencies++;
+			}
+		}
+	}
+
+	size_t num_retired = 0;
+	std::vector<command_id> ready_jobs;
+	while(!jobs.empty()) {
+		ready_jobs.clear();
+		for(auto it = jobs.begin(); it != jobs.end();) {
+			auto& handle = it->second;
+			if(handle.unsatisfied_dependencies > 0) {
+				++it;
+				continue;
+			}
+			if(!handle.running) {
+				if(std::find(ready_jobs.cbegin(), ready_jobs.cend(), it->first) == ready_jobs.cend()) { ready_jobs.push_back(it->first); }
+				++it;
+				continue;
+			}
+			for(const auto d : handle.dependents) {
+				if(--jobs[d].unsatisfied_dependencies == 0) { ready_jobs.push_back(d); }
+			}
+			it = jobs.erase(it);
+			++num_retired;
+		}
+		std::sort(ready_jobs.begin(), ready_jobs.end(),
+		    [](const command_id a, const command_id b) { return executor_job_workload::is_push(a) && !executor_job_workload::is_push(b); });
+		for(const auto cid : ready_jobs) {
+			jobs.at(cid).running = true;
+		}
+	}
+	return num_retired;
+}
+
+size_t run_dependency_counting_executor_loop(const executor_job_workload& workload) {
+	job_dependency_tracker tracker;
+	for(command_id cid = 0; cid < workload.size(); ++cid) {
+		tracker.add(cid, workload.dependencies[cid], executor_job_workload::is_push(cid));
+	}
+
+	size_t num_retired = 0;
+	std::vector<command_id> polled_jobs;
+	std::vector<command_id> next_polled_jobs;
+	while(!tracker.is_empty()) {
+		while(const auto cid = tracker.pop_ready()) {
+			next_polled_jobs.push_back(*cid);
+		}
+		for(const auto cid : polled_jobs) {
+			tracker.complete(cid);
+			++num_retired;
+		}
+		std::swap(polled_jobs, next_polled_jobs);
+		next_polled_jobs.clear();
+	}
+	return num_retired;
+}
+
+TEMPLATE_TEST_CASE_SIG(
+    "benchmark executor job handling overhead with N in-flight commands", "[benchmark][group:executor]", ((size_t N), N), 1000, 10000, 100000) {
+	const executor_job_workload workload(N);
+
+	// The linear scan is quadratic in the number of in-flight jobs and takes too long to be sampled meaningfully for the largest configuration
+	if constexpr(N <= 10000) {
+		BENCHMARK("reference: linear scan over all jobs") { return run_linear_scan_executor_loop(workload); };
+	}
+
+	BENCHMARK("dependency counting with ready queue") { return run_dependency_counting_executor_loop(workload); };
+
+	CHECK(run_dependency_counting_executor_loop(workload) == N);
+}
+
+// Host tasks of uneven duration, as with I/O or preprocessing of differently-sized inputs. Every 16th task takes 40x longer than the others.
+void run_uneven_host_task(const size_t i) {
+	const auto duration = i % 16 == 0 ? std::chrono::microseconds(200) : std::chrono::microseconds(5);
+	// "busy sleep" because system timer resolution is not high enough to get down to 5 us intervals
+	const auto start = std::chrono::steady_clock::now();
+	while(std::chrono::steady_clock::now() - start < duration)
+		;
+}
+
+TEMPLATE_TEST_CASE_SIG("benchmark host task throughput with N tasks", "[benchmark][group:host-queue]", ((size_t N), N), 100, 10000) {
+	BENCHMARK_ADVANCED("reference: fixed ctpl::thread_pool with 4 threads")(Catch::Benchmark::Chronometer meter) {
+		ctpl::thread_pool pool(4);
+		std::vector<std::future<void>> futures(N);
+		meter.measure([&] {
+			for(size_t i = 0; i < N; ++i) {
+				futures[i] = pool.push([i](int) { run_uneven_host_task(i); });
+			}
+			for(auto& f : futures) {
+				f.wait();
+			}
+		});
+	};
+
+	BENCHMARK_ADVANCED("host_queue with work-stealing pool")(Catch::Benchmark::Chronometer meter) {
+		host_queue queue;
+		std::vector<std::future<host_queue::execution_info>> futures(N);
+		meter.measure([&] {
+			for(size_t i = 0; i < N; ++i) {
+				futures[i] = queue.submit([i](MPI_Comm) { run_uneven_host_task(i); });
+			}
+			for(auto& f : futures) {
+				f.wait();
+			}
+		});
+		queue.wait();
+	};
+}
+
 template <typename BaseBenchmarkContext>
 struct submission_throttle_benchmark_context : public BaseBenchmarkContext {
 	const std::chrono::steady_clock::duration delay_per_submission;
@@ -373,6 +611,27 @@ struct submission_throttle_benchmark_context : public BaseBenchmarkContext {
 	}
 };
 
+// Simulates an executor that reaches each horizon once `executor_lag` newer horizons have been generated, to feed back into the horizon policy
+template <typename BaseBenchmarkContext>
+struct horizon_feedback_benchmark_context : public BaseBenchmarkContext {
+	const size_t executor_lag;
+	std::deque<task_id> horizons_in_flight;
+
+	template <typename... BaseCtorParams>
+	explicit horizon_feedback_benchmark_context(const bool adaptive_horizons, const size_t executor_lag, BaseCtorParams&&... args)
+	    : BaseBenchmarkContext{std::forward<BaseCtorParams>(args)...}, executor_lag(executor_lag) {
+		if(adaptive_horizons) { this->tm.enable_adaptive_horizons(); }
+		this->tm.register_task_callback([this](const task* tsk) {
+			if(tsk->get_type() != task_type::horizon) return;
+			horizons_in_flight.push_back(tsk->get_id());
+			while(horizons_in_flight.size() > this->executor_lag) {
+				this->tm.notify_horizon_reached(horizons_in_flight.front());
+				horizons_in_flight.pop_front();
+			}
+		});
+	}
+};
+
 
 // The generate_* methods are [[noinline]] to make them visible in a profiler.
 
@@ -505,10 +764,15 @@ TEST_CASE("generating large task graphs", "[benchmark][group:task-graph]") {
 	run_benchmarks([] { return task_manager_benchmark_context{}; });
 }
 
-TEMPLATE_TEST_CASE_SIG("generating large command graphs for N nodes", "[benchmark][group:command-graph]", ((size_t NumNodes), NumNodes), 1, 4, 16) {
+TEMPLATE_TEST_CASE_SIG("generating large command graphs for N nodes", "[benchmark][group:command-graph]", ((size_t NumNodes), NumNodes), 1, 4, 16, 64, 256) {
 	run_benchmarks([] { return command_graph_generator_benchmark_context{NumNodes}; });
 }
 
+TEMPLATE_TEST_CASE_SIG(
+    "generating large command graphs for N nodes with 4 generation workers", "[benchmark][group:command-graph]", ((size_t NumNodes), NumNodes), 16, 64, 256) {
+	run_benchmarks([] { return command_graph_generator_benchmark_context{NumNodes, 4}; });
+}
+
 TEMPLATE_TEST_CASE_SIG(
     "generating large instruction graphs for N devices", "[benchmark][group:instruction-graph]", ((size_t NumDevices), NumDevices), 1, 4, 16) {
 	constexpr static size_t num_nodes = 2;
@@ -533,6 +797,83 @@ TEMPLATE_TEST_CASE_SIG(
 	}
 }
 
+TEMPLATE_TEST_CASE_SIG("generating command graphs under static and adaptive horizon policies with an executor lag of N horizons",
+    "[benchmark][group:horizons]", ((size_t ExecutorLag), ExecutorLag), 0, 4) {
+	constexpr static size_t num_nodes = 4;
+	const auto make_ctx = [](const bool adaptive_horizons) {
+		return horizon_feedback_benchmark_context<command_graph_generator_benchmark_context>(adaptive_horizons, ExecutorLag, num_nodes);
+	};
+
+	// longer runs than in run_benchmarks, so that horizon placement dominates
+	BENCHMARK("wave_sim topology, static horizons") { generate_wave_sim_graph(make_ctx(false), 250); };
+	BENCHMARK("wave_sim topology, adaptive horizons") { generate_wave_sim_graph(make_ctx(true), 250); };
+	BENCHMARK("jacobi topology, static horizons") { generate_jacobi_graph(make_ctx(false), 500); };
+	BENCHMARK("jacobi topology, adaptive horizons") { generate_jacobi_graph(make_ctx(true), 500); };
+}
+
+// Stands in for the live executor and counts what instruction graph generation hands over to it
+class counting_instruction_graph_delegate final : public instruction_graph_generator::delegate {
+  public:
+	size_t num_instructions = 0;
+	size_t num_pilots = 0;
+
+	void flush_instructions(std::vector<const instruction*> instrs) override { num_instructions += instrs.size(); }
+	void flush_outbound_pilots(std::vector<outbound_pilot> pilots) override { num_pilots += pilots.size(); }
+};
+
+// Same topologies and sizes as run_benchmarks, but passing each generator to a callback that takes the benchmark context by reference
+template <typename Consumer>
+void for_each_topology(Consumer&& consume) {
+	consume("soup", [](auto& ctx) { generate_soup_graph(ctx, 100); });
+	consume("chain", [](auto& ctx) { generate_chain_graph(ctx, 30); });
+	consume("expanding tree", [](auto& ctx) { generate_tree_graph<tree_topology::expanding>(ctx, 30); });
+	consume("contracting tree", [](auto& ctx) { generate_tree_graph<tree_topology::contracting>(ctx, 30); });
+	consume("wave_sim", [](auto& ctx) { generate_wave_sim_graph(ctx, 50); });
+	consume("jacobi", [](auto& ctx) { generate_jacobi_graph(ctx, 50); });
+}
+
+// Catch2 benchmarks only report timings, so instruction throughput, pilot counts and the peak size of the generator's tracking structures are measured in
+// separate, untimed runs and printed as one line per topology
+void print_instruction_graph_generation_statistics(const size_t num_nodes, const size_t num_devices) {
+	for_each_topology([&](const std::string_view topology, const auto& generate) {
+		counting_instruction_graph_delegate counter;
+		const auto start = std::chrono::steady_clock::now();
+		{
+			instruction_graph_generator_benchmark_context ctx(num_nodes, num_devices, &counter);
+			generate(ctx);
+		} // includes the shutdown epoch
+		const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		// sampling the generator state after every task would distort the timing above, so we generate the same graph a second time
+		instruction_graph_generator::state_statistics peak;
+		{
+			instruction_graph_generator_benchmark_context ctx(num_nodes, num_devices);
+			ctx.tm.register_task_callback([&](const task* /* tsk */) {
+				const auto stats = ctx.iggen.get_state_statistics();
+				if(stats.approximate_bytes > peak.approximate_bytes) { peak = stats; }
+			});
+			generate(ctx);
+		}
+
+		fmt::print("{} nodes, {} devices, {} topology: {} instructions ({:.0f}/s), {} pilots, peak generator state {} region map entries, "
+		           "{} access front instructions, {} allocations, {:.1f} KiB\n",
+		    num_nodes, num_devices, topology, counter.num_instructions, static_cast<double>(counter.num_instructions) / seconds, counter.num_pilots,
+		    peak.num_region_map_entries, peak.num_access_front_instructions, peak.num_allocations, static_cast<double>(peak.approximate_bytes) / 1024.0);
+	});
+}
+
+// Hidden by default because the full sweep runs for a long time. Select it with `[group:instruction-graph-sweep]`.
+TEMPLATE_TEST_CASE_SIG("generating instruction graphs for N nodes with D devices each", "[.][benchmark][group:instruction-graph-sweep]",
+    ((size_t NumNodes, size_t NumDevices), NumNodes, NumDevices), //
+    (1, 1), (1, 2), (1, 4), (1, 8), (1, 16),                      //
+    (4, 1), (4, 2), (4, 4), (4, 8), (4, 16),                      //
+    (16, 1), (16, 2), (16, 4), (16, 8), (16, 16),                 //
+    (64, 1), (64, 2), (64, 4), (64, 8), (64, 16),                 //
+    (256, 1), (256, 2), (256, 4), (256, 8), (256, 16)) {
+	run_benchmarks([] { return instruction_graph_generator_benchmark_context(NumNodes, NumDevices); });
+	print_instruction_graph_generation_statistics(NumNodes, NumDevices);
+}
+
 template <typename BenchmarkContextFactory, typename BenchmarkContextConsumer>
 void debug_graphs(BenchmarkContextFactory&& make_ctx, BenchmarkContextConsumer&& debug_ctx) {
 	debug_ctx(generate_soup_graph(make_ctx(), 10));
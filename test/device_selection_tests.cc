@@ -550,3 +550,49 @@ TEST_CASE_METHOD(celerity::test_utils::mpi_fixture, "pick_device prints informat
 		}
 	}
 }
+
+TEST_CASE("pick_devices distributes the remaining devices of the primary platform by local rank", "[device-selection]") {
+	mock_platform_factory mpf;
+
+	auto [mp_0, mp_1] = mpf.create_platforms(std::nullopt, std::nullopt);
+	mp_0.create_devices(dt::cpu);
+	const auto gpus = mp_1.create_devices(dt::gpu, dt::cpu, dt::gpu, dt::gpu, dt::gpu, dt::gpu);
+
+	const size_t node_count = 2;
+	const size_t local_rank = GENERATE(values<size_t>({0, 1}));
+	CAPTURE(local_rank);
+
+	celerity::detail::host_config h_cfg{node_count, local_rank};
+	celerity::detail::config cfg(nullptr, nullptr);
+	celerity::detail::config_testspy::set_mock_host_cfg(cfg, h_cfg);
+
+	const auto primary = pick_device(cfg, celerity::detail::auto_select_device{}, std::vector<mock_platform>{mp_0, mp_1});
+	const auto devices = pick_devices(cfg, celerity::detail::auto_select_device{}, primary);
+	if(local_rank == 0) {
+		CHECK(devices == std::vector<mock_device>{gpus[0], gpus[3], gpus[5]});
+	} else {
+		CHECK(devices == std::vector<mock_device>{gpus[2], gpus[4]});
+	}
+}
+
+TEST_CASE("pick_devices does not add devices when the primary device was not assigned by local rank", "[device-selection]") {
+	celerity::test_utils::allow_max_log_level(celerity::detail::log_level::warn);
+
+	mock_platform_factory mpf;
+
+	auto [mp] = mpf.create_platforms(std::nullopt);
+	const auto gpus = mp.create_devices(dt::gpu, dt::gpu);
+
+	celerity::detail::host_config h_cfg{4 /* node count */, 3 /* local rank */};
+	celerity::detail::config cfg(nullptr, nullptr);
+	celerity::detail::config_testspy::set_mock_host_cfg(cfg, h_cfg);
+
+	SECTION("for a user-specified device") {
+		CHECK(pick_devices(cfg, gpus[1], gpus[1]) == std::vector<mock_device>{gpus[1]});
+	}
+
+	SECTION("when there are fewer devices than ranks on the host") {
+		const auto primary = pick_device(cfg, celerity::detail::auto_select_device{}, std::vector<mock_platform>{mp});
+		CHECK(pick_devices(cfg, celerity::detail::auto_select_device{}, primary) == std::vector<mock_device>{primary});
+	}
+}
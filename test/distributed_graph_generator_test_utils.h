@@ -603,6 +603,8 @@ class dist_cdag_test_context {
 
 	distributed_graph_generator& get_graph_generator(node_id nid) { return *m_dggens.at(nid); }
 
+	command_graph& get_command_graph(node_id nid) { return *m_cdags.at(nid); }
+
 	[[nodiscard]] std::string print_task_graph() { return detail::print_task_graph(m_task_recorder, make_test_graph_title("Task Graph")); }
 	[[nodiscard]] std::string print_command_graph(node_id nid) {
 		return detail::print_command_graph(nid, *m_cmd_recorders[nid], make_test_graph_title("Command Graph"));
@@ -69,6 +69,26 @@ TEST_CASE("distributed_graph_generator doesn't generate data transfer commands f
 	}
 }
 
+TEST_CASE("distributed_graph_generator pushes replicated data to each reading node exactly once when the node set spans multiple bitset words",
+    "[distributed_graph_generator][command-graph]") {
+	const size_t num_nodes = 66;
+	dist_cdag_test_context dctx(num_nodes);
+
+	const range<1> test_range = {num_nodes};
+	auto buf = dctx.create_buffer(test_range);
+
+	dctx.master_node_host_task().discard_write(buf, acc::all{}).submit();
+	dctx.device_compute<class UKN(task_a)>(test_range).read(buf, acc::all{}).submit();
+	CHECK(dctx.query(command_type::push).count() == num_nodes - 1);
+	CHECK(dctx.query(command_type::push, node_id(0)).count() == num_nodes - 1);
+	CHECK(dctx.query(command_type::await_push).count() == num_nodes - 1);
+
+	// All nodes hold a replica now, so a second reader must not cause any further transfers
+	dctx.device_compute<class UKN(task_b)>(test_range).read(buf, acc::all{}).submit();
+	CHECK(dctx.query(command_type::push).count() == num_nodes - 1);
+	CHECK(dctx.query(command_type::await_push).count() == num_nodes - 1);
+}
+
 TEST_CASE("distributed_graph_generator uses original producer as source for push rather than building dependency chain",
     "[distributed_graph_generator][command-graph]") {
 	const size_t num_nodes = 3;
@@ -530,3 +530,33 @@ TEST_CASE("distributed_graph_generator throws in tests if it detects overlapping
 		    "range mapper for this write access or constrain the split via experimental::constrain_split to make the access non-overlapping.");
 	}
 }
+
+TEST_CASE("distributed_graph_generator generates identical command graphs with parallel generation", "[distributed_graph_generator][command-graph]") {
+	constexpr size_t num_nodes = 20; // enough chunks to actually distribute the work across the worker pool
+
+	const auto build_graphs = [](const bool parallel) {
+		dist_cdag_test_context dctx(num_nodes);
+		if(parallel) {
+			for(node_id nid = 0; nid < num_nodes; ++nid) {
+				dctx.get_graph_generator(nid).enable_parallel_generation(2);
+			}
+		}
+
+		const range<2> test_range = {num_nodes * 4, 64};
+		auto buf_a = dctx.create_buffer(test_range);
+		auto buf_b = dctx.create_buffer(test_range);
+		auto buf_r = dctx.create_buffer(range<1>(1));
+		dctx.device_compute<class UKN(init)>(test_range).discard_write(buf_a, acc::one_to_one{}).submit();
+		dctx.device_compute<class UKN(stencil)>(test_range).read(buf_a, acc::neighborhood(1, 1)).discard_write(buf_b, acc::one_to_one{}).submit();
+		dctx.device_compute<class UKN(reduce)>(test_range).read(buf_b, acc::all{}).reduce(buf_r, false /* include_current_buffer_value */).submit();
+		dctx.master_node_host_task().read(buf_r, acc::all{}).read(buf_b, acc::all{}).submit();
+
+		std::vector<std::string> graphs;
+		for(node_id nid = 0; nid < num_nodes; ++nid) {
+			graphs.push_back(dctx.print_command_graph(nid));
+		}
+		return graphs;
+	};
+
+	CHECK(build_graphs(true) == build_graphs(false));
+}
@@ -1,4 +1,6 @@
 #include "grid_test_utils.h"
+#include "interval_map.h"
+#include "region_map.h"
 #include "test_utils.h"
 
 #include <tuple>
@@ -171,3 +173,37 @@ TEST_CASE("normalizing a fully mergeable, complex tiling of boxes - 2d", "[bench
 
 	test_utils::render_boxes(boxes_2d, fmt::format("{}-input", label));
 }
+
+// Emulates the last-writer tracking of the task_manager for a 1D stencil: every iteration writes each chunk and reads it back along with a halo.
+template <typename Map>
+size_t track_1d_stencil_last_writers(Map& map, const size_t extent, const size_t num_chunks, const size_t num_iterations) {
+	const auto chunk_size = extent / num_chunks;
+	size_t num_dependencies = 0;
+	int tid = 0;
+	for(size_t iteration = 0; iteration < num_iterations; ++iteration) {
+		for(size_t c = 0; c < num_chunks; ++c) {
+			const auto min = c * chunk_size;
+			const auto max = min + chunk_size;
+			const auto read = box<3>({min > 0 ? min - 1 : 0, 0, 0}, {std::min(max + 1, extent), 1, 1});
+			num_dependencies += map.get_region_values(read).size();
+			map.update_region(box<3>({min, 0, 0}, {max, 1, 1}), ++tid);
+		}
+	}
+	return num_dependencies;
+}
+
+TEST_CASE("tracking last writers of a 1D buffer", "[benchmark][group:grid]") {
+	constexpr size_t extent = 1 << 20;
+	constexpr size_t num_iterations = 10;
+	const auto num_chunks = GENERATE(values<size_t>({4, 64, 512}));
+	const range<3> buffer_range(extent, 1, 1);
+
+	BENCHMARK(fmt::format("{} chunks, region_map", num_chunks)) {
+		region_map<int> map(buffer_range, 0);
+		return track_1d_stencil_last_writers(map, extent, num_chunks, num_iterations);
+	};
+	BENCHMARK(fmt::format("{} chunks, interval_or_region_map", num_chunks)) {
+		interval_or_region_map<int> map(buffer_range, 0);
+		return track_1d_stencil_last_writers(map, extent, num_chunks, num_iterations);
+	};
+}
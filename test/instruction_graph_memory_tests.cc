@@ -437,6 +437,54 @@ TEST_CASE("resizing a buffer allocation for a discard-write access preserves onl
 	CHECK(resize_copy.successors().all_match<free_instruction_record>());
 }
 
+TEST_CASE("commands in a lookahead window are allocated for their combined access pattern", "[instruction_graph_generator][instruction-graph][memory]") {
+	test_utils::idag_test_context ictx(1 /* nodes */, 0 /* my nid */, 1 /* devices */);
+	ictx.set_lookahead(1 /* tasks */);
+	auto buf = ictx.create_buffer(range<1>(256));
+	ictx.device_compute(range<1>(1)).name("1st writer").discard_write(buf, acc::fixed<1>({0, 128})).submit();
+	ictx.device_compute(range<1>(1)).name("2nd writer").discard_write(buf, acc::fixed<1>({64, 192})).submit();
+	ictx.finish();
+
+	const auto all_instrs = ictx.query_instructions();
+
+	// the first writer already allocates the bounding box of both accesses, so no resize (and thus no resize-copy) is necessary for the second writer
+	const auto alloc = all_instrs.select_unique<alloc_instruction_record>();
+	CHECK(alloc->buffer_allocation.value().box == box_cast<3>(box<1>(0, 256)));
+	CHECK(all_instrs.count<copy_instruction_record>() == 0);
+
+	const auto first_writer = all_instrs.select_unique<device_kernel_instruction_record>("1st writer");
+	const auto second_writer = all_instrs.select_unique<device_kernel_instruction_record>("2nd writer");
+	CHECK(first_writer.predecessors() == alloc);
+	CHECK(second_writer.predecessors() == first_writer);
+	CHECK(all_instrs.select_unique<free_instruction_record>().predecessors() == second_writer);
+}
+
+TEST_CASE("allocations only anticipate the commands within the lookahead window", "[instruction_graph_generator][instruction-graph][memory]") {
+	const size_t lookahead = GENERATE(values<size_t>({1, 2}));
+	CAPTURE(lookahead);
+
+	test_utils::idag_test_context ictx(1 /* nodes */, 0 /* my nid */, 1 /* devices */);
+	ictx.set_lookahead(lookahead);
+	auto buf = ictx.create_buffer(range<1>(256));
+	ictx.device_compute(range<1>(1)).name("1st writer").discard_write(buf, acc::fixed<1>({0, 64})).submit();
+	ictx.device_compute(range<1>(1)).name("2nd writer").discard_write(buf, acc::fixed<1>({0, 128})).submit();
+	ictx.device_compute(range<1>(1)).name("3rd writer").discard_write(buf, acc::fixed<1>({0, 256})).submit();
+	ictx.finish();
+
+	const auto all_instrs = ictx.query_instructions();
+	const auto allocs = all_instrs.select_all<alloc_instruction_record>();
+	if(lookahead == 1) {
+		// the window holds the first two writers when it is flushed, the third one is only anticipated after the first allocation has been made
+		REQUIRE(allocs.count() == 2);
+		CHECK(allocs[0]->buffer_allocation.value().box == box_cast<3>(box<1>(0, 128)));
+		CHECK(allocs[1]->buffer_allocation.value().box == box_cast<3>(box<1>(0, 256)));
+	} else {
+		// all three writers are anticipated before the first one is compiled
+		REQUIRE(allocs.count() == 1);
+		CHECK(allocs[0]->buffer_allocation.value().box == box_cast<3>(box<1>(0, 256)));
+	}
+}
+
 TEMPLATE_TEST_CASE_SIG("data from user-initialized buffers is copied lazily to managed allocations", "[instruction_graph_generator][instruction-graph][memory]",
     ((int Dims), Dims), 1, 2, 3) //
 {
@@ -635,3 +683,168 @@ TEST_CASE("overlapping accessors with read + discard_write modes are equivalent
 	CHECK(read_discard_write_kernel.transitive_predecessors_across<copy_instruction_record>().contains(both_alloc_kernels));
 	CHECK(consume_kernel.predecessors() == read_discard_write_kernel);
 }
+
+TEST_CASE("allocations exceeding device memory capacity spill the least-recently used buffer to host memory",
+    "[instruction_graph_generator][instruction-graph][memory]") {
+	const range<1> test_range = {256};
+	test_utils::idag_test_context::policy_set policy;
+	policy.device_memory_capacity = test_range.size() * sizeof(float) * 3 / 2; // holds one buffer, but not two
+
+	test_utils::idag_test_context ictx(1 /* nodes */, 0 /* my nid */, 1 /* devices */, true /* supports d2d copies */, policy);
+	auto buf_a = ictx.create_buffer(test_range);
+	auto buf_b = ictx.create_buffer(test_range);
+	ictx.device_compute(test_range).name("write a").discard_write(buf_a, acc::one_to_one()).submit();
+	ictx.device_compute(test_range).name("write b").discard_write(buf_b, acc::one_to_one()).submit();
+	ictx.device_compute(test_range).name("read a").read(buf_a, acc::one_to_one()).submit();
+	ictx.finish();
+
+	const auto all_instrs = ictx.query_instructions();
+	const auto device_mid = ictx.get_native_memory(device_id(0));
+	const auto on_device = [=](const memory_id mid) { return mid == device_mid; };
+	const auto device_allocs_of = [&](const test_utils::mock_buffer<1>& buf) {
+		return all_instrs.select_all<alloc_instruction_record>([&](const alloc_instruction_record& alloc) {
+			return on_device(alloc.allocation_id.get_memory_id()) && alloc.buffer_allocation->buffer_id == buf.get_id();
+		});
+	};
+	const auto spill_of = [&](const test_utils::mock_buffer<1>& buf) {
+		return all_instrs.select_unique<copy_instruction_record>([&](const copy_instruction_record& copy) {
+			return copy.buffer_id == buf.get_id() && on_device(copy.source_allocation.id.get_memory_id())
+			       && copy.dest_allocation.id.get_memory_id() == host_memory_id;
+		});
+	};
+
+	// buffer a is allocated on the device twice, because it is evicted to make room for b and later read again
+	const auto allocs_a = device_allocs_of(buf_a);
+	REQUIRE(allocs_a.count() == 2);
+	const auto alloc_b = device_allocs_of(buf_b).assert_unique();
+
+	// the first allocation of a is spilled to host memory before it is freed, and b is only allocated after the free
+	const auto spill_a = spill_of(buf_a);
+	CHECK(spill_a.predecessors().contains(all_instrs.select_unique<device_kernel_instruction_record>("write a")));
+	const auto evict_a = spill_a.successors().select_unique<free_instruction_record>();
+	CHECK(evict_a->allocation_id == spill_a->source_allocation.id);
+	CHECK(alloc_b.predecessors().contains(evict_a));
+
+	// reading a again evicts b in turn and copies a back from the host
+	const auto spill_b = spill_of(buf_b);
+	CHECK(spill_b.predecessors().contains(all_instrs.select_unique<device_kernel_instruction_record>("write b")));
+	const auto read_a = all_instrs.select_unique<device_kernel_instruction_record>("read a");
+	const auto restore_a = read_a.predecessors().select_unique<copy_instruction_record>();
+	CHECK(restore_a->source_allocation.id == spill_a->dest_allocation.id);
+	CHECK(on_device(restore_a->dest_allocation.id.get_memory_id()));
+}
+
+TEST_CASE("horizons compact large allocations whose live region has shrunk", "[instruction_graph_generator][instruction-graph][memory]") {
+	const size_t num_devices = 2;
+	const range<1> test_range = {1 << 20}; // each full allocation is larger than the compaction threshold
+	const auto full_bytes = test_range.size() * sizeof(float);
+
+	test_utils::idag_test_context ictx(1 /* nodes */, 0 /* my nid */, num_devices);
+	ictx.set_horizon_step(2);
+	auto buf = ictx.create_buffer(test_range);
+	ictx.device_compute(test_range).name("init").discard_write(buf, acc::one_to_one()).submit();
+	ictx.device_compute(test_range).name("read all").read(buf, acc::all()).submit();
+	for(int i = 0; i < 6; ++i) {
+		ictx.device_compute(test_range).name("update").read_write(buf, acc::one_to_one()).submit();
+	}
+	ictx.finish();
+
+	const auto all_instrs = ictx.query_instructions();
+	const auto on_device = [](const memory_id mid) { return mid >= first_device_memory_id; };
+
+	// every device first grows its allocation to the full buffer, and after a horizon shrinks it back to the half it keeps updating
+	const auto full_frees = all_instrs.select_all<free_instruction_record>(
+	    [&](const free_instruction_record& finstr) { return on_device(finstr.allocation_id.get_memory_id()) && finstr.size == full_bytes; });
+	CHECK(full_frees.count() == num_devices);
+	for(const auto& full_free : full_frees.iterate()) {
+		const auto compaction_copy = full_free.predecessors().select_unique<copy_instruction_record>(
+		    [&](const copy_instruction_record& copy) { return copy.source_allocation.id == full_free->allocation_id; });
+		CHECK(compaction_copy->origin == copy_instruction_record::copy_origin::resize);
+		CHECK(compaction_copy->copy_region.get_area() == test_range.size() / num_devices);
+		CHECK(compaction_copy->dest_box.get_area() == test_range.size() / num_devices);
+		CHECK(full_free.successors().select_all<horizon_instruction_record>().count() == 1);
+	}
+
+	// sum of all device allocations made and not yet freed before instruction `iid`
+	const auto device_footprint_before = [&](const instruction_id iid) {
+		size_t bytes = 0;
+		for(const auto& alloc : all_instrs.select_all<alloc_instruction_record>().iterate()) {
+			if(alloc->id < iid && on_device(alloc->allocation_id.get_memory_id())) { bytes += alloc->size_bytes; }
+		}
+		for(const auto& finstr : all_instrs.select_all<free_instruction_record>().iterate()) {
+			if(finstr->id < iid && on_device(finstr->allocation_id.get_memory_id())) { bytes -= finstr->size; }
+		}
+		return bytes;
+	};
+	const auto last_instruction_id = [](const auto& query) {
+		instruction_id last = 0;
+		for(const auto& instr : query.iterate()) {
+			last = std::max(last, instr->id);
+		}
+		return last;
+	};
+	CHECK(device_footprint_before(last_instruction_id(all_instrs.select_all<device_kernel_instruction_record>("read all"))) == num_devices * full_bytes);
+	CHECK(device_footprint_before(last_instruction_id(all_instrs.select_all<device_kernel_instruction_record>("update"))) == full_bytes);
+}
+
+TEST_CASE("horizons compact disconnected live regions with overlapping bounding boxes into one allocation",
+    "[instruction_graph_generator][instruction-graph][memory]") {
+	const range<2> test_range = {1024, 1024}; // the full allocation is larger than the compaction threshold
+	const auto full_bytes = test_range.size() * sizeof(float);
+
+	// two interleaved L-shapes that do not touch, but whose bounding boxes [0, 64)² and [16, 64)² overlap
+	const std::vector<subrange<2>> live_boxes{
+	    {{0, 0}, {64, 8}},
+	    {{0, 0}, {8, 64}},
+	    {{56, 16}, {8, 48}},
+	    {{16, 56}, {48, 8}},
+	};
+	// the complement of both L-shapes in the buffer
+	const std::vector<subrange<2>> stale_boxes{
+	    {{64, 0}, {960, 1024}},
+	    {{0, 64}, {64, 960}},
+	    {{8, 8}, {8, 56}},
+	    {{16, 8}, {40, 48}},
+	    {{56, 8}, {8, 8}},
+	};
+
+	test_utils::idag_test_context ictx(1 /* nodes */, 0 /* my nid */, 1 /* devices */);
+	ictx.set_horizon_step(1);
+	auto buf = ictx.create_buffer(test_range);
+	ictx.device_compute(test_range).name("init").discard_write(buf, acc::one_to_one()).submit();
+	// after the next horizon, the device only holds the L-shapes up-to-date, and nothing has accessed its allocation since
+	ictx.master_node_host_task()
+	    .name("overwrite")
+	    .discard_write(buf, acc::fixed<2>(stale_boxes[0]))
+	    .discard_write(buf, acc::fixed<2>(stale_boxes[1]))
+	    .discard_write(buf, acc::fixed<2>(stale_boxes[2]))
+	    .discard_write(buf, acc::fixed<2>(stale_boxes[3]))
+	    .discard_write(buf, acc::fixed<2>(stale_boxes[4]))
+	    .submit();
+	ictx.finish();
+
+	const auto all_instrs = ictx.query_instructions();
+	const auto on_device = [](const memory_id mid) { return mid >= first_device_memory_id; };
+
+	const auto full_free = all_instrs.select_unique<free_instruction_record>(
+	    [&](const free_instruction_record& finstr) { return on_device(finstr.allocation_id.get_memory_id()) && finstr.size == full_bytes; });
+
+	// a single allocation covers both L-shapes instead of one (overlapping) allocation per shape
+	const auto compacted_allocs = all_instrs.select_all<alloc_instruction_record>([&](const alloc_instruction_record& ainstr) {
+		return on_device(ainstr.allocation_id.get_memory_id()) && ainstr.size_bytes < full_bytes;
+	});
+	REQUIRE(compacted_allocs.count() == 1);
+	const auto compacted_alloc = compacted_allocs[0];
+	REQUIRE(compacted_alloc->buffer_allocation.has_value());
+	CHECK(compacted_alloc->buffer_allocation->box == box<3>({0, 0, 0}, {64, 64, 1}));
+
+	region<3> live_region;
+	for(const auto& sr : live_boxes) {
+		live_region = region_union(live_region, region<3>(box<3>(subrange_cast<3>(sr))));
+	}
+	const auto compaction_copy = full_free.predecessors().select_unique<copy_instruction_record>(
+	    [&](const copy_instruction_record& copy) { return copy.source_allocation.id == full_free->allocation_id; });
+	CHECK(compaction_copy->origin == copy_instruction_record::copy_origin::resize);
+	CHECK(compaction_copy->dest_allocation.id == compacted_alloc->allocation_id);
+	CHECK(compaction_copy->copy_region == live_region);
+}
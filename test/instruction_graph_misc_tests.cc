@@ -726,3 +726,156 @@ TEST_CASE("instruction_graph_generator gracefully handles unsafe oversubscriptio
 	const auto all_instrs = ictx.query_instructions();
 	CHECK(all_instrs.count<device_kernel_instruction_record>() + all_instrs.count<host_task_instruction_record>() == 1);
 }
+
+TEST_CASE("instructions on the critical path of a command receive higher priorities", "[instruction_graph_generator][instruction-graph]") {
+	// no cost model is passed explicitly, so the generator falls back to a static_cost_model
+	test_utils::idag_test_context ictx(1 /* num nodes */, 0 /* local nid */, 2 /* num devices */);
+	const size_t buffer_size = 1 << 20;
+	auto buf = ictx.create_buffer(range(buffer_size));
+	ictx.master_node_host_task().name("init").discard_write(buf, acc::all()).submit();
+	// both chunks execute the same number of kernel items, but the first one needs to copy almost the entire buffer to its device
+	ictx.device_compute(range(256))
+	    .name("reader")
+	    .read(buf, [=](const chunk<1>& ck) { return ck.offset[0] == 0 ? subrange<1>(0, buffer_size - 16) : subrange<1>(buffer_size - 16, 16); })
+	    .submit();
+	ictx.finish();
+
+	const auto all_instrs = ictx.query_instructions();
+	const auto all_copies = all_instrs.select_all<copy_instruction_record>();
+	const auto all_kernels = all_instrs.select_all<device_kernel_instruction_record>("reader");
+	REQUIRE(all_copies.count() == 2);
+	REQUIRE(all_kernels.count() == 2);
+
+	const auto copy_of_area = [](const size_t area) { return [=](const copy_instruction_record& copy) { return copy.copy_region.get_area() == area; }; };
+	const auto large_copy = all_copies.select_unique(copy_of_area(buffer_size - 16));
+	const auto small_copy = all_copies.select_unique(copy_of_area(16));
+	CHECK(large_copy->estimated_duration > small_copy->estimated_duration);
+	CHECK(large_copy->priority > small_copy->priority);
+
+	// the critical path only breaks ties between instructions of the same type
+	for(const auto& kernel : all_kernels.iterate()) {
+		CHECK(kernel->estimated_duration > std::chrono::nanoseconds(0));
+		CHECK(kernel->priority > large_copy->priority);
+	}
+	CHECK(all_kernels.select_unique(device_id(0))->priority == all_kernels.select_unique(device_id(1))->priority);
+}
+
+TEST_CASE("instruction_graph_generator derives critical-path priorities from the provided cost model", "[instruction_graph_generator][instruction-graph]") {
+	using namespace std::chrono_literals;
+
+	// an (unrealistic) cost model under which the smaller of two copies is the expensive one
+	struct small_copies_are_slow_cost_model final : cost_model {
+		std::chrono::nanoseconds estimate(const instruction& instr) const override {
+			const auto copy = dynamic_cast<const copy_instruction*>(&instr);
+			return copy != nullptr && copy->get_copy_region().get_area() < 256 ? 1ms : 0ns;
+		}
+	};
+	const small_copies_are_slow_cost_model costs;
+	test_utils::idag_test_context::policy_set policy;
+	policy.costs = &costs;
+
+	test_utils::idag_test_context ictx(1 /* num nodes */, 0 /* local nid */, 2 /* num devices */, true /* supports d2d copies */, policy);
+	auto buf = ictx.create_buffer(range(1024));
+	ictx.master_node_host_task().name("init").discard_write(buf, acc::all()).submit();
+	ictx.device_compute(range(256))
+	    .name("reader")
+	    .read(buf, [](const chunk<1>& ck) { return ck.offset[0] == 0 ? subrange<1>(0, 1000) : subrange<1>(1000, 24); })
+	    .submit();
+	ictx.finish();
+
+	const auto all_copies = ictx.query_instructions().select_all<copy_instruction_record>();
+	REQUIRE(all_copies.count() == 2);
+	const auto copy_of_area = [](const size_t area) { return [=](const copy_instruction_record& copy) { return copy.copy_region.get_area() == area; }; };
+	const auto large_copy = all_copies.select_unique(copy_of_area(1000));
+	const auto small_copy = all_copies.select_unique(copy_of_area(24));
+	CHECK(small_copy->estimated_duration == 1ms);
+	CHECK(large_copy->estimated_duration == 0ns);
+	CHECK(small_copy->priority > large_copy->priority);
+}
+
+TEST_CASE("calibrated_cost_model scales observed kernel run times with the execution range", "[instruction_graph_generator][instruction-graph]") {
+	using namespace std::chrono_literals;
+
+	const auto make_kernel = [](const device_kernel_launcher& launcher, const size_t size) {
+		return device_kernel_instruction(instruction_id(0), 0 /* priority */, device_id(0), launcher, box<3>({0, 0, 0}, {size, 1, 1}),
+		    buffer_access_allocation_map{}, buffer_access_allocation_map {} CELERITY_DETAIL_IF_ACCESSOR_BOUNDARY_CHECK(, task_id(0), "task"));
+	};
+	const device_kernel_launcher calibrated_launcher = [](sycl::handler&, const box<3>&, const std::vector<void*>&) {};
+	const device_kernel_launcher other_launcher = [](sycl::handler&, const box<3>&, const std::vector<void*>&) {};
+
+	calibrated_cost_model costs;
+	const auto small = make_kernel(calibrated_launcher, 1000);
+	const auto large = make_kernel(calibrated_launcher, 4000);
+	const auto other = make_kernel(other_launcher, 1000);
+	const auto uncalibrated = costs.estimate(other);
+
+	costs.observe(small, 1ms);
+	CHECK(costs.get_num_calibrated_kernels() == 1);
+	CHECK(costs.estimate(small) == 1ms);
+	CHECK(costs.estimate(large) == 4ms);
+	CHECK(costs.estimate(other) == uncalibrated);
+
+	// later observations are blended into the per-item estimate
+	costs.observe(large, 8ms);
+	CHECK(costs.estimate(small) == 1250us);
+}
+
+TEST_CASE("instruction_graph_generator reports the size of its tracking structures", "[instruction_graph_generator][instruction-graph]") {
+	test_utils::idag_test_context ictx(1 /* num nodes */, 0 /* local nid */, 2 /* num devices */);
+	auto buf = ictx.create_buffer(range(256));
+	ictx.device_compute(range(256)).discard_write(buf, acc::one_to_one()).submit();
+
+	const auto stats = ictx.get_instruction_graph_generator().get_state_statistics();
+	CHECK(stats.num_buffers == 1);
+	CHECK(stats.num_allocations == 2); // one per device
+	// three buffer-wide maps plus last writers and last concurrent accesses of each allocation
+	CHECK(stats.num_region_map_entries >= 3 + 2 * stats.num_allocations);
+	CHECK(stats.num_access_front_instructions >= 2 * stats.num_allocations);
+	CHECK(stats.approximate_bytes > 0);
+
+	ictx.finish();
+
+	const auto final_stats = ictx.get_instruction_graph_generator().get_state_statistics();
+	CHECK(final_stats.num_buffers == 0);
+	CHECK(final_stats.num_region_map_entries == 0);
+}
+
+TEST_CASE("instruction_graph destroys the instructions of pruned epochs in place", "[instruction_graph][instruction-graph][compaction]") {
+	constexpr size_t num_epochs = 6;
+	constexpr size_t instructions_per_epoch = 3;
+
+	instruction_graph idag;
+	instruction_id next_iid = 0;
+	std::vector<const horizon_instruction*> last_horizons;
+	for(task_id tid = 0; tid < num_epochs; ++tid) {
+		idag.begin_epoch(tid);
+		for(size_t i = 0; i < instructions_per_epoch; ++i) {
+			// instruction_garbage owns heap memory, so destroying an instruction after its arena has been released would be caught by sanitizers
+			instruction_garbage garbage{{reduction_id(tid)}, std::vector<allocation_id>(16, allocation_id(host_memory_id, raw_allocation_id(1)))};
+			last_horizons.push_back(idag.create_instruction<horizon_instruction>(next_iid++, 0 /* priority */, tid, std::move(garbage)));
+		}
+	}
+	CHECK(idag.get_live_epoch_count() == num_epochs);
+	CHECK(idag.get_live_instruction_count() == num_epochs * instructions_per_epoch);
+
+	// pruning the first few epochs leaves the remaining ones intact
+	idag.prune_before_epoch(task_id(3));
+	CHECK(idag.get_live_epoch_count() == num_epochs - 3);
+	CHECK(idag.get_live_instruction_count() == (num_epochs - 3) * instructions_per_epoch);
+	for(size_t i = 3 * instructions_per_epoch; i < last_horizons.size(); ++i) {
+		const auto tid = task_id(i / instructions_per_epoch);
+		CHECK(last_horizons[i]->get_horizon_task_id() == tid);
+		CHECK(last_horizons[i]->get_garbage().reductions == std::vector{reduction_id(tid)});
+		CHECK(last_horizons[i]->get_garbage().user_allocations.size() == 16);
+	}
+
+	// pruning before the current epoch is a no-op, and retained epochs can still receive instructions
+	idag.prune_before_epoch(task_id(3));
+	CHECK(idag.get_live_epoch_count() == num_epochs - 3);
+	idag.begin_epoch(task_id(num_epochs));
+	idag.create_instruction<horizon_instruction>(next_iid++, 0 /* priority */, task_id(num_epochs), instruction_garbage{});
+
+	idag.prune_before_epoch(task_id(num_epochs));
+	CHECK(idag.get_live_epoch_count() == 1);
+	CHECK(idag.get_live_instruction_count() == 1);
+}
@@ -224,6 +224,121 @@ TEST_CASE("an await-push of disconnected subregions does not allocate their boun
 	CHECK(reader.predecessors() == all_recvs);
 }
 
+TEST_CASE("receives read by a single device are staged in a dense host allocation and scattered into device memory",
+    "[instruction_graph_generator][instruction-graph][p2p]") //
+{
+	test_utils::idag_test_context ictx(2 /* nodes */, 0 /* my nid */, 1 /* devices */);
+	auto buf = ictx.create_buffer(range<2>(256, 256));
+	ictx.device_compute(buf.get_range()).name("writer").discard_write(buf, acc::one_to_one()).submit();
+	ictx.device_compute(buf.get_range()).name("reader").read(buf, test_utils::access::make_neighborhood<2>(1)).submit();
+	ictx.finish();
+
+	const auto all_instrs = ictx.query_instructions();
+	const auto recv = all_instrs.select_unique<receive_instruction_record>();
+	const auto reader = all_instrs.select_unique<device_kernel_instruction_record>("reader");
+
+	// the halo is received into a host staging allocation that spans exactly the received box, so the communicator never needs to stride
+	CHECK(recv->dest_allocation_id.get_memory_id() == host_memory_id);
+	CHECK(region(recv->allocated_box) == recv->requested_region);
+	const auto staging_alloc = recv.predecessors().select_unique<alloc_instruction_record>();
+	CHECK(staging_alloc->origin == alloc_instruction_record::alloc_origin::staging);
+	CHECK(staging_alloc->allocation_id == recv->dest_allocation_id);
+	// the executor serves staging allocations from its staging pool, but must allocate buffer memory regularly
+	CHECK(staging_alloc->is_staging);
+	CHECK(all_instrs.select_all<alloc_instruction_record>().count([](const alloc_instruction_record& ainstr) { return ainstr.is_staging; }) == 1);
+
+	// a single copy scatters the staged halo into the device allocation that the reader accesses
+	const auto scatter = recv.successors().select_unique<copy_instruction_record>();
+	CHECK(scatter->origin == copy_instruction_record::copy_origin::staging);
+	CHECK(scatter->source_allocation.id == recv->dest_allocation_id);
+	CHECK(scatter->dest_allocation.id.get_memory_id() == ictx.get_native_memory(device_id(0)));
+	CHECK(scatter->copy_region == recv->requested_region);
+	CHECK(scatter.successors().contains(reader));
+
+	// the staging allocation is freed after the scatter, and the received data never occupies a host buffer allocation
+	const auto staging_free = scatter.successors().select_unique<free_instruction_record>();
+	CHECK(staging_free->allocation_id == staging_alloc->allocation_id);
+	CHECK(all_instrs
+	          .select_all<alloc_instruction_record>([](const alloc_instruction_record& ainstr) {
+		          return ainstr.origin == alloc_instruction_record::alloc_origin::buffer && ainstr.allocation_id.get_memory_id() == host_memory_id;
+	          })
+	          .count()
+	      == 0);
+}
+
+TEST_CASE("strided sends are linearized into pooled staging allocations", "[instruction_graph_generator][instruction-graph][p2p]") {
+	test_utils::idag_test_context ictx(2 /* nodes */, 0 /* my nid */, 1 /* devices */);
+	auto buf = ictx.create_buffer(range<2>(256, 256));
+	const auto column_block = subrange<2>({0, 64}, {256, 128});
+	ictx.host_task(range(1)).name("writer").discard_write(buf, acc::all()).submit(); // on the local node only
+	ictx.host_task(range(2)).name("reader").read(buf, acc::fixed(column_block)).submit();
+	ictx.finish();
+
+	const auto all_instrs = ictx.query_instructions();
+	const auto writer = all_instrs.select_unique<host_task_instruction_record>("writer");
+	const auto linearize = all_instrs.select_unique<linearize_instruction_record>();
+	const auto send = all_instrs.select_unique<send_instruction_record>();
+
+	// the column block is strided within the full-buffer host allocation of the writer, so it is packed before sending
+	REQUIRE(writer->access_map.size() == 1);
+	CHECK(linearize->source_allocation_id == writer->access_map.front().allocation_id);
+	CHECK(linearize->offset_in_source_allocation == id_cast<3>(column_block.offset));
+	CHECK(linearize->linearize_range == range_cast<3>(column_block.range));
+	CHECK(writer.successors().contains(linearize));
+
+	// the send transmits the staging allocation as a whole
+	CHECK(send->source_allocation_id == linearize->staging_allocation_id);
+	CHECK(send->source_allocation_range == send->send_range);
+	CHECK(send->offset_in_source_allocation == zeros);
+	CHECK(send->offset_in_buffer == id_cast<3>(column_block.offset));
+	CHECK(linearize.successors().contains(send));
+
+	// the staging allocation comes from the executor's pool and is returned to it after the send has completed
+	CHECK(all_instrs.select_all<alloc_instruction_record>([&](const alloc_instruction_record& ainstr) {
+		                return ainstr.allocation_id == linearize->staging_allocation_id;
+	                }).count()
+	      == 0);
+	const auto staging_free = send.successors().select_unique<free_instruction_record>();
+	CHECK(staging_free->allocation_id == linearize->staging_allocation_id);
+}
+
+TEST_CASE("repeated sends of the same box share a recurring message id and are ordered", "[instruction_graph_generator][instruction-graph][p2p]") {
+	constexpr size_t num_iterations = 3;
+
+	test_utils::idag_test_context ictx(2 /* nodes */, 0 /* my nid */, 1 /* devices */);
+	auto buf = ictx.create_buffer(range<1>(256));
+	for(size_t i = 0; i < num_iterations; ++i) {
+		ictx.device_compute(buf.get_range()).name("writer").discard_write(buf, acc::one_to_one()).submit();
+		ictx.device_compute(buf.get_range()).name("reader").read(buf, acc::all()).submit();
+	}
+	ictx.finish();
+
+	const auto all_sends = ictx.query_instructions().select_all<send_instruction_record>();
+	REQUIRE(all_sends.count() == num_iterations);
+
+	// the first send does not know that it will recur, all later ones re-use the same recurring id
+	CHECK_FALSE(is_recurring_message_id(all_sends[0]->message_id));
+	CHECK(is_recurring_message_id(all_sends[1]->message_id));
+	CHECK(all_sends[2]->message_id == all_sends[1]->message_id);
+
+	// every repetition waits for the previous send on the same id, so the communicator never has two of its messages in flight
+	CHECK(all_sends[1].predecessors().contains(all_sends[0]));
+	CHECK(all_sends[2].predecessors().contains(all_sends[1]));
+
+	// pilots announce the recurring id to the receiver
+	const auto pilots = ictx.query_outbound_pilots();
+	CHECK(pilots.count() == num_iterations);
+	CHECK(pilots.count([&](const outbound_pilot& pilot) { return pilot.message.id == all_sends[1]->message_id; }) == num_iterations - 1);
+
+	// ... and number the repetitions so that the receiver can issue its receives in send order even if the pilots overtake each other
+	for(size_t sequence = 0; sequence < num_iterations - 1; ++sequence) {
+		CAPTURE(sequence);
+		CHECK(pilots.count([&](const outbound_pilot& pilot) {
+			return pilot.message.id == all_sends[1]->message_id && pilot.message.sequence == sequence;
+		}) == 1);
+	}
+}
+
 TEST_CASE("transfers on huge buffers are split into boxes with communicator-compatible strides", "[instruction_graph_generator][instruction-graph][p2p]") {
 	constexpr size_t small_extent = 4096;
 	constexpr size_t max_extent = INT_MAX;
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "cost_model.h"
 #include "distributed_graph_generator_test_utils.h"
 #include "instruction_graph_generator.h"
 
@@ -490,6 +491,8 @@ class idag_test_context {
 		task_manager::policy_set tm;
 		distributed_graph_generator::policy_set dggen;
 		instruction_graph_generator::policy_set iggen;
+		const cost_model* costs = nullptr; ///< must outlive the context
+		size_t device_memory_capacity = std::numeric_limits<size_t>::max();
 	};
 
 	idag_test_context(
@@ -497,8 +500,8 @@ class idag_test_context {
 	    : m_num_nodes(num_nodes), m_local_nid(local_nid), m_num_devices_per_node(num_devices_per_node),
 	      m_uncaught_exceptions_before(std::uncaught_exceptions()), m_tm(num_nodes, nullptr /* host_queue */, &m_task_recorder, policy.tm), m_cmd_recorder(),
 	      m_cdag(), m_dggen(num_nodes, local_nid, m_cdag, m_tm, &m_cmd_recorder, policy.dggen), m_instr_recorder(),
-	      m_iggen(m_tm, num_nodes, local_nid, make_system_info(num_devices_per_node, supports_d2d_copies), m_idag, nullptr /* delegate */, &m_instr_recorder,
-	          policy.iggen) //
+	      m_iggen(m_tm, num_nodes, local_nid, make_system_info(num_devices_per_node, supports_d2d_copies, policy.device_memory_capacity), m_idag,
+	          nullptr /* delegate */, &m_instr_recorder, policy.iggen, policy.costs) //
 	{
 		REQUIRE(local_nid < num_nodes);
 		REQUIRE(num_devices_per_node > 0);
@@ -521,6 +524,7 @@ class idag_test_context {
 	void finish() {
 		if(m_finished) return;
 
+		flush_lookahead_window();
 		for(auto iter = m_managed_objects.rbegin(); iter != m_managed_objects.rend(); ++iter) {
 			matchbox::match(
 			    *iter,
@@ -620,10 +624,16 @@ class idag_test_context {
 
 	void set_horizon_step(const int step) { m_tm.set_horizon_step(step); }
 
+	/// Mimics the scheduler lookahead: Commands are anticipated immediately, but only compiled once the commands of more than `num_tasks` tasks are held
+	/// back, or a horizon, epoch or fence is built.
+	void set_lookahead(const size_t num_tasks) { m_lookahead = num_tasks; }
+
 	task_manager& get_task_manager() { return m_tm; }
 
 	distributed_graph_generator& get_graph_generator() { return m_dggen; }
 
+	const instruction_graph_generator& get_instruction_graph_generator() const { return m_iggen; }
+
 	instruction_query<> query_instructions() const { return instruction_query<>(m_instr_recorder); }
 
 	pilot_query query_outbound_pilots() const { return pilot_query(m_instr_recorder); }
@@ -659,6 +669,8 @@ class idag_test_context {
 	instruction_recorder m_instr_recorder;
 	instruction_graph_generator m_iggen;
 	bool m_finished = false;
+	size_t m_lookahead = 0;
+	std::vector<std::vector<const abstract_command*>> m_lookahead_window;
 
 	allocation_id create_user_allocation() { return detail::allocation_id(detail::user_memory_id, m_next_user_allocation_id++); }
 
@@ -676,10 +688,25 @@ class idag_test_context {
 	void build_task(const task_id tid) {
 		if(m_finished) { FAIL("idag_test_context already finish()ed"); }
 		const uncaught_exception_guard guard(this);
-		const auto commands = detail::sort_topologically(m_dggen.build_task(*m_tm.get_task(tid)));
+		const auto tsk = m_tm.get_task(tid);
+		const auto commands = detail::sort_topologically(m_dggen.build_task(*tsk));
 		for(const auto cmd : commands) {
-			m_iggen.compile(*cmd);
+			if(m_lookahead > 0) { m_iggen.anticipate(*cmd); }
+		}
+		m_lookahead_window.push_back(commands);
+		if(tsk->get_type() == task_type::horizon || tsk->get_type() == task_type::epoch || tsk->get_type() == task_type::fence
+		    || m_lookahead_window.size() > m_lookahead) {
+			flush_lookahead_window();
+		}
+	}
+
+	void flush_lookahead_window() {
+		for(const auto& commands : m_lookahead_window) {
+			for(const auto cmd : commands) {
+				m_iggen.compile(*cmd);
+			}
 		}
+		m_lookahead_window.clear();
 	}
 
 	void maybe_build_horizon() {
@@ -108,33 +108,34 @@ class out_of_order_test_context {
 	explicit out_of_order_test_context(const size_t num_devices) : m_engine(test_utils::make_system_info(num_devices, true /* supports_d2d_copies */)) {}
 
 	const instruction* alloc(const std::vector<const instruction*>& dependencies, const memory_id mid, const int priority = 0) {
-		return create<alloc_instruction>(dependencies, priority, allocation_id(mid, 1), 1024, 1);
+		return create<alloc_instruction>(dependencies, priority, no_estimate, allocation_id(mid, 1), 1024, 1);
 	}
 
 	const instruction* free(const std::vector<const instruction*>& dependencies, const memory_id mid, const int priority = 0) {
-		return create<free_instruction>(dependencies, priority, allocation_id(mid, 1));
+		return create<free_instruction>(dependencies, priority, no_estimate, allocation_id(mid, 1));
 	}
 
-	const instruction* device_kernel(const std::vector<const instruction*>& dependencies, const device_id did, const int priority = 0) {
+	const instruction* device_kernel(const std::vector<const instruction*>& dependencies, const device_id did, const int priority = 0,
+	    const std::chrono::nanoseconds estimated_duration = {}) {
 		return create<device_kernel_instruction>(
-		    dependencies, priority, did, device_kernel_launcher{}, box<3>(), buffer_access_allocation_map{},
+		    dependencies, priority, estimated_duration, did, device_kernel_launcher{}, box<3>(), buffer_access_allocation_map{},
 		    buffer_access_allocation_map {} //
 		    CELERITY_DETAIL_IF_ACCESSOR_BOUNDARY_CHECK(, task_id(0), "task"));
 	}
 
 	const instruction* copy(const std::vector<const instruction*>& dependencies, const memory_id source, const memory_id dest, const int priority = 0) {
 		const box<3> box(id(0, 0, 0), id(1, 1, 1));
-		return create<copy_instruction>(dependencies, priority, allocation_id(source, 1), allocation_id(dest, 1), box, box, box, sizeof(int));
+		return create<copy_instruction>(dependencies, priority, no_estimate, allocation_id(source, 1), allocation_id(dest, 1), box, box, box, sizeof(int));
 	}
 
 	const instruction* host_task(const std::vector<const instruction*>& dependencies, const int priority = 0) {
 		return create<host_task_instruction>(
-		    dependencies, priority, host_task_launcher{}, box<3>(), range<3>(), buffer_access_allocation_map{},
+		    dependencies, priority, no_estimate, host_task_launcher{}, box<3>(), range<3>(), buffer_access_allocation_map{},
 		    collective_group_id {} CELERITY_DETAIL_IF_ACCESSOR_BOUNDARY_CHECK(, task_id(0), "task"));
 	}
 
 	const instruction* epoch(const std::vector<const instruction*>& dependencies, const int priority = 0) {
-		return create<epoch_instruction>(dependencies, priority, task_id(0), epoch_action::none, instruction_garbage{});
+		return create<epoch_instruction>(dependencies, priority, no_estimate, task_id(0), epoch_action::none, instruction_garbage{});
 	}
 
 	void complete(const instruction* instr) { m_engine.complete_assigned(instr); }
@@ -180,10 +181,14 @@ class out_of_order_test_context {
 	std::vector<std::unique_ptr<instruction>> m_instrs;
 	out_of_order_engine m_engine;
 
+	constexpr static std::chrono::nanoseconds no_estimate{0};
+
 	template <typename Instruction, typename... CtorParams>
-	const instruction* create(const std::vector<const instruction*>& dependencies, const int priority, const CtorParams&... ctor_args) {
+	const instruction* create(const std::vector<const instruction*>& dependencies, const int priority, const std::chrono::nanoseconds estimated_duration,
+	    const CtorParams&... ctor_args) {
 		const auto iid = m_next_iid++;
 		const auto instr = m_instrs.emplace_back(std::make_unique<Instruction>(iid, priority, ctor_args...)).get();
+		instr->set_estimated_duration(estimated_duration);
 		for(const auto dep : dependencies) {
 			instr->add_dependency(dep->get_id());
 		}
@@ -410,6 +415,27 @@ TEST_CASE("concurrent instructions are assigned in decreasing priority", "[out_o
 	CHECK(third->instruction == k1);
 }
 
+TEST_CASE("concurrent instructions of equal priority are assigned in decreasing estimated duration", "[out_of_order_engine]") {
+	using namespace std::chrono_literals;
+
+	out_of_order_test_context octx(1);
+	auto short_kernel = octx.device_kernel({}, device_id(0), /* priority */ 1, /* estimated duration */ 10us);
+	auto long_kernel = octx.device_kernel({}, device_id(0), /* priority */ 1, /* estimated duration */ 1ms);
+	auto urgent_kernel = octx.device_kernel({}, device_id(0), /* priority */ 2, /* estimated duration */ 1us);
+
+	const auto first = octx.assign_one();
+	REQUIRE(first.has_value());
+	CHECK(first->instruction == urgent_kernel);
+
+	const auto second = octx.assign_one();
+	REQUIRE(second.has_value());
+	CHECK(second->instruction == long_kernel);
+
+	const auto third = octx.assign_one();
+	REQUIRE(third.has_value());
+	CHECK(third->instruction == short_kernel);
+}
+
 TEST_CASE("eagerly-assignable instructions become immediately assignable once their predecessors complete", "[out_of_order_engine]") {
 	out_of_order_test_context octx(1);
 	auto k1 = octx.device_kernel({}, device_id(0), /* priority */ 0);
@@ -3,6 +3,7 @@
 #include "test_utils.h"
 
 #include <algorithm>
+#include <deque>
 #include <map>
 
 #include <catch2/catch_test_macros.hpp>
@@ -12,6 +13,14 @@
 using namespace celerity;
 using namespace celerity::detail;
 
+namespace celerity::detail {
+
+struct receive_arbiter_testspy {
+	static size_t get_num_recurring_channels(const receive_arbiter& ra) { return ra.m_recurring_receive_channels.size(); }
+};
+
+} // namespace celerity::detail
+
 /// A mock communicator implementation that allows tests to manually push inbound pilots and incoming receive payloads that the receive_arbiter is waiting for.
 class mock_recv_communicator : public communicator {
   public:
@@ -38,10 +47,11 @@ class mock_recv_communicator : public communicator {
 	}
 
 	[[nodiscard]] async_event receive_payload(const node_id from, const message_id msgid, void* const base, const stride& stride) override {
-		const auto key = std::pair(from, msgid);
-		REQUIRE(m_pending_recvs.count(key) == 0);
+		// Like MPI, we match receives with the same recurring message id to incoming payloads in the order they were issued
+		auto& pending = m_pending_recvs[std::pair(from, msgid)];
+		REQUIRE((pending.empty() || is_recurring_message_id(msgid)));
 		completion_flag flag = std::make_shared<bool>(false);
-		m_pending_recvs.emplace(key, std::tuple(base, stride, flag));
+		pending.emplace_back(base, stride, flag);
 		return make_async_event<mock_event>(flag);
 	}
 
@@ -49,11 +59,19 @@ class mock_recv_communicator : public communicator {
 
 	void complete_receiving_payload(const node_id from, const message_id msgid, const void* const src, const range<3>& src_range) {
 		const auto key = std::pair(from, msgid);
-		const auto [dest, stride, flag] = m_pending_recvs.at(key);
+		auto& pending = m_pending_recvs.at(key);
+		const auto [dest, stride, flag] = pending.front();
 		REQUIRE(src_range == stride.transfer.range);
 		memcpy_strided_host(src, dest, stride.element_size, src_range, zeros, stride.allocation_range, stride.transfer.offset, stride.transfer.range);
 		*flag = true;
-		m_pending_recvs.erase(key);
+		pending.pop_front();
+		if(pending.empty()) { m_pending_recvs.erase(key); }
+	}
+
+	/// Returns the number of receives that have been issued for `(from, msgid)` but whose payload has not been delivered yet.
+	size_t get_num_pending_receives(const node_id from, const message_id msgid) const {
+		const auto it = m_pending_recvs.find(std::pair(from, msgid));
+		return it != m_pending_recvs.end() ? it->second.size() : 0;
 	}
 
 	std::unique_ptr<communicator> collective_clone() override { utils::panic("unimplemented"); }
@@ -74,7 +92,7 @@ class mock_recv_communicator : public communicator {
 	size_t m_num_nodes;
 	node_id m_local_nid;
 	std::vector<inbound_pilot> m_inbound_pilots;
-	std::unordered_map<std::pair<node_id, message_id>, std::tuple<void*, stride, completion_flag>, utils::pair_hash> m_pending_recvs;
+	std::unordered_map<std::pair<node_id, message_id>, std::deque<std::tuple<void*, stride, completion_flag>>, utils::pair_hash> m_pending_recvs;
 };
 
 /// Instructs the test loop to perform a specific operation on receive_arbiter or mock_recv_communicator in order to execute tests in all possible event orders
@@ -537,3 +555,98 @@ TEST_CASE("receive_arbiter knows how to handle empty pilot boxes in gathers", "[
 	// only a single chunk, `1`, is actually written to `allocation`
 	CHECK(allocation == std::vector{-1, 1, -1});
 }
+
+TEST_CASE("receive_arbiter issues receives with the same recurring message id in the order of their sends", "[receive_arbiter]") {
+	// Two iterations of a halo exchange: the same peer sends the same box under the same recurring message id to two consecutive consumer tasks
+	static const std::vector<transfer_id> trids{transfer_id(task_id(1), buffer_id(0), no_reduction_id), transfer_id(task_id(2), buffer_id(0), no_reduction_id)};
+	static const box<3> unit_box{{0, 0, 0}, {1, 1, 1}};
+	static const node_id peer = 1;
+	static const message_id msgid = first_recurring_message_id;
+
+	const auto pilot_order = GENERATE(values<std::vector<size_t>>({{0, 1}, {1, 0}}));
+	CAPTURE(pilot_order);
+
+	mock_recv_communicator comm(2, 0);
+	receive_arbiter ra(comm);
+
+	std::vector<int> allocations[2] = {{-1}, {-1}};
+	std::vector<async_event> receives;
+	for(size_t sequence = 0; sequence < 2; ++sequence) {
+		receives.push_back(ra.receive(trids[sequence], region(unit_box), allocations[sequence].data(), unit_box, sizeof(int)));
+	}
+
+	// The second pilot may overtake the first one, in which case its receive must be held back
+	comm.push_inbound_pilot(inbound_pilot{peer, pilot_message{msgid, trids[pilot_order[0]], unit_box, pilot_order[0]}});
+	ra.poll_communicator();
+	CHECK(comm.get_num_pending_receives(peer, msgid) == (pilot_order[0] == 0 ? 1 : 0));
+
+	comm.push_inbound_pilot(inbound_pilot{peer, pilot_message{msgid, trids[pilot_order[1]], unit_box, pilot_order[1]}});
+	ra.poll_communicator();
+	CHECK(comm.get_num_pending_receives(peer, msgid) == 2);
+
+	// The communicator delivers payloads in send order, which must end up in the receive for the matching sequence number
+	for(int payload = 0; payload < 2; ++payload) {
+		comm.complete_receiving_payload(peer, msgid, &payload, unit_box.get_range());
+		ra.poll_communicator();
+	}
+	CHECK(receives[0].is_complete());
+	CHECK(receives[1].is_complete());
+	CHECK(allocations[0] == std::vector{0});
+	CHECK(allocations[1] == std::vector{1});
+}
+
+TEST_CASE("receive_arbiter forgets recurring message ids that have been idle for longer than senders retain them", "[receive_arbiter]") {
+	static const std::vector<transfer_id> trids{transfer_id(task_id(1), buffer_id(0), no_reduction_id), transfer_id(task_id(2), buffer_id(0), no_reduction_id),
+	    transfer_id(task_id(3), buffer_id(0), no_reduction_id)};
+	static const box<3> unit_box{{0, 0, 0}, {1, 1, 1}};
+	static const node_id peer = 1;
+	static const message_id idle_msgid = first_recurring_message_id;
+	static const message_id deferred_msgid = first_recurring_message_id + 1;
+
+	mock_recv_communicator comm(2, 0);
+	receive_arbiter ra(comm);
+
+	// the channel for `idle_msgid` sees a single receive
+	int idle_allocation = -1;
+	const auto idle_receive = ra.receive(trids[0], region(unit_box), &idle_allocation, unit_box, sizeof(int));
+	comm.push_inbound_pilot(inbound_pilot{peer, pilot_message{idle_msgid, trids[0], unit_box, 0}});
+	ra.poll_communicator();
+	const int idle_payload = 0;
+	comm.complete_receiving_payload(peer, idle_msgid, &idle_payload, unit_box.get_range());
+	ra.poll_communicator();
+	CHECK(idle_receive.is_complete());
+
+	// the channel for `deferred_msgid` receives the pilot for its second message first, which holds back the corresponding receive
+	std::vector<int> deferred_allocations{-1, -1};
+	const auto second_receive = ra.receive(trids[2], region(unit_box), &deferred_allocations[1], unit_box, sizeof(int));
+	comm.push_inbound_pilot(inbound_pilot{peer, pilot_message{deferred_msgid, trids[2], unit_box, 1}});
+	ra.poll_communicator();
+	CHECK(comm.get_num_pending_receives(peer, deferred_msgid) == 0);
+	CHECK(receive_arbiter_testspy::get_num_recurring_channels(ra) == 2);
+
+	for(size_t i = 0; i < receive_arbiter::recurring_channel_retention_epochs; ++i) {
+		ra.notify_epoch_reached();
+	}
+	CHECK(receive_arbiter_testspy::get_num_recurring_channels(ra) == 2);
+
+	// only the idle channel is forgotten, since the other one still has a deferred receive
+	ra.notify_epoch_reached();
+	CHECK(receive_arbiter_testspy::get_num_recurring_channels(ra) == 1);
+
+	const auto first_receive = ra.receive(trids[1], region(unit_box), &deferred_allocations[0], unit_box, sizeof(int));
+	comm.push_inbound_pilot(inbound_pilot{peer, pilot_message{deferred_msgid, trids[1], unit_box, 0}});
+	ra.poll_communicator();
+	CHECK(comm.get_num_pending_receives(peer, deferred_msgid) == 2);
+	for(int payload = 1; payload <= 2; ++payload) {
+		comm.complete_receiving_payload(peer, deferred_msgid, &payload, unit_box.get_range());
+		ra.poll_communicator();
+	}
+	CHECK(first_receive.is_complete());
+	CHECK(second_receive.is_complete());
+	CHECK(deferred_allocations == std::vector{1, 2});
+
+	for(size_t i = 0; i <= receive_arbiter::recurring_channel_retention_epochs; ++i) {
+		ra.notify_epoch_reached();
+	}
+	CHECK(receive_arbiter_testspy::get_num_recurring_channels(ra) == 0);
+}
@@ -1,4 +1,5 @@
 #include <random>
+#include <tuple>
 
 #if CELERITY_DETAIL_HAVE_CAIRO
 #include <cairo/cairo.h>
@@ -11,6 +12,7 @@
 
 #include <celerity.h>
 
+#include "interval_map.h"
 #include "ranges.h"
 #include "region_map.h"
 
@@ -821,3 +823,75 @@ TEMPLATE_TEST_CASE_SIG("update(<empty-box>) has no effect", "[region_map]", ((in
 	const auto unit_box = box_cast<3>(box<0>());
 	CHECK(rm.get_region_values(unit_box) == std::vector{std::pair{unit_box, 0}});
 }
+
+TEST_CASE("interval_map merges adjacent runs with the same value", "[region_map][interval_map]") {
+	constexpr size_t size = 128;
+	interval_map<int> im(size, -1);
+
+	const auto get_runs = [&](const size_t begin, const size_t end) {
+		std::vector<std::tuple<size_t, size_t, int>> runs;
+		im.for_each_in(begin, end, [&](const size_t b, const size_t e, const int v) { runs.emplace_back(b, e, v); });
+		return runs;
+	};
+	using runs = std::vector<std::tuple<size_t, size_t, int>>;
+
+	im.update(32, 64, 1);
+	im.update(96, 200, 2);
+	CHECK(im.get_num_entries() == 4);
+	CHECK(get_runs(0, size) == runs{{0, 32, -1}, {32, 64, 1}, {64, 96, -1}, {96, 128, 2}});
+	CHECK(get_runs(40, 100) == runs{{40, 64, 1}, {64, 96, -1}, {96, 100, 2}});
+
+	im.update(64, 96, 1);
+	CHECK(im.get_num_entries() == 3);
+	CHECK(get_runs(0, size) == runs{{0, 32, -1}, {32, 96, 1}, {96, 128, 2}});
+
+	im.update(48, 112, 3);
+	CHECK(get_runs(0, size) == runs{{0, 32, -1}, {32, 48, 1}, {48, 112, 3}, {112, 128, 2}});
+
+	im.apply_to_values([](const int v) { return v < 0 ? v : 0; });
+	CHECK(im.get_num_entries() == 2);
+	CHECK(get_runs(0, size) == runs{{0, 32, -1}, {32, 128, 0}});
+
+	im.update(10, 10, 5);
+	im.update(size, size + 10, 5);
+	CHECK(get_runs(0, size) == runs{{0, 32, -1}, {32, 128, 0}});
+	CHECK(get_runs(size, size + 10).empty());
+}
+
+TEMPLATE_TEST_CASE_SIG("interval_or_region_map agrees with region_map", "[region_map][interval_map]", ((int Dims), Dims), 0, 1, 2) {
+	const auto extent = range_cast<3>(test_utils::truncate_range<Dims>({64, 8, 1}));
+	region_map<int> rm(extent, -1);
+	interval_or_region_map<int> irm(extent, -1);
+	CHECK(irm.is_interval_map() == (Dims <= 1));
+
+	std::mt19937 rng(42);
+	for(int i = 0; i < 200; ++i) {
+		id<3> min, max;
+		for(int d = 0; d < 3; ++d) {
+			const auto a = std::uniform_int_distribution<size_t>(0, extent[d])(rng);
+			const auto b = std::uniform_int_distribution<size_t>(0, extent[d])(rng);
+			min[d] = std::min(a, b);
+			max[d] = std::max(a, b);
+		}
+		const auto update = box<3>(min, max);
+		if(i % 50 == 49) {
+			rm.apply_to_values([](const int v) { return v / 2; });
+			irm.apply_to_values([](const int v) { return v / 2; });
+		} else {
+			rm.update_box(update, i);
+			irm.update_box(update, i);
+		}
+
+		// compare point by point, since both maps are free to split the results differently
+		for(size_t x = 0; x < extent[0]; ++x) {
+			for(size_t y = 0; y < extent[1]; ++y) {
+				const auto point = region<3>(box<3>({x, y, 0}, {x + 1, y + 1, 1}));
+				const auto expected = rm.get_region_values(point);
+				const auto actual = irm.get_region_values(point);
+				REQUIRE_LOOP(expected.size() == 1);
+				REQUIRE_LOOP(actual == expected);
+			}
+		}
+	}
+	if constexpr(Dims <= 1) { CHECK(irm.get_num_entries() <= rm.get_num_entries()); }
+}
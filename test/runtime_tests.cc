@@ -1531,5 +1531,57 @@ namespace detail {
 		CHECK(test_utils::log_contains_exact(log_level::warn, expected_warning_message) == CELERITY_ACCESS_PATTERN_DIAGNOSTICS);
 	}
 
+	const std::string live_executor_envvar_name = "CELERITY_LIVE_EXECUTOR";
+
+	TEST_CASE_METHOD(test_utils::runtime_fixture, "live executor runs kernels and host tasks on a single node", "[runtime][live-executor]") {
+		env::scoped_test_environment ste(std::unordered_map<std::string, std::string>{{live_executor_envvar_name, "1"}});
+
+		distr_queue q;
+		REQUIRE(runtime::get_instance().uses_live_executor());
+
+		buffer<int, 1> buf(range<1>(64));
+		q.submit([&](handler& cgh) {
+			accessor acc(buf, cgh, one_to_one(), write_only, no_init);
+			cgh.parallel_for<class UKN(init)>(buf.get_range(), [=](celerity::item<1> item) { acc[item] = static_cast<int>(item.get_linear_id()); });
+		});
+		q.submit([&](handler& cgh) {
+			accessor acc(buf, cgh, all(), read_write_host_task);
+			cgh.host_task(on_master_node, [=] {
+				for(size_t i = 0; i < 64; ++i) {
+					acc[i] *= 2;
+				}
+			});
+		});
+
+		const auto snapshot = q.fence(buf).get();
+		for(size_t i = 0; i < 64; ++i) {
+			REQUIRE_LOOP(snapshot[i] == static_cast<int>(2 * i));
+		}
+	}
+
+	TEST_CASE_METHOD(test_utils::runtime_fixture, "live executor reports exceptions from host tasks and proceeds with execution", "[runtime][live-executor]") {
+		env::scoped_test_environment ste(std::unordered_map<std::string, std::string>{{live_executor_envvar_name, "1"}});
+		test_utils::allow_max_log_level(detail::log_level::err);
+
+		experimental::host_object<int> ho{0};
+		distr_queue q;
+		REQUIRE(runtime::get_instance().uses_live_executor());
+
+		q.submit([&](handler& cgh) {
+			experimental::side_effect e(ho, cgh);
+			cgh.host_task(on_master_node, [=] {
+				(void)e;
+				throw std::runtime_error("host task failure");
+			});
+		});
+		q.submit([&](handler& cgh) {
+			experimental::side_effect e(ho, cgh);
+			cgh.host_task(on_master_node, [=] { *e = 1; });
+		});
+
+		CHECK(q.fence(ho).get() == 1);
+		CHECK(test_utils::log_contains_substring(log_level::err, "host task failure"));
+	}
+
 } // namespace detail
 } // namespace celerity
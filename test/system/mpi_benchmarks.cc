@@ -0,0 +1,129 @@
+#include "../test_utils.h"
+
+#include "communicator.h"
+#include "mpi_communicator.h"
+#include "types.h"
+
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include <catch2/catch_test_macros.hpp>
+
+
+using namespace celerity;
+using namespace celerity::detail;
+
+
+/// Sends `pilots_per_peer` pilots from every rank to every other rank in each of `num_rounds` rounds, either in one call to `send_outbound_pilots` per round
+/// or in one call to `send_outbound_pilot` per pilot, and waits until all pilots of the round have arrived from all peers before starting the next round.
+/// Returns the number of pilots received per second on the local rank.
+double measure_pilot_throughput(communicator& comm, const size_t pilots_per_peer, const size_t num_rounds, const bool coalesce) {
+	const auto num_nodes = comm.get_num_nodes();
+	const auto self = comm.get_local_node_id();
+
+	std::vector<outbound_pilot> pilots;
+	for(node_id peer = 0; peer < num_nodes; ++peer) {
+		if(peer == self) continue;
+		for(size_t i = 0; i < pilots_per_peer; ++i) {
+			pilots.push_back(outbound_pilot{peer, pilot_message{static_cast<message_id>(i), transfer_id(task_id(i), buffer_id(0), no_reduction_id),
+			                                          box<3>{id{i, 0, 0}, id{i + 1, 1, 1}}}});
+		}
+	}
+
+	comm.collective_barrier();
+	const auto start = std::chrono::steady_clock::now();
+
+	size_t num_received = 0;
+	for(size_t round = 0; round < num_rounds; ++round) {
+		if(coalesce) {
+			comm.send_outbound_pilots(pilots);
+		} else {
+			for(const auto& pilot : pilots) {
+				comm.send_outbound_pilot(pilot);
+			}
+		}
+		// faster peers may already have sent pilots for the next round, so we compare against the cumulative count
+		while(num_received < (round + 1) * pilots.size()) {
+			num_received += comm.poll_inbound_pilots().size();
+		}
+	}
+
+	const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	comm.collective_barrier(); // every rank has received all pilots, so no pilot of this measurement can leak into the next one
+	return static_cast<double>(num_received) / seconds;
+}
+
+// Hidden by default because it needs to be launched on several ranks, e.g. `mpirun -n 8 ./test/system/mpi_benchmarks "[group:pilots]"`. Results are
+// reported by rank 0, which exchanges pilots with all other ranks just like every rank does.
+TEST_CASE_METHOD(test_utils::mpi_fixture, "benchmark pilot throughput between all ranks", "[.][benchmark][group:pilots]") {
+	mpi_communicator comm(collective_clone_from, MPI_COMM_WORLD);
+	const auto num_nodes = comm.get_num_nodes();
+	if(num_nodes <= 1) { SKIP("benchmark must be run on at least 2 ranks"); }
+
+	constexpr size_t num_rounds = 1000;
+	for(const size_t pilots_per_peer : {1, 4, 16, 64, 256}) {
+		for(const bool coalesce : {false, true}) {
+			const auto pilots_per_second = measure_pilot_throughput(comm, pilots_per_peer, num_rounds, coalesce);
+			if(comm.get_local_node_id() == 0) {
+				const std::string_view mode = coalesce ? "coalesced" : "individual";
+				fmt::print("{} ranks, {} pilots per peer and round, {}: {:.0f} pilots/s received per rank\n", num_nodes, pilots_per_peer, mode,
+				    pilots_per_second);
+			}
+		}
+	}
+}
+
+/// Bounces a strided payload between ranks 0 and 1 for `num_round_trips` round trips, using either a fresh message id for every transfer (as for one-off
+/// sends) or the same recurring message id throughout (as for a halo exchange). Transfers cycle through `num_buffers` distinct buffers, like pooled staging
+/// allocations do. Returns the mean round-trip latency observed on rank 0.
+std::chrono::duration<double, std::micro> measure_payload_round_trip(
+    communicator& comm, const communicator::stride& stride, const size_t num_round_trips, const bool recurring, const size_t num_buffers) {
+	const auto self = comm.get_local_node_id();
+	const node_id peer = 1 - self;
+	std::vector<std::vector<std::byte>> buffers(num_buffers, std::vector<std::byte>(stride.allocation_range.size() * stride.element_size));
+
+	const auto wait = [](const async_event& evt) {
+		while(!evt.is_complete()) {}
+	};
+
+	comm.collective_barrier();
+	const auto start = std::chrono::steady_clock::now();
+	for(size_t i = 0; i < num_round_trips; ++i) {
+		const message_id ping = recurring ? first_recurring_message_id : message_id(2 * i);
+		const message_id pong = recurring ? first_recurring_message_id + 1 : message_id(2 * i + 1);
+		auto& buffer = buffers[i % num_buffers];
+		if(self == 0) {
+			wait(comm.send_payload(peer, ping, buffer.data(), stride));
+			wait(comm.receive_payload(peer, pong, buffer.data(), stride));
+		} else {
+			wait(comm.receive_payload(peer, ping, buffer.data(), stride));
+			wait(comm.send_payload(peer, pong, buffer.data(), stride));
+		}
+	}
+	const auto elapsed = std::chrono::steady_clock::now() - start;
+	comm.collective_barrier();
+	return std::chrono::duration<double, std::micro>(elapsed) / num_round_trips;
+}
+
+// Hidden by default because it needs to be launched on exactly 2 ranks, e.g. `mpirun -n 2 ./test/system/mpi_benchmarks "[group:recurring]"`. Every message
+// has the shape of one face of a cubic halo exchange.
+TEST_CASE_METHOD(test_utils::mpi_fixture, "benchmark payload latency of one-off and recurring transfers", "[.][benchmark][group:recurring]") {
+	mpi_communicator comm(collective_clone_from, MPI_COMM_WORLD);
+	if(comm.get_num_nodes() != 2) { SKIP("benchmark must be run on exactly 2 ranks"); }
+
+	constexpr size_t num_round_trips = 10000;
+	for(const size_t edge : {4, 16, 64, 256}) {
+		const communicator::stride face{range<3>(edge, edge, edge), subrange<3>(id<3>(0, 0, edge - 1), range<3>(edge, edge, 1)), sizeof(float)};
+		for(const bool recurring : {false, true}) {
+			for(const size_t num_buffers : {1, 2}) {
+				const auto latency = measure_payload_round_trip(comm, face, num_round_trips, recurring, num_buffers);
+				if(comm.get_local_node_id() == 0) {
+					const std::string_view mode = recurring ? "recurring" : "one-off";
+					fmt::print("{}^3 grid, face transfer, {} message ids, {} buffer(s): {:.2f} us per round trip\n", edge, mode, num_buffers, latency.count());
+				}
+			}
+		}
+	}
+}
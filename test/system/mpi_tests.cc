@@ -4,6 +4,9 @@
 #include "mpi_communicator.h"
 #include "types.h"
 
+#include <algorithm>
+#include <chrono>
+#include <random>
 #include <thread>
 
 #include <catch2/catch_test_macros.hpp>
@@ -19,8 +22,10 @@ namespace celerity::detail {
 
 struct mpi_communicator_testspy {
 	static size_t get_num_active_outbound_pilots(const mpi_communicator& comm) { return comm.m_outbound_pilots.size(); }
+	static MPI_Comm get_pilot_comm(const mpi_communicator& comm) { return comm.m_pilot_comm; }
 	static size_t get_num_cached_array_types(const mpi_communicator& comm) { return comm.m_array_type_cache.size(); }
 	static size_t get_num_cached_scalar_types(const mpi_communicator& comm) { return comm.m_scalar_type_cache.size(); }
+	static MPI_Datatype get_array_type(mpi_communicator& comm, const communicator::stride& stride) { return comm.get_array_type(stride); }
 };
 
 } // namespace celerity::detail
@@ -327,6 +332,259 @@ TEST_CASE("mpi_communicator normalizes strides to cache and re-uses MPI data typ
 	CHECK(mpi_communicator_testspy::get_num_cached_scalar_types(comm) == 1); // only scalar type used was int
 }
 
+TEST_CASE_METHOD(test_utils::mpi_fixture, "mpi_communicator evicts the least-recently used data type when its cache is full", "[mpi]") {
+	mpi_communicator comm(collective_clone_from, MPI_COMM_WORLD, 2 /* max cached array types */);
+
+	// strides that differ in the fastest dimension are not equivalent under normalization
+	const auto make_stride = [](const size_t width) { return communicator::stride{{4, 8, width}, {{0, 0, 0}, {4, 8, 1}}, sizeof(int)}; };
+	const auto a = mpi_communicator_testspy::get_array_type(comm, make_stride(2));
+	(void)mpi_communicator_testspy::get_array_type(comm, make_stride(3));
+	CHECK(mpi_communicator_testspy::get_array_type(comm, make_stride(2)) == a); // a is now more recently used than b
+	CHECK(comm.get_datatype_cache_metrics().evictions == 0);
+
+	(void)mpi_communicator_testspy::get_array_type(comm, make_stride(4)); // evicts b
+	CHECK(mpi_communicator_testspy::get_array_type(comm, make_stride(2)) == a);
+
+	const auto metrics = comm.get_datatype_cache_metrics();
+	CHECK(metrics.hits == 2);
+	CHECK(metrics.misses == 3);
+	CHECK(metrics.evictions == 1);
+	CHECK(metrics.num_cached_types == 2);
+
+	(void)mpi_communicator_testspy::get_array_type(comm, make_stride(3)); // b must be re-created
+	CHECK(comm.get_datatype_cache_metrics().misses == 4);
+}
+
+TEST_CASE_METHOD(test_utils::mpi_fixture, "mpi_communicator transfers remain correct under data type cache turnover", "[mpi]") {
+	constexpr size_t max_cached_array_types = 8;
+	constexpr size_t num_transfers = 200;
+
+	mpi_communicator comm(collective_clone_from, MPI_COMM_WORLD, max_cached_array_types);
+	const auto num_nodes = comm.get_num_nodes();
+	const auto self = comm.get_local_node_id();
+	CAPTURE(num_nodes, self);
+
+	if(num_nodes <= 1) { SKIP("test must be run on at least 2 ranks"); }
+	if(self >= 2) return; // needs exactly 2 nodes
+	const node_id peer = 1 - self;
+
+	// Both nodes draw the same sequence of strides, so that every send is matched by a receive with the same stride on the peer
+	std::mt19937 rng(42);
+	const auto random_extent = [&](const size_t min, const size_t max) { return std::uniform_int_distribution<size_t>(min, max)(rng); };
+
+	for(size_t i = 0; i < num_transfers; ++i) {
+		const message_id msgid(i);
+		communicator::stride stride;
+		stride.element_size = sizeof(int);
+		for(int d = 0; d < 3; ++d) {
+			stride.allocation_range[d] = random_extent(d == 2 ? 2 : 1, 6); // at least one effective dimension, so every transfer uses an array type
+			stride.transfer.range[d] = random_extent(1, stride.allocation_range[d]);
+			stride.transfer.offset[d] = random_extent(0, stride.allocation_range[d] - stride.transfer.range[d]);
+		}
+		CAPTURE(msgid, stride.allocation_range, stride.transfer);
+
+		std::vector<int> send_buf(stride.allocation_range.size());
+		std::iota(send_buf.begin(), send_buf.end(), static_cast<int>(i * 1000));
+		const auto send_evt = comm.send_payload(peer, msgid, std::as_const(send_buf).data(), stride);
+
+		std::vector<int> recv_buf(stride.allocation_range.size());
+		const auto recv_evt = comm.receive_payload(peer, msgid, recv_buf.data(), stride);
+
+		while(!send_evt.is_complete() || !recv_evt.is_complete()) {} // busy-wait for events to complete
+
+		std::vector<int> expected(stride.allocation_range.size());
+		test_utils::for_each_in_range(stride.transfer.range, stride.transfer.offset, [&](const id<3>& id) {
+			const auto linear_id = get_linear_index(stride.allocation_range, id);
+			expected[linear_id] = send_buf[linear_id];
+		});
+		REQUIRE(recv_buf == expected);
+	}
+
+	const auto metrics = comm.get_datatype_cache_metrics();
+	CHECK(metrics.hits + metrics.misses == 2 * num_transfers); // one lookup for each send and receive
+	CHECK(metrics.hits >= num_transfers);                      // each receive uses the same stride as the preceding send
+	CHECK(metrics.num_cached_types == max_cached_array_types);
+	CHECK(metrics.evictions == metrics.misses - metrics.num_cached_types);
+	CHECK(mpi_communicator_testspy::get_num_cached_array_types(comm) == max_cached_array_types);
+}
+
+TEST_CASE_METHOD(test_utils::mpi_fixture, "mpi_communicator re-starts persistent requests for recurring message ids", "[mpi]") {
+	constexpr size_t num_iterations = 10;
+
+	mpi_communicator comm(collective_clone_from, MPI_COMM_WORLD);
+	const auto num_nodes = comm.get_num_nodes();
+	const auto self = comm.get_local_node_id();
+	CAPTURE(num_nodes, self);
+
+	if(num_nodes <= 1) { SKIP("test must be run on at least 2 ranks"); }
+	if(self >= 2) return; // needs exactly 2 nodes
+	const node_id peer = 1 - self;
+
+	const message_id msgid = first_recurring_message_id + 7;
+	communicator::stride stride{range<3>(4, 4, 1), subrange<3>(id<3>(1, 1, 0), range<3>(2, 2, 1)), sizeof(int)};
+
+	std::vector<int> send_buf(stride.allocation_range.size());
+	std::vector<int> recv_buf(stride.allocation_range.size());
+	const auto transfer_and_check = [&](const size_t iteration) {
+		std::iota(send_buf.begin(), send_buf.end(), static_cast<int>(iteration * 1000));
+		std::fill(recv_buf.begin(), recv_buf.end(), -1);
+		const auto send_evt = comm.send_payload(peer, msgid, std::as_const(send_buf).data(), stride);
+		const auto recv_evt = comm.receive_payload(peer, msgid, recv_buf.data(), stride);
+		while(!send_evt.is_complete() || !recv_evt.is_complete()) {} // busy-wait for events to complete
+
+		std::vector<int> expected(stride.allocation_range.size(), -1);
+		test_utils::for_each_in_range(stride.transfer.range, stride.transfer.offset, [&](const id<3>& id) {
+			const auto linear_id = get_linear_index(stride.allocation_range, id);
+			expected[linear_id] = send_buf[linear_id];
+		});
+		REQUIRE(recv_buf == expected);
+	};
+
+	for(size_t i = 0; i < num_iterations; ++i) {
+		CAPTURE(i);
+		transfer_and_check(i);
+	}
+	auto metrics = comm.get_persistent_request_metrics();
+	CHECK(metrics.num_created == 2); // one send and one receive request
+	CHECK(metrics.num_restarted == 2 * (num_iterations - 1));
+
+	// a change of stride re-binds both requests
+	stride.transfer.offset = id<3>(2, 2, 0);
+	transfer_and_check(num_iterations);
+	metrics = comm.get_persistent_request_metrics();
+	CHECK(metrics.num_created == 4);
+	CHECK(metrics.num_restarted == 2 * (num_iterations - 1));
+
+	// non-recurring message ids never use persistent requests
+	const auto send_evt = comm.send_payload(peer, message_id(7), std::as_const(send_buf).data(), stride);
+	const auto recv_evt = comm.receive_payload(peer, message_id(7), recv_buf.data(), stride);
+	while(!send_evt.is_complete() || !recv_evt.is_complete()) {}
+	CHECK(comm.get_persistent_request_metrics().num_created == 4);
+}
+
+TEST_CASE_METHOD(test_utils::mpi_fixture, "mpi_communicator keeps persistent requests bound for recurring transfers alternating between buffers", "[mpi]") {
+	constexpr size_t num_iterations = 10;
+	constexpr size_t num_buffers = 2; // e.g. staging allocations handed out alternately by a pool
+
+	mpi_communicator comm(collective_clone_from, MPI_COMM_WORLD);
+	const auto num_nodes = comm.get_num_nodes();
+	const auto self = comm.get_local_node_id();
+	CAPTURE(num_nodes, self);
+
+	if(num_nodes <= 1) { SKIP("test must be run on at least 2 ranks"); }
+	if(self >= 2) return; // needs exactly 2 nodes
+	const node_id peer = 1 - self;
+
+	const message_id msgid = first_recurring_message_id;
+	const communicator::stride stride{range<3>(16, 1, 1), subrange<3>(zeros, range<3>(16, 1, 1)), sizeof(int)};
+
+	std::vector<std::vector<int>> send_bufs(num_buffers, std::vector<int>(16));
+	std::vector<std::vector<int>> recv_bufs(num_buffers, std::vector<int>(16));
+	for(size_t i = 0; i < num_iterations; ++i) {
+		CAPTURE(i);
+		auto& send_buf = send_bufs[i % num_buffers];
+		auto& recv_buf = recv_bufs[i % num_buffers];
+		std::fill(send_buf.begin(), send_buf.end(), static_cast<int>(i));
+		std::fill(recv_buf.begin(), recv_buf.end(), -1);
+		const auto send_evt = comm.send_payload(peer, msgid, std::as_const(send_buf).data(), stride);
+		const auto recv_evt = comm.receive_payload(peer, msgid, recv_buf.data(), stride);
+		while(!send_evt.is_complete() || !recv_evt.is_complete()) {}
+		REQUIRE(recv_buf == std::vector<int>(16, static_cast<int>(i)));
+	}
+
+	// one send and one receive request per buffer, all of which are re-started afterwards
+	const auto metrics = comm.get_persistent_request_metrics();
+	CHECK(metrics.num_created == 2 * num_buffers);
+	CHECK(metrics.num_restarted == 2 * (num_iterations - num_buffers));
+}
+
+TEST_CASE_METHOD(test_utils::mpi_fixture, "mpi_communicator serializes receives with the same recurring message id", "[mpi]") {
+	mpi_communicator comm(collective_clone_from, MPI_COMM_WORLD);
+	const auto num_nodes = comm.get_num_nodes();
+	const auto self = comm.get_local_node_id();
+	CAPTURE(num_nodes, self);
+
+	if(num_nodes <= 1) { SKIP("test must be run on at least 2 ranks"); }
+	if(self >= 2) return; // needs exactly 2 nodes
+
+	const message_id msgid = first_recurring_message_id;
+	const communicator::stride stride{range<3>(16, 1, 1), subrange<3>(zeros, range<3>(16, 1, 1)), sizeof(int)};
+
+	if(self == 0) {
+		// The second send is only issued once the first one has completed, as instruction_graph_generator would order it
+		for(int message = 0; message < 2; ++message) {
+			const std::vector<int> send_buf(16, message);
+			const auto send_evt = comm.send_payload(1, msgid, send_buf.data(), stride);
+			while(!send_evt.is_complete()) {}
+		}
+	} else {
+		// Both receives are issued before any message arrives, and into different buffers, so they cannot share a persistent request
+		std::vector<int> first(16, -1);
+		std::vector<int> second(16, -1);
+		const auto first_evt = comm.receive_payload(0, msgid, first.data(), stride);
+		const auto second_evt = comm.receive_payload(0, msgid, second.data(), stride);
+		while(!first_evt.is_complete() || !second_evt.is_complete()) {}
+		CHECK(first == std::vector<int>(16, 0));
+		CHECK(second == std::vector<int>(16, 1));
+		CHECK(comm.get_persistent_request_metrics().num_created == 2);
+	}
+}
+
+TEST_CASE_METHOD(test_utils::mpi_fixture, "mpi_communicator matches recurring sends that are pending before their receives in send order", "[mpi]") {
+	constexpr int num_messages = 2;
+
+	mpi_communicator comm(collective_clone_from, MPI_COMM_WORLD);
+	const auto num_nodes = comm.get_num_nodes();
+	const auto self = comm.get_local_node_id();
+	CAPTURE(num_nodes, self);
+
+	if(num_nodes <= 1) { SKIP("test must be run on at least 2 ranks"); }
+
+	const message_id msgid = first_recurring_message_id;
+	const communicator::stride stride{range<3>(16, 1, 1), subrange<3>(zeros, range<3>(16, 1, 1)), sizeof(int)};
+
+	std::vector<std::vector<int>> bufs(num_messages, std::vector<int>(16, -1));
+	std::vector<async_event> events;
+	if(self == 0) {
+		// Small standard-mode sends usually complete eagerly, so both messages will be pending at the receiver before it posts the first receive. We only
+		// wait for a bounded time though, since MPI is free to use a rendezvous protocol instead.
+		for(int message = 0; message < num_messages; ++message) {
+			std::fill(bufs[message].begin(), bufs[message].end(), message);
+			events.push_back(comm.send_payload(1, msgid, std::as_const(bufs[message]).data(), stride));
+		}
+		const auto deadline = std::chrono::steady_clock::now() + 100ms;
+		while(!std::all_of(events.begin(), events.end(), [](const async_event& evt) { return evt.is_complete(); })
+		      && std::chrono::steady_clock::now() < deadline) {}
+	}
+	comm.collective_barrier();
+	if(self == 1) {
+		for(int message = 0; message < num_messages; ++message) {
+			events.push_back(comm.receive_payload(0, msgid, bufs[message].data(), stride));
+		}
+	}
+	for(const auto& evt : events) {
+		while(!evt.is_complete()) {}
+	}
+
+	if(self == 1) {
+		for(int message = 0; message < num_messages; ++message) {
+			CAPTURE(message);
+			CHECK(bufs[message] == std::vector<int>(16, message));
+		}
+	}
+}
+
+TEST_CASE_METHOD(test_utils::mpi_fixture, "mpi_communicator exchanges pilots on a communicator separate from payloads", "[mpi]") {
+	mpi_communicator comm(collective_clone_from, MPI_COMM_WORLD);
+	const auto pilot_comm = mpi_communicator_testspy::get_pilot_comm(comm);
+	REQUIRE(pilot_comm != MPI_COMM_NULL);
+
+	// Both are duplicates of the same communicator, but must not share a tag namespace since only the payload communicator promises exact message lengths
+	int result = MPI_UNEQUAL;
+	MPI_Comm_compare(comm.get_native(), pilot_comm, &result);
+	CHECK(result == MPI_CONGRUENT);
+}
+
 TEST_CASE("successfully sent pilots are garbage-collected by communicator", "[mpi]") {
 	mpi_communicator comm(collective_clone_from, MPI_COMM_WORLD);
 	const auto num_nodes = comm.get_num_nodes();
@@ -358,3 +616,49 @@ TEST_CASE("successfully sent pilots are garbage-collected by communicator", "[mp
 		CHECK(mpi_communicator_testspy::get_num_active_outbound_pilots(comm) <= 1);
 	}
 }
+
+TEST_CASE("mpi_communicator coalesces pilots to the same peer into a single message", "[mpi]") {
+	mpi_communicator comm(collective_clone_from, MPI_COMM_WORLD);
+	const auto num_nodes = comm.get_num_nodes();
+	const auto self = comm.get_local_node_id();
+	CAPTURE(num_nodes, self);
+
+	if(num_nodes <= 1) { SKIP("test must be run on at least 2 ranks"); }
+
+	const bool participate = self < 2; // needs exactly 2 participating nodes
+	const node_id peer = 1 - self;
+
+	// more pilots than fit into a single message, so the last message is only partially filled
+	const size_t num_pilots = mpi_communicator::max_pilots_per_message + 3;
+
+	if(participate) {
+		std::vector<outbound_pilot> pilots;
+		for(size_t i = 0; i < num_pilots; ++i) {
+			const auto msgid = static_cast<message_id>(i);
+			const transfer_id trid(task_id(i), buffer_id(i), no_reduction_id);
+			pilots.push_back(outbound_pilot{peer, pilot_message{msgid, trid, box<3>{id{i, 0, 0}, id{i + 1, 1, 1}}}});
+		}
+		comm.send_outbound_pilots(pilots);
+		CHECK(mpi_communicator_testspy::get_num_active_outbound_pilots(comm) <= 2);
+
+		std::vector<inbound_pilot> received;
+		while(received.size() < num_pilots) {
+			for(auto& pilot : comm.poll_inbound_pilots()) {
+				received.push_back(pilot);
+			}
+		}
+		CHECK(received.size() == num_pilots);
+
+		// messages may overtake each other, but the pilots within each message are received in order
+		std::sort(received.begin(), received.end(), [](const inbound_pilot& lhs, const inbound_pilot& rhs) { return lhs.message.id < rhs.message.id; });
+		for(size_t i = 0; i < received.size(); ++i) {
+			CAPTURE(i);
+			CHECK(received[i].from == peer);
+			CHECK(received[i].message.id == static_cast<message_id>(i));
+			CHECK(received[i].message.transfer_id == transfer_id(task_id(i), buffer_id(i), no_reduction_id));
+			CHECK(received[i].message.box == box<3>(id{i, 0, 0}, id{i + 1, 1, 1}));
+		}
+	}
+
+	comm.collective_barrier();
+}
@@ -137,3 +137,28 @@ TEMPLATE_TEST_CASE_METHOD_SIG(
 	});
 	CHECK(*queue.fence(success_buffer).get() == true);
 }
+
+TEMPLATE_TEST_CASE_METHOD_SIG(bench_runtime_fixture, "benchmark command throughput with N tiny independent tasks",
+    "[benchmark][group:system][command-throughput]", ((int N), N), 1000, 10000) {
+	constexpr size_t num_tasks = N;
+
+#ifndef NDEBUG
+	if(N > 1000) { SKIP("Skipping larger-scale benchmark in debug build to save CI time"); }
+#endif
+
+	celerity::distr_queue queue;
+	celerity::buffer<int, 1> buffer(celerity::range<1>(num_tasks));
+
+	// Each task generates a single execution command per node (plus the occasional horizon) and performs no work. Dividing the number of tasks by the
+	// measured time yields the end-to-end command throughput of scheduler and executor.
+	BENCHMARK("submitting and executing tasks") {
+		for(size_t i = 0; i < num_tasks; ++i) {
+			queue.submit([&](celerity::handler& cgh) {
+				celerity::accessor acc{
+				    buffer, cgh, celerity::access::fixed<1>({celerity::id<1>(i), celerity::range<1>(1)}), celerity::write_only_host_task, celerity::no_init};
+				cgh.host_task(celerity::on_master_node, [=] { (void)acc; });
+			});
+		}
+		queue.slow_full_sync();
+	};
+}
@@ -397,6 +397,63 @@ namespace detail {
 
 	static inline region<3> make_region(size_t min, size_t max) { return box<3>({min, 0, 0}, {max, 1, 1}); }
 
+	TEST_CASE("adaptive horizon policy grows the step while execution keeps up and shrinks it when tracked structures grow",
+	    "[task_manager][task-graph][task-horizon]") {
+		adaptive_horizon_policy::limits lim;
+		lim.min_step = 2;
+		lim.max_step = 16;
+		lim.max_live_tasks = 100;
+		lim.max_region_map_entries = 1000;
+		adaptive_horizon_policy policy(4, lim);
+
+		auto d = policy.evaluate({1 /* in flight */, 10 /* tasks */, 10 /* region map entries */});
+		CHECK(d.adjustment == horizon_step_adjustment::grow);
+		CHECK(d.previous_step == 4);
+		CHECK(d.step == 8);
+		CHECK(policy.evaluate({1, 10, 10}).step == 16);
+		CHECK(policy.evaluate({1, 10, 10}).step == 16); // clamped to max_step
+
+		CHECK(policy.evaluate({5, 10, 10}).adjustment == horizon_step_adjustment::keep); // executor lags behind
+		CHECK(policy.evaluate({1, 60, 10}).adjustment == horizon_step_adjustment::keep); // too little headroom to grow
+
+		d = policy.evaluate({5, 200, 10});
+		CHECK(d.adjustment == horizon_step_adjustment::shrink);
+		CHECK(d.step == 8);
+		CHECK(policy.evaluate({1, 10, 2000}).step == 4);
+		CHECK(policy.evaluate({1, 10, 2000}).step == 2);
+		CHECK(policy.evaluate({1, 10, 2000}).step == 2); // clamped to min_step
+	}
+
+	TEST_CASE("task_manager applies and records adaptive horizon decisions", "[task_manager][task-graph][task-horizon]") {
+		auto tt = test_utils::task_test_context{};
+		tt.tm.set_horizon_step(2);
+		tt.tm.enable_adaptive_horizons();
+		auto buf = tt.mbf.create_buffer(range<1>(128), true /* mark_as_host_initialized */);
+
+		// every horizon is reached right after it has been generated, so the executor keeps up and the step grows
+		tt.tm.register_task_callback([&](const task* tsk) {
+			if(tsk->get_type() == task_type::horizon) { tt.tm.notify_horizon_reached(tsk->get_id()); }
+		});
+		for(int i = 0; i < 32; ++i) {
+			test_utils::add_host_task(tt.tm, on_master_node, [&](handler& cgh) { buf.get_access<access_mode::read_write>(cgh, all{}); });
+		}
+
+		std::vector<horizon_decision> decisions;
+		for(const auto& rec : tt.trec.get_tasks()) {
+			if(rec.type == task_type::horizon) {
+				REQUIRE(rec.horizon_decision.has_value());
+				decisions.push_back(*rec.horizon_decision);
+			}
+		}
+		REQUIRE(decisions.size() >= 2);
+		CHECK(decisions[0].previous_step == 2);
+		for(size_t i = 1; i < decisions.size(); ++i) {
+			CHECK(decisions[i].previous_step == decisions[i - 1].step);
+			CHECK(decisions[i].adjustment == horizon_step_adjustment::grow);
+		}
+		CHECK(tt.tm.get_horizon_step() > 2);
+	}
+
 	TEST_CASE("task horizons update previous writer data structure", "[task_manager][task-graph][task-horizon]") {
 		auto tt = test_utils::task_test_context{};
 
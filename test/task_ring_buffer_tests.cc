@@ -46,6 +46,8 @@ TEST_CASE_METHOD(test_utils::runtime_fixture, "deadlock in task ring buffer due
 
 	// set a high maximum so that we can actually run out of slots
 	runtime::get_instance().get_task_manager().set_horizon_max_parallelism(task_ringbuffer_size * 16);
+	// the task window grows on demand, so limit its memory to what task_ringbuffer_size tasks without range mappers occupy
+	runtime::get_instance().get_task_manager().set_task_window_memory_limit(task_ringbuffer_size * sizeof(task));
 
 	CHECK_THROWS_WITH(
 	    [&] {
@@ -59,4 +61,81 @@ TEST_CASE_METHOD(test_utils::runtime_fixture, "deadlock in task ring buffer due
 	task_manager_testspy::create_task_slot(runtime::get_instance().get_task_manager());
 }
 
+TEST_CASE("task ring buffer grows beyond a single segment and reuses segments once their tasks are deleted", "[task_ring_buffer]") {
+	task_ring_buffer trb;
+	const auto fail_on_wait = [](task_id /* tid */) { FAIL("task ring buffer must not wait below its memory limit"); };
+
+	constexpr size_t num_tasks = 3 * task_ringbuffer_size + 10;
+	for(task_id tid = 0; tid < num_tasks; ++tid) {
+		auto reserve = trb.reserve_task_entry(fail_on_wait);
+		REQUIRE(reserve.get_tid() == tid);
+		trb.put(std::move(reserve), task::make_horizon(tid));
+	}
+	CHECK(trb.get_current_task_count() == num_tasks);
+	CHECK(trb.get_allocated_segment_count() == 4);
+	CHECK(trb.get_live_task_bytes() == num_tasks * sizeof(task));
+	for(task_id tid = 0; tid < num_tasks; ++tid) {
+		REQUIRE(trb.get_task(tid)->get_id() == tid);
+	}
+
+	// the two most recently released segments are kept around for reuse, the third one is retired until its grace period is over
+	trb.delete_up_to(3 * task_ringbuffer_size);
+	CHECK(trb.get_current_task_count() == 10);
+	CHECK(trb.get_allocated_segment_count() == 4);
+	CHECK(trb.get_live_task_bytes() == 10 * sizeof(task));
+	CHECK(trb.find_task(0) == nullptr);
+	CHECK(trb.find_task(3 * task_ringbuffer_size)->get_id() == 3 * task_ringbuffer_size);
+
+	for(task_id tid = num_tasks; tid < 5 * task_ringbuffer_size + 1; ++tid) {
+		trb.put(trb.reserve_task_entry(fail_on_wait), task::make_horizon(tid));
+	}
+	CHECK(trb.get_allocated_segment_count() == 4);
+
+	// once another full segment of tasks has been deleted, no reader can observe the retired segment anymore
+	trb.delete_up_to(4 * task_ringbuffer_size + 1);
+	CHECK(trb.get_allocated_segment_count() == 3);
+
+	trb.clear();
+	CHECK(trb.get_current_task_count() == 0);
+	CHECK(trb.get_live_task_bytes() == 0);
+}
+
+TEST_CASE("task ring buffer only exposes an emplaced task once it has been published", "[task_ring_buffer]") {
+	task_ring_buffer trb;
+	const auto fail_on_wait = [](task_id /* tid */) { FAIL("task ring buffer must not wait below its memory limit"); };
+
+	trb.put(trb.reserve_task_entry(fail_on_wait), task::make_epoch(0, epoch_action::none));
+
+	auto reserve = trb.reserve_task_entry(fail_on_wait);
+	auto& horizon = trb.emplace(reserve, task::make_horizon(1));
+	CHECK_FALSE(trb.has_task(1));
+	CHECK(trb.find_task(1) == nullptr);
+	CHECK(trb.get_live_task_bytes() == sizeof(task));
+
+	// the task does not move between emplace() and publish(), so dependencies added in between remain valid
+	horizon.add_dependency({trb.get_task(0), dependency_kind::true_dep, dependency_origin::execution_front});
+	trb.publish(std::move(reserve));
+	REQUIRE(trb.has_task(1));
+	CHECK(trb.get_task(1) == &horizon);
+	CHECK(trb.get_task(1)->has_dependency(trb.get_task(0), dependency_kind::true_dep));
+	CHECK(trb.get_live_task_bytes() == 2 * sizeof(task));
+}
+
+TEST_CASE("task ring buffer only waits for task deletion once its memory limit is exceeded", "[task_ring_buffer]") {
+	task_ring_buffer trb;
+	trb.set_memory_limit(10 * sizeof(task));
+
+	size_t num_waits = 0;
+	const auto delete_five = [&](const task_id first_live_tid) {
+		++num_waits;
+		trb.delete_up_to(first_live_tid + 5);
+	};
+	for(task_id tid = 0; tid < 20; ++tid) {
+		trb.put(trb.reserve_task_entry(delete_five), task::make_horizon(tid));
+	}
+	CHECK(num_waits == 2);
+	CHECK(trb.get_current_task_count() == 10);
+	CHECK(trb.get_live_task_bytes() == 10 * sizeof(task));
+}
+
 } // namespace celerity::detail
@@ -243,7 +243,7 @@ const char* const expected_device_enumeration_warnings_regex =
 
 namespace celerity::test_utils {
 
-detail::system_info make_system_info(const size_t num_devices, const bool supports_d2d_copies) {
+detail::system_info make_system_info(const size_t num_devices, const bool supports_d2d_copies, const size_t device_memory_capacity) {
 	using namespace detail;
 	system_info info;
 	info.devices.resize(num_devices);
@@ -256,6 +256,7 @@ detail::system_info make_system_info(const size_t num_devices, const bool suppor
 		info.devices[did].native_memory = first_device_memory_id + did;
 	}
 	for(memory_id mid = first_device_memory_id; mid < info.memories.size(); ++mid) {
+		info.memories[mid].capacity = device_memory_capacity;
 		info.memories[mid].copy_peers.set(mid);
 		info.memories[mid].copy_peers.set(host_memory_id);
 		info.memories[host_memory_id].copy_peers.set(mid);
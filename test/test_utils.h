@@ -1,5 +1,6 @@
 #pragma once
 
+#include <limits>
 #include <memory>
 #include <string>
 #include <unordered_set>
@@ -62,7 +63,7 @@ namespace detail {
 	};
 
 	struct task_ring_buffer_testspy {
-		static void create_task_slot(task_ring_buffer& trb) { trb.m_number_of_deleted_tasks += 1; }
+		static void create_task_slot(task_ring_buffer& trb) { trb.m_memory_limit = std::max(trb.m_memory_limit, trb.m_live_task_bytes + 1); }
 	};
 
 	struct task_manager_testspy {
@@ -78,11 +79,16 @@ namespace detail {
 			return horizon_counter;
 		}
 
-		static const region_map<std::optional<task_id>>& get_last_writer(task_manager& tm, const buffer_id bid) { return tm.m_buffers.at(bid).last_writers; }
+		static const interval_or_region_map<std::optional<task_id>>& get_last_writer(task_manager& tm, const buffer_id bid) {
+			return tm.m_buffers.at(bid).last_writers;
+		}
 
 		static int get_max_pseudo_critical_path_length(task_manager& tm) { return tm.get_max_pseudo_critical_path_length(); }
 
-		static auto get_execution_front(task_manager& tm) { return tm.get_execution_front(); }
+		static std::unordered_set<task*> get_execution_front(task_manager& tm) {
+			const auto& front = tm.get_execution_front();
+			return {front.begin(), front.end()};
+		}
 
 		static void create_task_slot(task_manager& tm) { task_ring_buffer_testspy::create_task_slot(tm.m_task_buffer); }
 	};
@@ -331,7 +337,8 @@ namespace test_utils {
 		detail::add_reduction(cgh, mrf.create_reduction(vars.get_id(), include_current_buffer_value));
 	}
 
-	detail::system_info make_system_info(const size_t num_devices, const bool supports_d2d_copies);
+	detail::system_info make_system_info(
+	    const size_t num_devices, const bool supports_d2d_copies, const size_t device_memory_capacity = std::numeric_limits<size_t>::max());
 
 	// This fixture (or a subclass) must be used by all tests that transitively use MPI.
 	class mpi_fixture {
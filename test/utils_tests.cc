@@ -1,7 +1,20 @@
 #include <celerity.h>
 
+#include <bitset>
+#include <cstring>
+#include <numeric>
+#include <thread>
+#include <vector>
+
 #include <catch2/catch_test_macros.hpp>
 
+#include "arena.h"
+#include "command_ring.h"
+#include "host_queue.h"
+#include "mpsc_queue.h"
+#include "staging_pool.h"
+#include "work_stealing_pool.h"
+
 using namespace celerity;
 using namespace celerity::detail;
 
@@ -49,3 +62,303 @@ TEST_CASE("name strings are correctly extracted from types", "[utils][get_simpli
 TEST_CASE("escaping of invalid characters for dot labels", "[utils][escape_for_dot_label]") {
 	CHECK(utils::escape_for_dot_label("hello<bla&>") == "hello&lt;bla&amp;&gt;");
 }
+
+
+TEST_CASE("for_each_set_bit visits set bits across word boundaries in ascending order", "[utils][for_each_set_bit]") {
+	std::bitset<256> bits;
+	const std::vector<size_t> set_bits{0, 1, 63, 64, 127, 200, 255};
+	for(const auto b : set_bits) {
+		bits.set(b);
+	}
+	std::vector<size_t> visited;
+	utils::for_each_set_bit(bits, [&](const size_t b) { visited.push_back(b); });
+	CHECK(visited == set_bits);
+
+	visited.clear();
+	utils::for_each_set_bit(std::bitset<256>{}, [&](const size_t b) { visited.push_back(b); });
+	CHECK(visited.empty());
+
+	visited.clear();
+	utils::for_each_set_bit(std::bitset<10>("1000000101"), [&](const size_t b) { visited.push_back(b); });
+	CHECK(visited == std::vector<size_t>{0, 2, 9});
+}
+
+TEST_CASE("mpsc_queue delivers elements from concurrent producers in per-producer FIFO order", "[utils][mpsc_queue]") {
+	constexpr size_t num_producers = 4;
+	constexpr size_t num_items_per_producer = 10000;
+
+	// A small capacity forces producers to wait on a full ring and the consumer to park on an empty one
+	mpsc_queue<std::pair<size_t, size_t>> queue(8);
+	CHECK(queue.capacity() == 8);
+	CHECK(queue.empty());
+
+	std::vector<std::thread> producers;
+	for(size_t p = 0; p < num_producers; ++p) {
+		producers.emplace_back([&, p] {
+			for(size_t i = 0; i < num_items_per_producer; ++i) {
+				queue.emplace(p, i);
+			}
+		});
+	}
+
+	std::vector<size_t> next_expected(num_producers, 0);
+	for(size_t n = 0; n < num_producers * num_items_per_producer; ++n) {
+		const auto [p, i] = queue.pop();
+		REQUIRE(p < num_producers);
+		REQUIRE(i == next_expected[p]);
+		++next_expected[p];
+	}
+
+	for(auto& thread : producers) {
+		thread.join();
+	}
+	CHECK(queue.empty());
+	CHECK(!queue.try_pop().has_value());
+}
+
+TEST_CASE("mpsc_queue::try_push does not block on a full queue", "[utils][mpsc_queue]") {
+	mpsc_queue<int> queue(4);
+	for(int i = 0; i < 4; ++i) {
+		CHECK(queue.try_push(i));
+	}
+	CHECK_FALSE(queue.try_push(4));
+
+	CHECK(queue.try_pop() == 0);
+	CHECK(queue.try_push(4));
+	for(int i = 1; i <= 4; ++i) {
+		CHECK(queue.try_pop() == i);
+	}
+	CHECK(queue.empty());
+}
+
+TEST_CASE("command_ring round-trips commands in FIFO order and spills large fan-in and regions into slot storage", "[utils][command_ring]") {
+	constexpr size_t num_commands = 10000;
+
+	const auto make_pkg = [](const command_id cid) {
+		command_pkg pkg;
+		pkg.cid = cid;
+		switch(cid % 3) {
+		case 0: pkg.data = execution_data{task_id(cid), subrange<3>({cid, 0, 0}, {1, 2, 3}), cid % 2 == 0}; break;
+		case 1: pkg.data = push_data{node_id(cid % 7), transfer_id(task_id(cid), buffer_id(1)), subrange<3>({0, cid, 0}, {4, 5, 6})}; break;
+		case 2: {
+			const region<3> received({box<3>({0, 0, 0}, {cid, 1, 1}), box<3>({cid + 1, 0, 0}, {cid + 3, 1, 1})});
+			pkg.data = await_push_data{transfer_id(task_id(cid), buffer_id(2)), received};
+			break;
+		}
+		}
+		// cover both inline and spilled dependency lists
+		for(command_id dep = 0; dep < cid % (2 * encoded_command::max_inline_dependencies); ++dep) {
+			pkg.dependencies.push_back(cid - dep - 1);
+		}
+		return pkg;
+	};
+
+	// A small capacity forces the producer to wait on a full ring and slots (and their storage) to be reused many times
+	command_ring ring(8);
+	CHECK(ring.capacity() == 8);
+	CHECK(ring.empty());
+	CHECK(ring.peek() == nullptr);
+
+	std::thread producer([&] {
+		for(command_id cid = 1; cid <= num_commands; ++cid) {
+			ring.push(make_pkg(cid));
+		}
+	});
+
+	for(command_id cid = 1; cid <= num_commands; ++cid) {
+		const encoded_command* cmd;
+		while((cmd = ring.peek()) == nullptr) {}
+		const auto expected = make_pkg(cid);
+		REQUIRE(cmd->cid == cid);
+		REQUIRE(cmd->type == expected.get_command_type());
+		REQUIRE(cmd->get_tid() == expected.get_tid());
+		REQUIRE(std::vector<command_id>(cmd->dependencies_begin(), cmd->dependencies_end()) == expected.dependencies);
+
+		const auto decoded = cmd->decode();
+		CHECK(decoded.cid == cid);
+		CHECK(decoded.dependencies.empty());
+		if(const auto* const exec = std::get_if<execution_data>(&expected.data)) {
+			const auto& d = std::get<execution_data>(decoded.data);
+			CHECK(d.tid == exec->tid);
+			CHECK(d.sr == exec->sr);
+			CHECK(d.initialize_reductions == exec->initialize_reductions);
+		} else if(const auto* const push = std::get_if<push_data>(&expected.data)) {
+			const auto& d = std::get<push_data>(decoded.data);
+			CHECK(d.target == push->target);
+			CHECK(d.trid == push->trid);
+			CHECK(d.sr == push->sr);
+		} else {
+			const auto& await_push = std::get<await_push_data>(expected.data);
+			const auto& d = std::get<await_push_data>(decoded.data);
+			CHECK(d.trid == await_push.trid);
+			CHECK(d.region == await_push.region);
+		}
+		ring.pop();
+	}
+
+	producer.join();
+	CHECK(ring.empty());
+}
+
+TEST_CASE("arena hands out aligned, non-overlapping allocations and supports oversized requests", "[utils][arena]") {
+	arena a(256);
+	CHECK(a.get_block_count() == 0);
+
+	std::vector<std::pair<std::byte*, size_t>> allocations;
+	for(const auto [size, alignment] : {std::pair<size_t, size_t>{1, 1}, {8, 8}, {3, 1}, {16, 16}, {100, 64}, {200, 8}, {1000, 32}, {4, 4}}) {
+		const auto ptr = static_cast<std::byte*>(a.allocate(size, alignment));
+		REQUIRE(ptr != nullptr);
+		CHECK(reinterpret_cast<uintptr_t>(ptr) % alignment == 0);
+		std::memset(ptr, 0xff, size); // would be caught by sanitizers if out of bounds
+		allocations.emplace_back(ptr, size);
+	}
+	for(size_t i = 0; i < allocations.size(); ++i) {
+		for(size_t j = i + 1; j < allocations.size(); ++j) {
+			const auto [pi, si] = allocations[i];
+			const auto [pj, sj] = allocations[j];
+			CHECK((pi + si <= pj || pj + sj <= pi));
+		}
+	}
+	CHECK(a.get_allocated_bytes() == 1 + 8 + 3 + 16 + 100 + 200 + 1000 + 4);
+	CHECK(a.get_block_count() >= 3); // the 1000-byte allocation requires a dedicated block
+
+	// objects are destroyed through arena_destroyer and their memory is released along with the arena
+	auto counter = std::make_shared<int>(0);
+	{
+		std::unique_ptr<std::shared_ptr<int>, arena_destroyer> obj(a.create<std::shared_ptr<int>>(counter));
+		CHECK(counter.use_count() == 2);
+	}
+	CHECK(counter.use_count() == 1);
+}
+
+TEST_CASE("arena keeps its current block across reset and make_unique_in falls back to the heap without an arena", "[utils][arena]") {
+	arena a(256);
+	const auto first = a.allocate(64, 8);
+	(void)a.allocate(1000, 8); // dedicated block, released on reset
+	CHECK(a.get_block_count() == 2);
+
+	a.reset();
+	CHECK(a.get_block_count() == 1);
+	CHECK(a.get_allocated_bytes() == 0);
+	CHECK(a.allocate(64, 8) == first);
+
+	auto counter = std::make_shared<int>(0);
+	{
+		auto in_arena = make_unique_in<std::shared_ptr<int>>(&a, counter);
+		auto on_heap = make_unique_in<std::shared_ptr<int>>(nullptr, counter);
+		CHECK(in_arena.get_deleter().in_arena);
+		CHECK(!on_heap.get_deleter().in_arena);
+		CHECK(counter.use_count() == 3);
+	}
+	CHECK(counter.use_count() == 1);
+	CHECK(a.get_block_count() == 1);
+}
+
+TEST_CASE("staging_pool recycles released buffers by size class and bounds the memory it retains", "[utils][staging_pool]") {
+	std::vector<void*> live;
+	size_t num_freed = 0;
+	{
+		staging_pool pool(
+		    [&](const size_t size, const size_t alignment) {
+			    CHECK(size % staging_pool::min_buffer_size == 0);
+			    CHECK(alignment == staging_pool::buffer_alignment);
+			    return live.emplace_back(::operator new(size, std::align_val_t(alignment)));
+		    },
+		    [&](void* const ptr) {
+			    ::operator delete(ptr, std::align_val_t(staging_pool::buffer_alignment));
+			    ++num_freed;
+		    },
+		    2 * staging_pool::min_buffer_size /* max retained bytes */);
+
+		CHECK(staging_pool::get_size_class(1) == staging_pool::min_buffer_size);
+		CHECK(staging_pool::get_size_class(staging_pool::min_buffer_size + 1) == 2 * staging_pool::min_buffer_size);
+
+		const auto small = pool.acquire(100);
+		std::memset(small, 0xff, 100);
+		CHECK(pool.is_acquired(small));
+		pool.release(small);
+		CHECK(!pool.is_acquired(small));
+		CHECK(pool.get_retained_bytes() == staging_pool::min_buffer_size);
+
+		// a request of a similar size re-uses the released buffer
+		CHECK(pool.acquire(staging_pool::min_buffer_size) == small);
+		CHECK(pool.get_num_allocations() == 1);
+		CHECK(pool.get_retained_bytes() == 0);
+
+		// buffers that would exceed the retention limit are freed immediately
+		const auto large = pool.acquire(2 * staging_pool::min_buffer_size);
+		CHECK(pool.get_num_allocations() == 2);
+		pool.release(small);
+		pool.release(large);
+		CHECK(num_freed == 1);
+		CHECK(pool.get_retained_bytes() == staging_pool::min_buffer_size);
+	}
+	// retained buffers are freed along with the pool
+	CHECK(num_freed == live.size());
+}
+
+TEST_CASE("work_stealing_pool executes jobs queued behind a blocked worker by stealing them", "[utils][work_stealing_pool]") {
+	constexpr size_t num_jobs = 64;
+
+	work_stealing_pool pool(2, "cy-test");
+	CHECK(pool.get_num_workers() == 2);
+
+	std::mutex mutex;
+	std::condition_variable cv;
+	size_t num_completed = 0;
+	bool all_completed_while_blocked = false;
+
+	// Jobs are distributed round-robin, so the first job blocks worker 0 while half of the remaining jobs are queued behind it
+	pool.submit(work_stealing_pool::job([&] {
+		std::unique_lock lock(mutex);
+		all_completed_while_blocked = cv.wait_for(lock, std::chrono::seconds(10), [&] { return num_completed == num_jobs; });
+	}));
+	for(size_t i = 0; i < num_jobs; ++i) {
+		pool.submit(work_stealing_pool::job([&] {
+			{
+				std::lock_guard lock(mutex);
+				++num_completed;
+			}
+			cv.notify_all();
+		}));
+	}
+
+	pool.stop();
+	CHECK(all_completed_while_blocked);
+	CHECK(num_completed == num_jobs);
+}
+
+TEST_CASE("host_queue splits the cores of a host between the processes running on it", "[utils][host_queue]") {
+	const auto cores = [](const uint32_t first, const uint32_t last) {
+		std::vector<uint32_t> ids(last - first);
+		std::iota(ids.begin(), ids.end(), first);
+		return ids;
+	};
+
+	SECTION("a single process reserves its lowest cores for the runtime threads") {
+		const auto assignment = host_queue::assign_cores(cores(0, 8), 8 /* host cores */, 1 /* local ranks */, 0 /* local rank */);
+		CHECK(assignment.runtime_cores == cores(0, 3));
+		CHECK(assignment.worker_cores == cores(3, 8));
+	}
+
+	SECTION("processes with an unrestricted affinity mask each take an even share of the host") {
+		const auto rank_0 = host_queue::assign_cores(cores(0, 16), 16, 2, 0);
+		CHECK(rank_0.runtime_cores == cores(0, 3));
+		CHECK(rank_0.worker_cores == cores(3, 8));
+		const auto rank_1 = host_queue::assign_cores(cores(0, 16), 16, 2, 1);
+		CHECK(rank_1.runtime_cores == cores(8, 11));
+		CHECK(rank_1.worker_cores == cores(11, 16));
+	}
+
+	SECTION("processes whose affinity mask was already restricted use all of their cores") {
+		const auto assignment = host_queue::assign_cores(cores(8, 16), 16, 2, 1);
+		CHECK(assignment.runtime_cores == cores(8, 11));
+		CHECK(assignment.worker_cores == cores(11, 16));
+	}
+
+	SECTION("threads are not pinned if a share is too small") {
+		const auto assignment = host_queue::assign_cores(cores(0, 8), 8, 2, 1);
+		CHECK(assignment.runtime_cores.empty());
+		CHECK(assignment.worker_cores.empty());
+	}
+}